@@ -0,0 +1,47 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace Daisy::Bench {
+
+// Keeps the optimizer from discarding a computed value
+template<typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(_MSC_VER)
+    static volatile const void* sink;
+    sink = &value;
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+// Best-of-N nanoseconds per iteration; fn(iterations) runs the measured loop
+template<typename Fn>
+double Measure(size_t iterations, Fn&& fn, int repetitions = 5) {
+    fn(std::max<size_t>(1, iterations / 10));
+    
+    double best = 1e300;
+    for (int i = 0; i < repetitions; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        fn(iterations);
+        auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+        best = std::min(best, elapsed.count() / static_cast<double>(iterations));
+    }
+    return best;
+}
+
+inline void Report(const char* name, double nanosecondsPerOp, double baselineNanoseconds = 0.0) {
+    if (baselineNanoseconds > 0.0) {
+        std::printf("  %-44s %10.3f ns/op  %6.2fx\n", name, nanosecondsPerOp, baselineNanoseconds / nanosecondsPerOp);
+    } else {
+        std::printf("  %-44s %10.3f ns/op\n", name, nanosecondsPerOp);
+    }
+}
+
+inline void Section(const char* title) {
+    std::printf("\n%s\n", title);
+}
+
+}
\ No newline at end of file
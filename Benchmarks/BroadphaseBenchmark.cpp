@@ -0,0 +1,127 @@
+#include "Benchmark.h"
+#include "Broadphase.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Daisy;
+using namespace Daisy::Bench;
+
+namespace {
+
+// Unit-radius bodies at a fixed density, so the number of real contacts per
+// body stays the same at every scale, plus a few large static blocks. Bodies
+// sit 1e6 m from the origin to keep the double-precision path honest.
+struct Scene {
+    std::vector<DVector3> positions;
+    std::vector<Aabb> staticBlocks;
+    std::mt19937 rng{42};
+    double size = 0.0;
+    
+    explicit Scene(size_t count) {
+        const DVector3 offset(1e6, 0.0, -1e6);
+        // About 1.3 overlapping neighbours per body
+        size = std::cbrt(static_cast<double>(count) * 48.0);
+        std::uniform_real_distribution<double> coordinate(0.0, size);
+        for (size_t i = 0; i < count; ++i) {
+            positions.push_back(offset + DVector3(coordinate(rng), coordinate(rng), coordinate(rng)));
+        }
+        for (size_t i = 0; i < std::max<size_t>(1, count / 1000); ++i) {
+            DVector3 corner = offset + DVector3(coordinate(rng), coordinate(rng), coordinate(rng));
+            staticBlocks.push_back(Aabb{corner, corner + DVector3(80.0, 4.0, 80.0)});
+        }
+    }
+    
+    void Populate(Broadphase& broadphase, std::vector<Broadphase::ProxyId>& proxies) const {
+        proxies.clear();
+        for (size_t i = 0; i < positions.size(); ++i) {
+            proxies.push_back(broadphase.AddProxy(Aabb::FromCenter(positions[i], 1.0), i, false));
+        }
+        for (size_t i = 0; i < staticBlocks.size(); ++i) {
+            broadphase.AddProxy(staticBlocks[i], positions.size() + i, true);
+        }
+    }
+    
+    // A step's worth of motion: a few centimetres per body
+    void Move(Broadphase& broadphase, const std::vector<Broadphase::ProxyId>& proxies) {
+        std::uniform_real_distribution<double> step(-0.05, 0.05);
+        for (size_t i = 0; i < positions.size(); ++i) {
+            positions[i] = positions[i] + DVector3(step(rng), step(rng), step(rng));
+            broadphase.UpdateProxy(proxies[i], Aabb::FromCenter(positions[i], 1.0), false);
+        }
+    }
+    
+    // The loop CheckCollisions used to run
+    size_t CountPairsBruteForce() const {
+        size_t pairs = 0;
+        for (size_t i = 0; i < positions.size(); ++i) {
+            Aabb a = Aabb::FromCenter(positions[i], 1.0);
+            for (size_t j = i + 1; j < positions.size(); ++j) {
+                pairs += a.Overlaps(Aabb::FromCenter(positions[j], 1.0));
+            }
+            for (const Aabb& block : staticBlocks) {
+                pairs += a.Overlaps(block);
+            }
+        }
+        return pairs;
+    }
+};
+
+}
+
+int main() {
+    std::printf("Broadphase, unit spheres at constant density plus 0.1%% large static blocks\n");
+    
+    for (size_t count : {1'000, 10'000, 100'000}) {
+        Scene scene(count);
+        Broadphase broadphase;
+        std::vector<Broadphase::ProxyId> proxies;
+        std::pmr::vector<BroadphasePair> pairs;
+        scene.Populate(broadphase, proxies);
+        broadphase.FindPairs(pairs);
+        
+        char title[128];
+        std::snprintf(title, sizeof(title), "%zu bodies, %zu candidate pairs, tree height %d", count, pairs.size(),
+                      broadphase.GetTree().GetHeight());
+        Section(title);
+        
+        // Per body per step, so flat numbers mean linear scaling
+        double bruteForce = 0.0;
+        if (count <= 10'000) {
+            size_t expected = scene.CountPairsBruteForce();
+            if (expected != pairs.size()) {
+                std::printf("  MISMATCH: brute force found %zu pairs\n", expected);
+                return 1;
+            }
+            bruteForce = Measure(count, [&](size_t n) {
+                for (size_t done = 0; done < n; done += count) {
+                    DoNotOptimize(scene.CountPairsBruteForce());
+                }
+            }, 3);
+            Report("O(n^2) pair loop, per body", bruteForce);
+        } else {
+            std::printf("  %-44s %10s\n", "O(n^2) pair loop, per body", "skipped");
+        }
+        
+        double rebuild = Measure(count, [&](size_t n) {
+            for (size_t done = 0; done < n; done += count) {
+                Broadphase fresh;
+                std::vector<Broadphase::ProxyId> freshProxies;
+                scene.Populate(fresh, freshProxies);
+                fresh.FindPairs(pairs);
+            }
+        }, 3);
+        Report("build from scratch + FindPairs, per body", rebuild, bruteForce);
+        
+        double step = Measure(count, [&](size_t n) {
+            for (size_t done = 0; done < n; done += count) {
+                scene.Move(broadphase, proxies);
+                broadphase.FindPairs(pairs);
+            }
+        });
+        Report("move + incremental FindPairs, per body", step, bruteForce);
+        std::printf("  %-44s %10.3f ms\n", "step", step * static_cast<double>(count) * 1e-6);
+    }
+    
+    return 0;
+}
\ No newline at end of file
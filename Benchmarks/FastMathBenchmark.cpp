@@ -0,0 +1,249 @@
+#include "Benchmark.h"
+#include "Core/FastMath.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Daisy;
+using namespace Daisy::Bench;
+using FastMath::Accuracy;
+
+namespace {
+
+// Worst errors against the double-precision reference, to check the bounds
+// documented on FastMath::Accuracy
+struct ErrorStats {
+    double maxAbsolute = 0.0;
+    double maxRelative = 0.0;
+    
+    void Add(double value, double reference) {
+        double absolute = std::fabs(value - reference);
+        maxAbsolute = std::max(maxAbsolute, absolute);
+        if (reference != 0.0) {
+            maxRelative = std::max(maxRelative, absolute / std::fabs(reference));
+        }
+    }
+};
+
+// A bound of 0 is not checked. Returns false when a bound is exceeded.
+bool ReportError(const char* name, const ErrorStats& stats, double absoluteBound = 0.0, double relativeBound = 0.0) {
+    std::printf("  %-44s max abs %.3g, max rel %.3g\n", name, stats.maxAbsolute, stats.maxRelative);
+    bool withinBounds = true;
+    if (absoluteBound > 0.0 && stats.maxAbsolute >= absoluteBound) {
+        std::printf("  EXCEEDED: documented absolute error bound is %.3g\n", absoluteBound);
+        withinBounds = false;
+    }
+    if (relativeBound > 0.0 && stats.maxRelative >= relativeBound) {
+        std::printf("  EXCEEDED: documented relative error bound is %.3g\n", relativeBound);
+        withinBounds = false;
+    }
+    return withinBounds;
+}
+
+template<Accuracy A>
+ErrorStats MeasureInverseSqrtError(const std::vector<float>& values) {
+    ErrorStats stats;
+    std::vector<float> batch(values.size());
+    FastMath::InverseSqrt<A>(values.data(), batch.data(), values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        double reference = 1.0 / std::sqrt(static_cast<double>(values[i]));
+        stats.Add(FastMath::InverseSqrt<A>(values[i]), reference);
+        stats.Add(batch[i], reference);
+    }
+    return stats;
+}
+
+template<Accuracy A>
+ErrorStats MeasureSinCosError(const std::vector<float>& angles) {
+    ErrorStats stats;
+    std::vector<float> sin(angles.size()), cos(angles.size());
+    FastMath::SinCos<A>(angles.data(), sin.data(), cos.data(), angles.size());
+    for (size_t i = 0; i < angles.size(); ++i) {
+        double angle = angles[i];
+        float s, c;
+        FastMath::SinCos<A>(angles[i], s, c);
+        stats.Add(s, std::sin(angle));
+        stats.Add(c, std::cos(angle));
+        stats.Add(sin[i], std::sin(angle));
+        stats.Add(cos[i], std::cos(angle));
+    }
+    // Relative error is meaningless near the zeros of sin and cos
+    stats.maxRelative = 0.0;
+    return stats;
+}
+
+}
+
+int main() {
+    constexpr size_t count = 4096;
+    constexpr size_t iterations = 8'000'000;
+    
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> magnitude(-20.0f, 20.0f);
+    std::uniform_real_distribution<float> component(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> angle(-FastMath::SinCosRangeLimit, FastMath::SinCosRangeLimit);
+    std::uniform_real_distribution<float> smallAngle(-2.0f * PI, 2.0f * PI);
+    
+    // Accuracy over a wide sample, including exact powers of two and the range ends
+    std::vector<float> positives, angles;
+    for (size_t i = 0; i < 1'000'000; ++i) {
+        positives.push_back(std::exp2(magnitude(rng)));
+        angles.push_back(i % 2 ? angle(rng) : smallAngle(rng));
+    }
+    for (int exponent = -20; exponent <= 20; ++exponent) {
+        positives.push_back(std::exp2(static_cast<float>(exponent)));
+    }
+    angles.push_back(FastMath::SinCosRangeLimit);
+    angles.push_back(-FastMath::SinCosRangeLimit);
+    
+    std::printf("Fast math, %s build\n", Simd::GetInstructionSet());
+    
+    // The bounds documented on FastMath::Accuracy
+#if defined(DAISY_SIMD_SSE41)
+    constexpr double approximateInverseSqrtBound = 4e-4;
+#else
+    constexpr double approximateInverseSqrtBound = 2e-3;
+#endif
+
+    Section("Accuracy against double precision");
+    bool withinBounds = true;
+    withinBounds &= ReportError("InverseSqrt<Exact>", MeasureInverseSqrtError<Accuracy::Exact>(positives));
+    withinBounds &= ReportError("InverseSqrt<Fast>", MeasureInverseSqrtError<Accuracy::Fast>(positives), 0.0, 3e-7);
+    withinBounds &= ReportError("InverseSqrt<Approximate>", MeasureInverseSqrtError<Accuracy::Approximate>(positives),
+                                0.0, approximateInverseSqrtBound);
+    withinBounds &= ReportError("SinCos<Exact>", MeasureSinCosError<Accuracy::Exact>(angles));
+    withinBounds &= ReportError("SinCos<Fast>", MeasureSinCosError<Accuracy::Fast>(angles), 1e-7);
+    withinBounds &= ReportError("SinCos<Approximate>", MeasureSinCosError<Accuracy::Approximate>(angles), 4e-4);
+    if (!withinBounds) {
+        return 1;
+    }
+    
+    std::vector<Vector3> vectors(count), normalized(count);
+    std::vector<float> values(count), results(count), sines(count), cosines(count);
+    for (size_t i = 0; i < count; ++i) {
+        vectors[i] = Vector3(component(rng), component(rng), component(rng));
+        values[i] = std::exp2(magnitude(rng));
+        angles[i] = smallAngle(rng);
+    }
+    
+    Section("1 / sqrt(x), one value per call");
+    double exactInverse = Measure(iterations, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            size_t j = i % count;
+            results[j] = 1.0f / std::sqrt(values[j]);
+        }
+        DoNotOptimize(results[0]);
+    });
+    Report("1.0f / std::sqrt", exactInverse);
+    double fastInverse = Measure(iterations, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            size_t j = i % count;
+            results[j] = FastMath::InverseSqrt<Accuracy::Fast>(values[j]);
+        }
+        DoNotOptimize(results[0]);
+    });
+    Report("InverseSqrt<Fast>", fastInverse, exactInverse);
+    double approximateInverse = Measure(iterations, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            size_t j = i % count;
+            results[j] = FastMath::InverseSqrt<Accuracy::Approximate>(values[j]);
+        }
+        DoNotOptimize(results[0]);
+    });
+    Report("InverseSqrt<Approximate>", approximateInverse, exactInverse);
+    double batchInverse = Measure(iterations, [&](size_t n) {
+        for (size_t i = 0; i < n; i += count) {
+            FastMath::InverseSqrt<Accuracy::Fast>(values.data(), results.data(), std::min(count, n - i));
+        }
+        DoNotOptimize(results[0]);
+    });
+    Report("InverseSqrt<Fast> batch", batchInverse, exactInverse);
+    
+    Section("Vector3 normalize");
+    double exactNormalize = Measure(iterations, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            size_t j = i % count;
+            normalized[j] = vectors[j].Normalized();
+        }
+        DoNotOptimize(normalized[0]);
+    });
+    Report("Vector3::Normalized", exactNormalize);
+    double fastNormalize = Measure(iterations, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            size_t j = i % count;
+            normalized[j] = FastMath::Normalize<Accuracy::Fast>(vectors[j]);
+        }
+        DoNotOptimize(normalized[0]);
+    });
+    Report("Normalize<Fast>", fastNormalize, exactNormalize);
+    Vector3Array streams;
+    for (const Vector3& vector : vectors) {
+        streams.PushBack(vector);
+    }
+    double batchNormalize = Measure(iterations, [&](size_t n) {
+        for (size_t i = 0; i < n; i += count) {
+            FastMath::Normalize<Accuracy::Fast>(streams.GetStream(), std::min(count, n - i));
+        }
+        DoNotOptimize(streams.Get(0));
+    });
+    Report("Normalize<Fast> batch (Vector3Array)", batchNormalize, exactNormalize);
+    
+    Section("sin and cos of the same angle");
+    double exactSinCos = Measure(iterations, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            size_t j = i % count;
+            sines[j] = std::sin(angles[j]);
+            cosines[j] = std::cos(angles[j]);
+        }
+        DoNotOptimize(sines[0]);
+        DoNotOptimize(cosines[0]);
+    });
+    Report("std::sin + std::cos", exactSinCos);
+    double fastSinCos = Measure(iterations, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            size_t j = i % count;
+            FastMath::SinCos<Accuracy::Fast>(angles[j], sines[j], cosines[j]);
+        }
+        DoNotOptimize(sines[0]);
+        DoNotOptimize(cosines[0]);
+    });
+    Report("SinCos<Fast>", fastSinCos, exactSinCos);
+    double approximateSinCos = Measure(iterations, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            size_t j = i % count;
+            FastMath::SinCos<Accuracy::Approximate>(angles[j], sines[j], cosines[j]);
+        }
+        DoNotOptimize(sines[0]);
+        DoNotOptimize(cosines[0]);
+    });
+    Report("SinCos<Approximate>", approximateSinCos, exactSinCos);
+    double batchSinCos = Measure(iterations, [&](size_t n) {
+        for (size_t i = 0; i < n; i += count) {
+            FastMath::SinCos<Accuracy::Fast>(angles.data(), sines.data(), cosines.data(), std::min(count, n - i));
+        }
+        DoNotOptimize(sines[0]);
+        DoNotOptimize(cosines[0]);
+    });
+    Report("SinCos<Fast> batch", batchSinCos, exactSinCos);
+    
+    Section("Quaternion::FromAxisAngle");
+    std::vector<Quaternion> rotations(count);
+    double exactAxisAngle = Measure(iterations, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            size_t j = i % count;
+            rotations[j] = Quaternion::FromAxisAngle(vectors[j], angles[j]);
+        }
+        DoNotOptimize(rotations[0]);
+    });
+    Report("Quaternion::FromAxisAngle", exactAxisAngle);
+    double fastAxisAngle = Measure(iterations, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            size_t j = i % count;
+            rotations[j] = FastMath::FromAxisAngle<Accuracy::Fast>(vectors[j], angles[j]);
+        }
+        DoNotOptimize(rotations[0]);
+    });
+    Report("FromAxisAngle<Fast>", fastAxisAngle, exactAxisAngle);
+    
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include "Benchmark.h"
+#include "GravityTree.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Daisy;
+using namespace Daisy::Bench;
+
+namespace {
+
+// A star system seen from 1e12 m off the origin: one star, wells in a thin
+// disk whose spheres of influence overlap, and bodies scattered through the
+// same disk. A third of the wells are planets with a softened core.
+struct StarSystem {
+    std::vector<GravityWell> wells;
+    std::vector<DVector3> bodies;
+    std::vector<float> masses;
+    
+    StarSystem(size_t wellCount, size_t bodyCount) {
+        std::mt19937 rng(42);
+        const DVector3 offset(1e12, 0.0, -1e12);
+        const double diskRadius = 1e11;
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        std::uniform_real_distribution<double> thickness(-1e9, 1e9);
+        auto inDisk = [&]() {
+            double radius = diskRadius * std::sqrt(unit(rng));
+            double angle = unit(rng) * 2.0 * PI;
+            return offset + DVector3(radius * std::cos(angle), thickness(rng), radius * std::sin(angle));
+        };
+        
+        wells.push_back(GravityWell{offset, 2e30f, 1e13f, false, true});
+        for (size_t i = 1; i < wellCount; ++i) {
+            bool isPlanet = i % 3 == 0;
+            float mass = static_cast<float>(std::pow(10.0, 20.0 + 7.0 * unit(rng)));
+            wells.push_back(GravityWell{inDisk(), mass, isPlanet ? 2e10f : 1e12f, isPlanet, false});
+        }
+        for (size_t i = 0; i < bodyCount; ++i) {
+            bodies.push_back(inDisk());
+            masses.push_back(static_cast<float>(1e3 + 1e5 * unit(rng)));
+        }
+    }
+    
+    void ComputeExact(std::vector<Vector3>& forces) const {
+        for (size_t i = 0; i < bodies.size(); ++i) {
+            Vector3 force(0, 0, 0);
+            for (const GravityWell& well : wells) {
+                force = force + ComputeWellForce(well, bodies[i], masses[i]);
+            }
+            forces[i] = force;
+        }
+    }
+    
+    void ComputeTree(const GravityTree& tree, float openingAngle, std::vector<Vector3>& forces) const {
+        for (size_t i = 0; i < bodies.size(); ++i) {
+            forces[i] = tree.ComputeForce(bodies[i], masses[i], openingAngle);
+        }
+    }
+};
+
+// Force error relative to the exact sum, worst and root mean square
+void ReportError(const std::vector<Vector3>& forces, const std::vector<Vector3>& exact) {
+    double worst = 0.0, sumSquares = 0.0;
+    for (size_t i = 0; i < forces.size(); ++i) {
+        double reference = exact[i].Length();
+        double error = reference > 0.0 ? (forces[i] - exact[i]).Length() / reference : 0.0;
+        worst = std::max(worst, error);
+        sumSquares += error * error;
+    }
+    std::printf("  %-44s max rel %.3g, rms rel %.3g\n", "", worst, std::sqrt(sumSquares / forces.size()));
+}
+
+}
+
+int main() {
+    constexpr size_t bodyCount = 20'000;
+    std::vector<Vector3> exact(bodyCount), forces(bodyCount);
+    
+    std::printf("Gravity wells, %zu bodies, exact sum against Barnes-Hut\n", bodyCount);
+    
+    // Where the tree starts to pay for its traversal
+    Section("Crossover, opening angle 0.5, per body");
+    for (size_t wellCount : {16, 64, 128, 256, 512}) {
+        StarSystem system(wellCount, bodyCount);
+        GravityTree tree;
+        tree.Build(system.wells);
+        double exactTime = Measure(bodyCount, [&](size_t n) {
+            for (size_t done = 0; done < n; done += bodyCount) {
+                system.ComputeExact(exact);
+            }
+            DoNotOptimize(exact[0]);
+        }, 3);
+        double treeTime = Measure(bodyCount, [&](size_t n) {
+            for (size_t done = 0; done < n; done += bodyCount) {
+                system.ComputeTree(tree, 0.5f, forces);
+            }
+            DoNotOptimize(forces[0]);
+        }, 3);
+        char name[64];
+        std::snprintf(name, sizeof(name), "%zu wells, exact", wellCount);
+        Report(name, exactTime);
+        std::snprintf(name, sizeof(name), "%zu wells, Barnes-Hut", wellCount);
+        Report(name, treeTime, exactTime);
+    }
+    
+    for (size_t wellCount : {1'000, 4'000}) {
+        StarSystem system(wellCount, bodyCount);
+        GravityTree tree;
+        tree.Build(system.wells);
+        
+        char title[96];
+        std::snprintf(title, sizeof(title), "%zu wells, %zu tree nodes, per body", wellCount, tree.GetNodeCount());
+        Section(title);
+        double exactTime = Measure(bodyCount, [&](size_t n) {
+            for (size_t done = 0; done < n; done += bodyCount) {
+                system.ComputeExact(exact);
+            }
+            DoNotOptimize(exact[0]);
+        }, 3);
+        Report("exact", exactTime);
+        
+        double buildTime = Measure(wellCount, [&](size_t n) {
+            for (size_t done = 0; done < n; done += wellCount) {
+                tree.Build(system.wells);
+            }
+        }, 3);
+        std::printf("  %-44s %10.3f ms\n", "tree build", buildTime * static_cast<double>(wellCount) * 1e-6);
+        
+        for (float openingAngle : {0.25f, 0.5f, 0.75f, 1.0f}) {
+            double treeTime = Measure(bodyCount, [&](size_t n) {
+                for (size_t done = 0; done < n; done += bodyCount) {
+                    system.ComputeTree(tree, openingAngle, forces);
+                }
+                DoNotOptimize(forces[0]);
+            }, 3);
+            char name[64];
+            std::snprintf(name, sizeof(name), "Barnes-Hut, opening angle %.2f", openingAngle);
+            Report(name, treeTime, exactTime);
+            ReportError(forces, exact);
+        }
+    }
+    
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,242 @@
+#include "Benchmark.h"
+#include "Core/Math.h"
+#include "Core/SimdMath.h"
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace Daisy;
+using namespace Daisy::Bench;
+
+namespace {
+
+// The implementations before the SIMD kernels, kept as the baseline
+Matrix4 LegacyMultiply(const Matrix4& a, const Matrix4& b) {
+    Matrix4 result;
+    std::memset(result.m, 0, sizeof(result.m));
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            for (int k = 0; k < 4; ++k) {
+                result.m[i * 4 + j] += a.m[i * 4 + k] * b.m[k * 4 + j];
+            }
+        }
+    }
+    return result;
+}
+
+Vector4 LegacyTransform(const Matrix4& m, const Vector4& v) {
+    return Vector4(
+        m.m[0] * v.x + m.m[4] * v.y + m.m[8]  * v.z + m.m[12] * v.w,
+        m.m[1] * v.x + m.m[5] * v.y + m.m[9]  * v.z + m.m[13] * v.w,
+        m.m[2] * v.x + m.m[6] * v.y + m.m[10] * v.z + m.m[14] * v.w,
+        m.m[3] * v.x + m.m[7] * v.y + m.m[11] * v.z + m.m[15] * v.w
+    );
+}
+
+Quaternion LegacyMultiply(const Quaternion& a, const Quaternion& b) {
+    return Quaternion(
+        a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+        a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+        a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+        a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z
+    );
+}
+
+Quaternion LegacyNormalize(const Quaternion& q) {
+    float length = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    if (length > 0.0f) {
+        return Quaternion(q.x / length, q.y / length, q.z / length, q.w / length);
+    }
+    return Quaternion();
+}
+
+}
+
+int main() {
+    constexpr size_t count = 4096;
+    constexpr size_t iterations = 2'000'000;
+    
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+    
+    std::vector<Matrix4> matricesA(count), matricesB(count), matricesOut(count);
+    std::vector<Vector4> vectors(count), vectorsOut(count);
+    std::vector<Vector3> points(count), velocities(count), pointsOut(count);
+    std::vector<Quaternion> quaternionsA(count), quaternionsB(count), quaternionsOut(count);
+    for (size_t i = 0; i < count; ++i) {
+        for (float& element : matricesA[i].m) element = value(rng);
+        for (float& element : matricesB[i].m) element = value(rng);
+        vectors[i] = Vector4(value(rng), value(rng), value(rng), 1.0f);
+        points[i] = Vector3(value(rng), value(rng), value(rng));
+        velocities[i] = Vector3(value(rng), value(rng), value(rng));
+        quaternionsA[i] = Quaternion(value(rng), value(rng), value(rng), value(rng));
+        quaternionsB[i] = Quaternion(value(rng), value(rng), value(rng), value(rng));
+    }
+    const Matrix4& transform = matricesA[0];
+    
+    std::printf("Math kernels, %s build, %zu-element arrays\n", Simd::GetInstructionSet(), count);
+    
+    Section("Matrix4 * Matrix4");
+    double legacyMatrix = Measure(iterations, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            size_t j = i % count;
+            matricesOut[j] = LegacyMultiply(matricesA[j], matricesB[j]);
+        }
+        DoNotOptimize(matricesOut[0]);
+    });
+    Report("legacy triple loop", legacyMatrix);
+    double operatorMatrix = Measure(iterations, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            size_t j = i % count;
+            matricesOut[j] = matricesA[j] * matricesB[j];
+        }
+        DoNotOptimize(matricesOut[0]);
+    });
+    Report("Matrix4::operator*", operatorMatrix, legacyMatrix);
+    double batchMatrix = Measure(iterations, [&](size_t n) {
+        for (size_t i = 0; i < n; i += count) {
+            Simd::MultiplyMatrices(matricesA.data(), matricesB.data(), matricesOut.data(), std::min(count, n - i));
+        }
+        DoNotOptimize(matricesOut[0]);
+    });
+    Report("Simd::MultiplyMatrices", batchMatrix, legacyMatrix);
+    
+    Section("Matrix4 * Vector4");
+    double legacyTransform = Measure(iterations * 4, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            size_t j = i % count;
+            vectorsOut[j] = LegacyTransform(transform, vectors[j]);
+        }
+        DoNotOptimize(vectorsOut[0]);
+    });
+    Report("legacy", legacyTransform);
+    double operatorTransform = Measure(iterations * 4, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            size_t j = i % count;
+            vectorsOut[j] = transform * vectors[j];
+        }
+        DoNotOptimize(vectorsOut[0]);
+    });
+    Report("Matrix4::operator*", operatorTransform, legacyTransform);
+    double batchTransform = Measure(iterations * 4, [&](size_t n) {
+        for (size_t i = 0; i < n; i += count) {
+            Simd::TransformVectors(transform, vectors.data(), vectorsOut.data(), std::min(count, n - i));
+        }
+        DoNotOptimize(vectorsOut[0]);
+    });
+    Report("Simd::TransformVectors", batchTransform, legacyTransform);
+    double batchPoints = Measure(iterations * 4, [&](size_t n) {
+        for (size_t i = 0; i < n; i += count) {
+            Simd::TransformPoints(transform, points.data(), pointsOut.data(), std::min(count, n - i));
+        }
+        DoNotOptimize(pointsOut[0]);
+    });
+    Report("Simd::TransformPoints (Vector3)", batchPoints, legacyTransform);
+    
+    Section("Quaternion");
+    double legacyQuaternion = Measure(iterations * 4, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            size_t j = i % count;
+            quaternionsOut[j] = LegacyNormalize(LegacyMultiply(quaternionsA[j], quaternionsB[j]));
+        }
+        DoNotOptimize(quaternionsOut[0]);
+    });
+    Report("legacy multiply + normalize", legacyQuaternion);
+    double operatorQuaternion = Measure(iterations * 4, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            size_t j = i % count;
+            quaternionsOut[j] = (quaternionsA[j] * quaternionsB[j]).Normalized();
+        }
+        DoNotOptimize(quaternionsOut[0]);
+    });
+    Report("operator* + Normalized", operatorQuaternion, legacyQuaternion);
+    
+    Section("position + velocity * dt over Vector3 arrays");
+    double legacyIntegrate = Measure(iterations * 4, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            size_t j = i % count;
+            pointsOut[j] = points[j] + velocities[j] * 0.016f;
+        }
+        DoNotOptimize(pointsOut[0]);
+    });
+    Report("Vector3 operators", legacyIntegrate);
+    double batchIntegrate = Measure(iterations * 4, [&](size_t n) {
+        for (size_t i = 0; i < n; i += count) {
+            Simd::MultiplyAdd(points.data(), velocities.data(), 0.016f, pointsOut.data(), std::min(count, n - i));
+        }
+        DoNotOptimize(pointsOut[0]);
+    });
+    Report("Simd::MultiplyAdd", batchIntegrate, legacyIntegrate);
+    
+    Vector3Array pointStreams;
+    Vector3Array pointStreamsOut;
+    pointStreamsOut.Resize(count);
+    for (const Vector3& point : points) {
+        pointStreams.PushBack(point);
+    }
+    std::vector<float> distances(count);
+    const Vector3 origin(1.0f, 2.0f, 3.0f);
+    
+    Section("Distance to a point, SoA batch vs Vector3::Length");
+    double legacyDistance = Measure(iterations * 4, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            size_t j = i % count;
+            distances[j] = (points[j] - origin).Length();
+        }
+        DoNotOptimize(distances[0]);
+    });
+    Report("Vector3::Length", legacyDistance);
+    double batchDistance = Measure(iterations * 4, [&](size_t n) {
+        for (size_t i = 0; i < n; i += count) {
+            Simd::Distances(pointStreams.GetStream(), origin, distances.data(), std::min(count, n - i));
+        }
+        DoNotOptimize(distances[0]);
+    });
+    Report("Simd::Distances", batchDistance, legacyDistance);
+    double batchDistanceSquared = Measure(iterations * 4, [&](size_t n) {
+        for (size_t i = 0; i < n; i += count) {
+            Simd::DistancesSquared(pointStreams.GetStream(), origin, distances.data(), std::min(count, n - i));
+        }
+        DoNotOptimize(distances[0]);
+    });
+    Report("Simd::DistancesSquared", batchDistanceSquared, legacyDistance);
+    
+    Section("Transform points, SoA vs AoS");
+    Report("Simd::TransformPoints (Vector3)", batchPoints);
+    double soaPoints = Measure(iterations * 4, [&](size_t n) {
+        for (size_t i = 0; i < n; i += count) {
+            Simd::TransformPoints(transform, pointStreams.GetStream(), pointStreamsOut.GetStream(), std::min(count, n - i));
+        }
+        DoNotOptimize(pointStreamsOut.Get(0));
+    });
+    Report("Simd::TransformPoints (Vector3Array)", soaPoints, batchPoints);
+    
+    // In place, so after the first pass the inputs are already unit length;
+    // neither kernel's cost depends on that
+    Section("Normalize quaternions, SoA vs AoS");
+    std::vector<float> qx(count), qy(count), qz(count), qw(count);
+    for (size_t i = 0; i < count; ++i) {
+        qx[i] = quaternionsA[i].x;
+        qy[i] = quaternionsA[i].y;
+        qz[i] = quaternionsA[i].z;
+        qw[i] = quaternionsA[i].w;
+    }
+    double aosNormalize = Measure(iterations * 4, [&](size_t n) {
+        for (size_t i = 0; i < n; i += count) {
+            Simd::NormalizeQuaternions(quaternionsA.data(), std::min(count, n - i));
+        }
+        DoNotOptimize(quaternionsA[0]);
+    });
+    Report("Simd::NormalizeQuaternions (Quaternion)", aosNormalize);
+    double soaNormalize = Measure(iterations * 4, [&](size_t n) {
+        for (size_t i = 0; i < n; i += count) {
+            Simd::NormalizeQuaternions(Simd::QuaternionStream{qx.data(), qy.data(), qz.data(), qw.data()},
+                                       std::min(count, n - i));
+        }
+        DoNotOptimize(qx[0]);
+    });
+    Report("Simd::NormalizeQuaternions (streams)", soaNormalize, aosNormalize);
+    
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "Benchmark.h"
+#include "Core/Engine.h"
+#include <memory>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+using namespace Daisy;
+using namespace Daisy::Bench;
+
+namespace {
+
+template<int N>
+class BenchModule : public Module {
+public:
+    BenchModule() : Module("BenchModule") {}
+    
+    bool Initialize() override { return true; }
+    void Update(float deltaTime) override { m_accumulated += deltaTime; }
+    void Shutdown() override {}
+    
+    float m_accumulated = 0.0f;
+};
+
+// The lookup Engine used before type slots: a hash of std::type_index per call
+struct TypeIndexRegistry {
+    template<typename T>
+    void Register(Module* module) {
+        std::type_index typeIndex(typeid(T));
+        modules[typeIndex] = module;
+        order.push_back(typeIndex);
+    }
+    
+    template<typename T>
+    T* Get() {
+        auto it = modules.find(std::type_index(typeid(T)));
+        return it != modules.end() ? static_cast<T*>(it->second) : nullptr;
+    }
+    
+    std::unordered_map<std::type_index, Module*> modules;
+    std::vector<std::type_index> order;
+};
+
+template<int... N>
+void RegisterAll(Engine& engine, TypeIndexRegistry& registry, std::integer_sequence<int, N...>) {
+    (registry.Register<BenchModule<N>>(engine.RegisterModule<BenchModule<N>>()), ...);
+}
+
+}
+
+int main() {
+    constexpr size_t iterations = 10'000'000;
+    
+    Engine engine;
+    TypeIndexRegistry registry;
+    RegisterAll(engine, registry, std::make_integer_sequence<int, 16>{});
+    
+    Section("GetModule<T>() - four lookups per iteration, 16 registered modules");
+    
+    double legacyLookup = Measure(iterations, [&](size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            DoNotOptimize(registry.Get<BenchModule<0>>());
+            DoNotOptimize(registry.Get<BenchModule<5>>());
+            DoNotOptimize(registry.Get<BenchModule<10>>());
+            DoNotOptimize(registry.Get<BenchModule<15>>());
+        }
+    });
+    Report("unordered_map<type_index>", legacyLookup);
+    
+    double slotLookup = Measure(iterations, [&](size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            DoNotOptimize(engine.GetModule<BenchModule<0>>());
+            DoNotOptimize(engine.GetModule<BenchModule<5>>());
+            DoNotOptimize(engine.GetModule<BenchModule<10>>());
+            DoNotOptimize(engine.GetModule<BenchModule<15>>());
+        }
+    });
+    Report("ModuleTypeId slot table", slotLookup, legacyLookup);
+    
+    Section("Ordered iteration over 16 modules");
+    
+    std::vector<Module*> ordered;
+    for (auto& typeIndex : registry.order) {
+        ordered.push_back(registry.modules[typeIndex]);
+    }
+    
+    double legacyIteration = Measure(iterations / 10, [&](size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            for (auto& typeIndex : registry.order) {
+                DoNotOptimize(registry.modules[typeIndex]);
+            }
+        }
+    });
+    Report("type_index order + hash lookup", legacyIteration);
+    
+    double denseIteration = Measure(iterations / 10, [&](size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            for (Module* module : ordered) {
+                DoNotOptimize(module);
+            }
+        }
+    });
+    Report("dense module array", denseIteration, legacyIteration);
+    
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include "Benchmark.h"
+#include "Core/Engine.h"
+#include "DaisyPhysics.h"
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace Daisy;
+using namespace Daisy::Bench;
+
+namespace {
+
+// Unit spheres spread at about 1.3 contacts per body, as in the broadphase
+// benchmark, away from the origin so the double-precision path is exercised
+std::vector<DVector3> MakePositions(size_t count, std::mt19937& rng) {
+    const DVector3 offset(1e6, 0.0, -1e6);
+    double size = std::cbrt(static_cast<double>(count) * 48.0);
+    std::uniform_real_distribution<double> coordinate(0.0, size);
+    std::vector<DVector3> positions;
+    for (size_t i = 0; i < count; ++i) {
+        positions.push_back(offset + DVector3(coordinate(rng), coordinate(rng), coordinate(rng)));
+    }
+    return positions;
+}
+
+// Bodies flying at a few metres per second, so they keep colliding
+void CreateScene(DaisyPhysics& physics, const std::vector<DVector3>& positions, std::vector<RigidBodyHandle>& handles) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> speed(-3.0f, 3.0f);
+    handles.resize(positions.size());
+    physics.CreateRigidBodies(positions, handles);
+    for (RigidBodyHandle handle : handles) {
+        physics.ApplyImpulse(handle, Vector3(speed(rng), speed(rng), speed(rng)));
+    }
+}
+
+// Hash of every position's bits, to compare runs exactly
+uint64_t HashPositions(DaisyPhysics& physics, const std::vector<RigidBodyHandle>& handles) {
+    uint64_t hash = 14695981039346656037ull;
+    for (RigidBodyHandle handle : handles) {
+        const DVector3& position = physics.GetRigidBody(handle)->position;
+        double components[3] = {position.x, position.y, position.z};
+        uint64_t bits[3];
+        std::memcpy(bits, components, sizeof(bits));
+        for (uint64_t word : bits) {
+            hash = (hash ^ word) * 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+}
+
+int main() {
+    constexpr size_t residentCount = 10'000;
+    constexpr size_t debrisCount = 5'000;
+    
+    std::mt19937 rng(42);
+    std::vector<DVector3> resident = MakePositions(residentCount, rng);
+    std::vector<DVector3> debris = MakePositions(debrisCount, rng);
+    std::vector<RigidBodyHandle> handles(debrisCount);
+    
+    // Through an engine, so the step can use its job system
+    Engine engine;
+    DaisyPhysics& physics = *engine.RegisterModule<DaisyPhysics>();
+    engine.Initialize();
+    physics.SetGlobalGravity(Vector3(0, 0, 0));
+    for (const DVector3& position : resident) {
+        physics.CreateRigidBody(position);
+    }
+    physics.Update(1.0f / 60.0f);
+    
+    std::printf("Physics, %zu resident bodies\n", residentCount);
+    
+    Section("Fixed step");
+    double step = Measure(residentCount * 50, [&](size_t n) {
+        for (size_t done = 0; done < n; done += residentCount) {
+            physics.Update(1.0f / 60.0f);
+        }
+    });
+    Report("Update, per body", step);
+    double stepTime = step * static_cast<double>(residentCount);
+    std::printf("  %-44s %10.3f ms\n", "step", stepTime * 1e-6);
+    
+    // A burst of debris spawned and cleared again before a step, which also
+    // retires the broadphase entries. Reported per debris body with the step
+    // taken out.
+    char title[128];
+    std::snprintf(title, sizeof(title), "Spawn and despawn %zu debris bodies", debrisCount);
+    Section(title);
+    constexpr size_t rounds = 20;
+    auto perBody = [&](double roundTime) {
+        return (roundTime - stepTime) / static_cast<double>(debrisCount);
+    };
+    double single = perBody(Measure(rounds, [&](size_t n) {
+        for (size_t round = 0; round < n; ++round) {
+            for (size_t i = 0; i < debrisCount; ++i) {
+                handles[i] = physics.CreateRigidBody(debris[i]);
+            }
+            for (size_t i = 0; i < debrisCount; ++i) {
+                physics.DestroyRigidBody(handles[i]);
+            }
+            physics.Update(1.0f / 60.0f);
+        }
+    }));
+    Report("CreateRigidBody + DestroyRigidBody", single);
+    double batch = perBody(Measure(rounds, [&](size_t n) {
+        for (size_t round = 0; round < n; ++round) {
+            physics.CreateRigidBodies(debris, handles);
+            physics.DestroyRigidBodies(handles);
+            physics.Update(1.0f / 60.0f);
+        }
+    }));
+    Report("CreateRigidBodies + DestroyRigidBodies", batch, single);
+    
+    // The same scene stepped with more and more workers; the result must not
+    // change by a single bit
+    constexpr size_t sceneCount = 100'000;
+    constexpr int sceneSteps = 10;
+    std::vector<DVector3> scenePositions = MakePositions(sceneCount, rng);
+    std::vector<RigidBodyHandle> sceneHandles;
+    std::snprintf(title, sizeof(title), "%zu moving bodies by worker count", sceneCount);
+    Section(title);
+    // At least three workers, so the comparison runs even on small machines
+    uint32_t maxWorkers = std::max(4u, std::thread::hardware_concurrency()) - 1;
+    uint64_t expectedHash = 0;
+    double serialStep = 0.0;
+    for (uint32_t workers : {0u, 1u, 3u, 7u, 15u}) {
+        if (workers > maxWorkers) {
+            break;
+        }
+        engine.SetWorkerThreadCount(workers);
+        
+        physics.Shutdown();
+        physics.Initialize();
+        physics.SetGlobalGravity(Vector3(0, 0, 0));
+        CreateScene(physics, scenePositions, sceneHandles);
+        for (int i = 0; i < sceneSteps; ++i) {
+            physics.Update(1.0f / 60.0f);
+        }
+        uint64_t hash = HashPositions(physics, sceneHandles);
+        if (workers == 0) {
+            expectedHash = hash;
+        } else if (hash != expectedHash) {
+            std::printf("  MISMATCH: %u workers gave a different result\n", workers);
+            return 1;
+        }
+        
+        double sceneStep = Measure(sceneCount * 10, [&](size_t n) {
+            for (size_t done = 0; done < n; done += sceneCount) {
+                physics.Update(1.0f / 60.0f);
+            }
+        }, 3) * static_cast<double>(sceneCount) * 1e-6;
+        if (workers == 0) {
+            serialStep = sceneStep;
+        }
+        char name[64];
+        std::snprintf(name, sizeof(name), "%u workers, step", workers);
+        std::printf("  %-44s %10.3f ms  %6.2fx\n", name, sceneStep, serialStep / sceneStep);
+    }
+    std::printf("  results bitwise identical across worker counts\n");
+    
+    engine.Shutdown();
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,152 @@
+#include "Benchmark.h"
+#include "Core/Memory.h"
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+using namespace Daisy;
+using namespace Daisy::Bench;
+
+namespace {
+
+struct Particle {
+    float position[3] = {};
+    float velocity[3] = {};
+    float lifetime = 0.0f;
+    int id = 0;
+};
+
+// The pool used before the slab rewrite: a mutex, a std::queue of free
+// objects, a linear ownership scan and one heap allocation per object
+template<typename T>
+class LegacyPoolAllocator {
+public:
+    explicit LegacyPoolAllocator(size_t poolSize = 1024) : m_poolSize(poolSize) {
+        m_pool.reserve(m_poolSize);
+        for (size_t i = 0; i < m_poolSize; ++i) {
+            m_pool.emplace_back(std::make_unique<T>());
+            m_available.push(m_pool.back().get());
+        }
+    }
+    
+    T* Acquire() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_available.empty()) {
+            return new T();
+        }
+        
+        T* obj = m_available.front();
+        m_available.pop();
+        return obj;
+    }
+    
+    void Release(T* obj) {
+        if (!obj) return;
+        
+        std::lock_guard<std::mutex> lock(m_mutex);
+        
+        bool isFromPool = false;
+        for (const auto& poolObj : m_pool) {
+            if (poolObj.get() == obj) {
+                isFromPool = true;
+                break;
+            }
+        }
+        
+        if (isFromPool) {
+            m_available.push(obj);
+        } else {
+            delete obj;
+        }
+    }
+    
+private:
+    std::vector<std::unique_ptr<T>> m_pool;
+    std::queue<T*> m_available;
+    std::mutex m_mutex;
+    size_t m_poolSize;
+};
+
+// Acquires batchSize objects, then releases them in reverse order
+template<typename Pool>
+void Churn(Pool& pool, size_t iterations, size_t batchSize) {
+    std::vector<Particle*> batch(batchSize);
+    for (size_t i = 0; i < iterations; i += batchSize) {
+        for (size_t j = 0; j < batchSize; ++j) {
+            batch[j] = pool.Acquire();
+            DoNotOptimize(batch[j]);
+        }
+        for (size_t j = batchSize; j-- > 0;) {
+            pool.Release(batch[j]);
+        }
+    }
+}
+
+template<typename Pool>
+double MeasureThreaded(Pool& pool, size_t iterations, size_t threadCount, size_t batchSize) {
+    return Measure(iterations, [&](size_t count) {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&pool, count, threadCount, batchSize]() {
+                Churn(pool, count / threadCount, batchSize);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }, 3);
+}
+
+}
+
+int main() {
+    constexpr size_t iterations = 2'000'000;
+    constexpr size_t poolSize = 1024;
+    
+    Section("Acquire + Release, single thread, 1024-object pool");
+    
+    {
+        LegacyPoolAllocator<Particle> legacy(poolSize);
+        PoolAllocator<Particle> pool(poolSize);
+        
+        double legacyPair = Measure(iterations, [&](size_t count) { Churn(legacy, count, 1); });
+        Report("legacy, one object at a time", legacyPair);
+        double slabPair = Measure(iterations, [&](size_t count) { Churn(pool, count, 1); });
+        Report("slab pool, one object at a time", slabPair, legacyPair);
+        
+        // Deep batches make the legacy ownership scan walk most of the pool
+        double legacyBatch = Measure(iterations / 10, [&](size_t count) { Churn(legacy, count, 512); });
+        Report("legacy, batches of 512", legacyBatch);
+        double slabBatch = Measure(iterations / 10, [&](size_t count) { Churn(pool, count, 512); });
+        Report("slab pool, batches of 512", slabBatch, legacyBatch);
+    }
+    
+    Section("Beyond the initial capacity (batches of 4096, 1024-object pool)");
+    
+    {
+        LegacyPoolAllocator<Particle> legacy(poolSize);
+        PoolAllocator<Particle> pool(poolSize);
+        
+        double legacyOverflow = Measure(iterations / 100, [&](size_t count) { Churn(legacy, count, 4096); }, 3);
+        Report("legacy, new/delete fallback", legacyOverflow);
+        double slabOverflow = Measure(iterations / 100, [&](size_t count) { Churn(pool, count, 4096); }, 3);
+        Report("slab pool, grown by slabs", slabOverflow, legacyOverflow);
+    }
+    
+    size_t threadCount = std::max(2u, std::min(8u, std::thread::hardware_concurrency()));
+    std::printf("\nContended, %zu threads, batches of 16\n", threadCount);
+    
+    {
+        LegacyPoolAllocator<Particle> legacy(poolSize);
+        PoolAllocator<Particle> pool(poolSize);
+        
+        double legacyThreaded = MeasureThreaded(legacy, iterations, threadCount, 16);
+        Report("legacy", legacyThreaded);
+        double slabThreaded = MeasureThreaded(pool, iterations, threadCount, 16);
+        Report("slab pool", slabThreaded, legacyThreaded);
+    }
+    
+    return 0;
+}
\ No newline at end of file
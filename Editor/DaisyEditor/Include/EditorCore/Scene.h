@@ -3,6 +3,7 @@
 #include "Core/Math.h"
 #include <vector>
 #include <memory>
+#include <memory_resource>
 #include <unordered_map>
 #include <string>
 
@@ -68,7 +69,9 @@ public:
     Entity* FindEntityByName(const std::string& name);
     
     const std::vector<std::unique_ptr<Entity>>& GetEntities() const { return m_entities; }
-    std::vector<Entity*> GetRootEntities() const;
+    // Per-frame callers should pass the engine's frame arena resource
+    std::pmr::vector<Entity*> GetRootEntities(
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
     
     bool SaveToFile(const std::string& filepath) const;
     bool LoadFromFile(const std::string& filepath);
@@ -27,17 +27,17 @@ bool DaisyEditor::Initialize() {
         return true;
     }
     
-    DAISY_INFO("Initializing Daisy Editor...");
+    DAISY_CHANNEL_INFO(Editor, "Initializing Daisy Editor...");
     
     // Initialize the engine
     if (!DAISY_ENGINE.Initialize()) {
-        DAISY_ERROR("Failed to initialize Daisy Engine");
+        DAISY_CHANNEL_ERROR(Editor, "Failed to initialize Daisy Engine");
         return false;
     }
     
     m_engine = DAISY_ENGINE.GetEngine();
     if (!m_engine) {
-        DAISY_ERROR("Failed to get Engine module");
+        DAISY_CHANNEL_ERROR(Editor, "Failed to get Engine module");
         return false;
     }
     
@@ -62,7 +62,7 @@ bool DaisyEditor::Initialize() {
         // Create editor window or use main window
         auto* editorWindow = platform->GetMainWindow();
         if (!editorWindow) {
-            DAISY_ERROR("Failed to get main window for editor");
+            DAISY_CHANNEL_ERROR(Editor, "Failed to get main window for editor");
             return false;
         }
         
@@ -82,24 +82,24 @@ bool DaisyEditor::Initialize() {
     m_editorCamera = std::make_unique<EditorCamera>();
     
     if (!m_assetManager->Initialize()) {
-        DAISY_WARNING("Failed to initialize Asset Manager");
+        DAISY_CHANNEL_WARNING(Editor, "Failed to initialize Asset Manager");
     }
     
     // Initialize UI
     InitializeUI();
     
     m_initialized = true;
-    DAISY_INFO("Daisy Editor initialized successfully");
+    DAISY_CHANNEL_INFO(Editor, "Daisy Editor initialized successfully");
     return true;
 }
 
 void DaisyEditor::Run() {
     if (!m_initialized) {
-        DAISY_ERROR("Editor not initialized");
+        DAISY_CHANNEL_ERROR(Editor, "Editor not initialized");
         return;
     }
     
-    DAISY_INFO("Starting Daisy Editor main loop...");
+    DAISY_CHANNEL_INFO(Editor, "Starting Daisy Editor main loop...");
     m_running = true;
     
     auto lastTime = std::chrono::high_resolution_clock::now();
@@ -126,7 +126,7 @@ void DaisyEditor::Run() {
         std::this_thread::sleep_for(std::chrono::milliseconds(16));
     }
     
-    DAISY_INFO("Daisy Editor main loop ended");
+    DAISY_CHANNEL_INFO(Editor, "Daisy Editor main loop ended");
 }
 
 void DaisyEditor::Shutdown() {
@@ -134,7 +134,7 @@ void DaisyEditor::Shutdown() {
         return;
     }
     
-    DAISY_INFO("Shutting down Daisy Editor...");
+    DAISY_CHANNEL_INFO(Editor, "Shutting down Daisy Editor...");
     
     m_running = false;
     
@@ -148,13 +148,13 @@ void DaisyEditor::Shutdown() {
     DAISY_ENGINE.Shutdown();
     
     m_initialized = false;
-    DAISY_INFO("Daisy Editor shut down successfully");
+    DAISY_CHANNEL_INFO(Editor, "Daisy Editor shut down successfully");
 }
 
 void DaisyEditor::NewScene() {
     m_currentScene = std::make_unique<Scene>("New Scene");
     m_currentScenePath.clear();
-    DAISY_INFO("Created new scene");
+    DAISY_CHANNEL_INFO(Editor, "Created new scene");
 }
 
 void DaisyEditor::OpenScene(const std::string& filepath) {
@@ -162,9 +162,9 @@ void DaisyEditor::OpenScene(const std::string& filepath) {
     if (newScene->LoadFromFile(filepath)) {
         m_currentScene = std::move(newScene);
         m_currentScenePath = filepath;
-        DAISY_INFO("Opened scene: {}", filepath);
+        DAISY_CHANNEL_INFO(Editor, "Opened scene: {}", filepath);
     } else {
-        DAISY_ERROR("Failed to open scene: {}", filepath);
+        DAISY_CHANNEL_ERROR(Editor, "Failed to open scene: {}", filepath);
     }
 }
 
@@ -177,9 +177,9 @@ void DaisyEditor::SaveScene(const std::string& filepath) {
     
     if (m_currentScene->SaveToFile(savePath)) {
         m_currentScenePath = savePath;
-        DAISY_INFO("Saved scene: {}", savePath);
+        DAISY_CHANNEL_INFO(Editor, "Saved scene: {}", savePath);
     } else {
-        DAISY_ERROR("Failed to save scene: {}", savePath);
+        DAISY_CHANNEL_ERROR(Editor, "Failed to save scene: {}", savePath);
     }
 }
 
@@ -201,10 +201,10 @@ void DaisyEditor::SetPlayMode(bool play) {
     m_playMode = play;
     
     if (m_playMode) {
-        DAISY_INFO("Entering play mode");
+        DAISY_CHANNEL_INFO(Editor, "Entering play mode");
         // Save current scene state for restoration
     } else {
-        DAISY_INFO("Exiting play mode");
+        DAISY_CHANNEL_INFO(Editor, "Exiting play mode");
         // Restore scene state
     }
 }
@@ -218,7 +218,7 @@ void DaisyEditor::InitializeUI() {
     m_windows.push_back(std::make_unique<AssetBrowserWindow>());
     m_windows.push_back(std::make_unique<ConsoleWindow>());
     
-    DAISY_INFO("Editor UI initialized");
+    DAISY_CHANNEL_INFO(Editor, "Editor UI initialized");
 }
 
 void DaisyEditor::Update(float deltaTime) {
@@ -260,7 +260,7 @@ void DaisyEditor::Render() {
     // For now, just print a status message periodically
     static int frameCount = 0;
     if (++frameCount % 300 == 0) { // Every ~5 seconds at 60fps
-        DAISY_INFO("Editor running - Frame {}", frameCount);
+        DAISY_CHANNEL_INFO(Editor, "Editor running - Frame {}", frameCount);
     }
 }
 
@@ -47,7 +47,7 @@ bool AssetManager::Initialize(const std::string& assetsDirectory) {
     try {
         if (!std::filesystem::exists(m_assetsDirectory)) {
             std::filesystem::create_directories(m_assetsDirectory);
-            DAISY_INFO("Created assets directory: {}", m_assetsDirectory);
+            DAISY_CHANNEL_INFO(Editor, "Created assets directory: {}", m_assetsDirectory);
         }
         
         // Create default subdirectories
@@ -64,13 +64,13 @@ bool AssetManager::Initialize(const std::string& assetsDirectory) {
         }
         
     } catch (const std::exception& e) {
-        DAISY_ERROR("Failed to create assets directory: {}", e.what());
+        DAISY_CHANNEL_ERROR(Editor, "Failed to create assets directory: {}", e.what());
         return false;
     }
     
     RefreshAssets();
     
-    DAISY_INFO("Asset Manager initialized - Assets directory: {}", m_assetsDirectory);
+    DAISY_CHANNEL_INFO(Editor, "Asset Manager initialized - Assets directory: {}", m_assetsDirectory);
     return true;
 }
 
@@ -87,7 +87,7 @@ void AssetManager::RefreshAssets() {
     
     ScanDirectory(m_assetsDirectory);
     
-    DAISY_INFO("Refreshed assets - Found {} assets", m_assets.size());
+    DAISY_CHANNEL_INFO(Editor, "Refreshed assets - Found {} assets", m_assets.size());
 }
 
 void AssetManager::ScanDirectory(const std::string& directory) {
@@ -104,7 +104,7 @@ void AssetManager::ScanDirectory(const std::string& directory) {
             }
         }
     } catch (const std::exception& e) {
-        DAISY_ERROR("Failed to scan directory {}: {}", directory, e.what());
+        DAISY_CHANNEL_ERROR(Editor, "Failed to scan directory {}: {}", directory, e.what());
     }
 }
 
@@ -149,12 +149,12 @@ std::string AssetManager::GetAssetTypeString(AssetType type) const {
 
 bool AssetManager::ImportAsset(const std::string& filepath) {
     if (!IsValidAssetFile(filepath)) {
-        DAISY_WARNING("Invalid asset file: {}", filepath);
+        DAISY_CHANNEL_WARNING(Editor, "Invalid asset file: {}", filepath);
         return false;
     }
     
     ProcessFile(filepath);
-    DAISY_INFO("Imported asset: {}", filepath);
+    DAISY_CHANNEL_INFO(Editor, "Imported asset: {}", filepath);
     return true;
 }
 
@@ -173,11 +173,11 @@ bool AssetManager::DeleteAsset(const std::string& filepath) {
                 m_assetMap.erase(it);
             }
             
-            DAISY_INFO("Deleted asset: {}", filepath);
+            DAISY_CHANNEL_INFO(Editor, "Deleted asset: {}", filepath);
             return true;
         }
     } catch (const std::exception& e) {
-        DAISY_ERROR("Failed to delete asset {}: {}", filepath, e.what());
+        DAISY_CHANNEL_ERROR(Editor, "Failed to delete asset {}: {}", filepath, e.what());
     }
     
     return false;
@@ -201,11 +201,11 @@ bool AssetManager::RenameAsset(const std::string& oldPath, const std::string& ne
                 m_assetMap[newPath] = asset;
             }
             
-            DAISY_INFO("Renamed asset: {} -> {}", oldPath, newPath);
+            DAISY_CHANNEL_INFO(Editor, "Renamed asset: {} -> {}", oldPath, newPath);
             return true;
         }
     } catch (const std::exception& e) {
-        DAISY_ERROR("Failed to rename asset {}: {}", oldPath, e.what());
+        DAISY_CHANNEL_ERROR(Editor, "Failed to rename asset {}: {}", oldPath, e.what());
     }
     
     return false;
@@ -219,11 +219,11 @@ bool AssetManager::CreateDirectory(const std::string& path) {
     try {
         if (std::filesystem::create_directories(path)) {
             m_directories.push_back(path);
-            DAISY_INFO("Created directory: {}", path);
+            DAISY_CHANNEL_INFO(Editor, "Created directory: {}", path);
             return true;
         }
     } catch (const std::exception& e) {
-        DAISY_ERROR("Failed to create directory {}: {}", path, e.what());
+        DAISY_CHANNEL_ERROR(Editor, "Failed to create directory {}: {}", path, e.what());
     }
     
     return false;
@@ -254,11 +254,11 @@ bool AssetManager::DeleteDirectory(const std::string& path) {
                 }
             }
             
-            DAISY_INFO("Deleted directory: {}", path);
+            DAISY_CHANNEL_INFO(Editor, "Deleted directory: {}", path);
             return true;
         }
     } catch (const std::exception& e) {
-        DAISY_ERROR("Failed to delete directory {}: {}", path, e.what());
+        DAISY_CHANNEL_ERROR(Editor, "Failed to delete directory {}: {}", path, e.what());
     }
     
     return false;
@@ -300,7 +300,7 @@ void AssetManager::UpdateAssetInfo(AssetInfo& asset) {
             asset.lastModified = "Recently"; // Would implement proper time formatting
         }
     } catch (const std::exception& e) {
-        DAISY_WARNING("Failed to update asset info for {}: {}", asset.filepath, e.what());
+        DAISY_CHANNEL_WARNING(Editor, "Failed to update asset info for {}: {}", asset.filepath, e.what());
     }
 }
 
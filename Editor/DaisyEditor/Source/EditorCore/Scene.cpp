@@ -52,7 +52,7 @@ void Entity::RemoveChild(Entity* child) {
 }
 
 Scene::Scene(const std::string& name) : m_name(name) {
-    DAISY_INFO("Created scene: {}", name);
+    DAISY_CHANNEL_INFO(Editor, "Created scene: {}", name);
 }
 
 Scene::~Scene() {
@@ -66,7 +66,7 @@ Entity* Scene::CreateEntity(const std::string& name) {
     m_entityMap[entityPtr->GetId()] = entityPtr;
     m_entities.push_back(std::move(entity));
     
-    DAISY_DEBUG("Created entity '{}' with ID {}", name, entityPtr->GetId());
+    DAISY_CHANNEL_DEBUG(Editor, "Created entity '{}' with ID {}", name, entityPtr->GetId());
     return entityPtr;
 }
 
@@ -93,7 +93,7 @@ void Scene::DestroyEntity(uint32_t entityId) {
         m_entityMap.erase(entityId);
         m_entities.erase(it);
         
-        DAISY_DEBUG("Destroyed entity with ID {}", entityId);
+        DAISY_CHANNEL_DEBUG(Editor, "Destroyed entity with ID {}", entityId);
     }
 }
 
@@ -111,8 +111,8 @@ Entity* Scene::FindEntityByName(const std::string& name) {
     return it != m_entities.end() ? it->get() : nullptr;
 }
 
-std::vector<Entity*> Scene::GetRootEntities() const {
-    std::vector<Entity*> rootEntities;
+std::pmr::vector<Entity*> Scene::GetRootEntities(std::pmr::memory_resource* resource) const {
+    std::pmr::vector<Entity*> rootEntities(resource);
     
     for (const auto& entity : m_entities) {
         if (!entity->GetParent()) {
@@ -126,7 +126,7 @@ std::vector<Entity*> Scene::GetRootEntities() const {
 bool Scene::SaveToFile(const std::string& filepath) const {
     std::ofstream file(filepath);
     if (!file.is_open()) {
-        DAISY_ERROR("Failed to open file for writing: {}", filepath);
+        DAISY_CHANNEL_ERROR(Editor, "Failed to open file for writing: {}", filepath);
         return false;
     }
     
@@ -160,14 +160,14 @@ bool Scene::SaveToFile(const std::string& filepath) const {
     file << "  ]\n";
     file << "}\n";
     
-    DAISY_INFO("Saved scene to: {}", filepath);
+    DAISY_CHANNEL_INFO(Editor, "Saved scene to: {}", filepath);
     return true;
 }
 
 bool Scene::LoadFromFile(const std::string& filepath) {
     std::ifstream file(filepath);
     if (!file.is_open()) {
-        DAISY_ERROR("Failed to open file for reading: {}", filepath);
+        DAISY_CHANNEL_ERROR(Editor, "Failed to open file for reading: {}", filepath);
         return false;
     }
     
@@ -195,7 +195,7 @@ bool Scene::LoadFromFile(const std::string& filepath) {
     // Create a default entity since we don't have full parsing
     CreateEntity("Default Entity");
     
-    DAISY_INFO("Loaded scene from: {}", filepath);
+    DAISY_CHANNEL_INFO(Editor, "Loaded scene from: {}", filepath);
     return true;
 }
 
@@ -203,7 +203,7 @@ void Scene::Clear() {
     m_entities.clear();
     m_entityMap.clear();
     m_nextEntityId = 1;
-    DAISY_INFO("Cleared scene");
+    DAISY_CHANNEL_INFO(Editor, "Cleared scene");
 }
 
 }
\ No newline at end of file
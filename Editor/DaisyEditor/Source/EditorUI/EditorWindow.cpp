@@ -83,7 +83,9 @@ void HierarchyWindow::RenderEntityHierarchy() {
     std::cout << "Scene: " << scene->GetName() << std::endl;
     
     // Render root entities
-    std::vector<Entity*> rootEntities = scene->GetRootEntities();
+    Daisy::Engine* engine = DAISY_EDITOR.GetEngine();
+    auto rootEntities = scene->GetRootEntities(
+        engine ? engine->GetFrameArena().GetResource() : std::pmr::get_default_resource());
     for (Entity* entity : rootEntities) {
         RenderEntityNode(entity);
     }
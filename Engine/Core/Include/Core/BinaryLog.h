@@ -0,0 +1,114 @@
+#pragma once
+
+#include "Logger.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Daisy {
+
+// File layout: a BinaryLogHeader followed by 8-byte aligned records. Records
+// never straddle a chunk boundary; a zero record type means the rest of the
+// chunk is unused (tail padding, or a write cut short by a crash).
+struct BinaryLogHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t chunkSize;
+    int64_t wallClockStartNs;   // system_clock at open, record timestamps are steady_clock offsets from it
+};
+
+enum class BinaryLogRecordType : uint8_t {
+    Format = 1,     // Registers formatId; the format string follows the header
+    Message = 2,    // A log call; argCount tagged arguments follow the header
+    Padding = 3     // Only type and size are valid; marks bytes to skip at a chunk start
+};
+
+struct BinaryLogRecordHeader {
+    BinaryLogRecordType type;
+    uint8_t level;
+    uint16_t argCount;
+    uint32_t size;          // Header plus payload, before alignment padding
+    uint32_t formatId;      // 0 for messages logged without a format string
+    uint8_t channel;        // LogChannel of a Message record
+    uint8_t reserved[3];
+    uint64_t timestampNs;
+};
+
+// Writes log calls as a format ID plus raw argument bytes into a memory-mapped
+// file, leaving all text formatting to the offline decoder (DaisyLogDecoder)
+class BinaryLogSink {
+public:
+    static constexpr uint32_t ChunkSize = 16u << 20;
+    static constexpr uint32_t MaxChunks = 4096;
+    
+    BinaryLogSink();
+    ~BinaryLogSink();
+    
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return m_open.load(std::memory_order_acquire); }
+    
+    void Write(LogChannel channel, LogLevel level, std::string_view format, const LogArg* args, size_t count);
+    void WriteVerbatim(LogChannel channel, LogLevel level, std::string_view message);
+    
+    uint64_t GetBytesWritten() const { return m_writePosition.load(std::memory_order_relaxed); }
+    
+private:
+    uint32_t GetFormatId(std::string_view format);
+    void WriteRecord(LogChannel channel, LogLevel level, BinaryLogRecordType type, uint32_t formatId, std::string_view text,
+                     const LogArg* args, size_t count);
+    void Commit(const uint8_t* data, size_t size);
+    uint8_t* GetChunk(uint64_t index);
+    void UnmapAll();
+    
+    std::atomic<bool> m_open{false};
+    std::atomic<uint32_t> m_activeWriters{0};
+    std::atomic<uint64_t> m_writePosition{0};
+    uint64_t m_generation = 0;
+    std::chrono::steady_clock::time_point m_steadyStart;
+    
+    std::mutex m_chunkMutex;
+    std::unique_ptr<std::atomic<uint8_t*>[]> m_chunks;
+    uint64_t m_fileSize = 0;
+    intptr_t m_file = -1;
+    
+    std::mutex m_formatMutex;
+    std::unordered_map<const char*, uint32_t> m_formatIds;
+    uint32_t m_nextFormatId = 1;
+};
+
+struct BinaryLogEntry {
+    LogLevel level = LogLevel::Info;
+    LogChannel channel = LogChannel::General;
+    std::chrono::system_clock::time_point time;
+    std::string_view message;   // Valid until the next call to Next
+};
+
+// Streams a binary log back as formatted entries, one chunk in memory at a time
+class BinaryLogReader {
+public:
+    bool Open(const std::string& path);
+    bool Next(BinaryLogEntry& entry);
+    
+    const std::string& GetError() const { return m_error; }
+    
+private:
+    bool LoadNextChunk();
+    
+    std::ifstream m_file;
+    BinaryLogHeader m_header{};
+    std::vector<uint8_t> m_chunk;
+    size_t m_offset = 0;
+    std::unordered_map<uint32_t, std::string> m_formats;
+    std::vector<LogArg> m_args;
+    std::string m_error;
+};
+
+}
\ No newline at end of file
@@ -1,14 +1,23 @@
 #pragma once
 
 #include "Module.h"
-#include <unordered_map>
+#include "ModuleScheduler.h"
+#include "JobSystem.h"
+#include "FrameArena.h"
+#include "FloatingOrigin.h"
+#include "Profiler.h"
 #include <memory>
-#include <typeindex>
 #include <vector>
 #include <chrono>
 
 namespace Daisy {
 
+struct TimestepSettings {
+    bool fixedTimestep = false;     // Off: every module steps once per frame with the frame delta
+    float simulationRate = 60.0f;   // Fixed ticks per second
+    uint32_t maxCatchUpSteps = 5;   // Backlog beyond this many ticks per frame is dropped
+};
+
 class Engine {
 public:
     Engine();
@@ -16,45 +25,114 @@ public:
     
     bool Initialize();
     void Update();
+    // Steps with the given delta instead of the measured one (replays, benchmarks)
+    void Update(float deltaTime);
     void Shutdown();
     
     template<ModuleType T, typename... Args>
     T* RegisterModule(Args&&... args) {
         auto module = std::make_unique<T>(std::forward<Args>(args)...);
         T* modulePtr = module.get();
+        module->m_engine = this;
+        module->m_jobSystem = &m_jobSystem;
+        module->m_frameArena = &m_frameArena;
+        module->m_typeId = ModuleTypeIdOf<T>();
         
-        std::type_index typeIndex(typeid(T));
-        m_modules[typeIndex] = std::move(module);
-        m_moduleOrder.push_back(typeIndex);
-        
+        AddModule(std::move(module));
         return modulePtr;
     }
     
     template<ModuleType T>
     T* GetModule() {
-        std::type_index typeIndex(typeid(T));
-        auto it = m_modules.find(typeIndex);
-        if (it != m_modules.end()) {
-            return static_cast<T*>(it->second.get());
-        }
-        return nullptr;
+        ModuleTypeId typeId = ModuleTypeIdOf<T>();
+        return typeId < m_moduleSlots.size() ? static_cast<T*>(m_moduleSlots[typeId]) : nullptr;
     }
     
     float GetDeltaTime() const { return m_deltaTime; }
+    
+    void SetTimestepSettings(const TimestepSettings& settings);
+    const TimestepSettings& GetTimestepSettings() const { return m_timestep; }
+    float GetFixedDeltaTime() const { return 1.0f / m_timestep.simulationRate; }
+    uint64_t GetSimulationTick() const { return m_simulationTick; }
+    
+    // Fraction of a fixed tick left in the accumulator, for blending the last
+    // two simulation states when rendering
+    float GetInterpolationAlpha() const { return m_interpolationAlpha; }
+    
+    // How long until enough time accumulates for the next fixed tick
+    std::chrono::nanoseconds GetTimeUntilNextTick() const;
+    
     bool IsRunning() const { return m_running; }
     void Stop() { m_running = false; }
     void RequestShutdown() { m_running = false; }
     
+    // Worker threads shared by the module scheduler and module jobs; 0 runs everything on the caller
+    void SetWorkerThreadCount(uint32_t count);
+    uint32_t GetWorkerThreadCount() const { return m_workerThreadCount; }
+    
+    JobSystem& GetJobSystem() { return m_jobSystem; }
+    
+    template<ModuleType T>
+    void SetModuleMemoryBudget(const MemoryBudget& budget) {
+        if (T* module = GetModule<T>()) {
+            module->GetMemoryResource().SetBudget(budget);
+            // Re-reserve a budget-sized region while the module has not used it yet
+            if (module->m_virtualMemory && module->m_virtualMemorySettings.reserveSize == 0) {
+                module->UseVirtualMemory(module->m_virtualMemorySettings);
+            }
+        }
+    }
+    
+    // Page size and NUMA node for a module's large arrays; call before Initialize
+    template<ModuleType T>
+    bool SetModuleVirtualMemory(const VirtualMemorySettings& settings) {
+        T* module = GetModule<T>();
+        return module && module->UseVirtualMemory(settings);
+    }
+    
+    // Usage of every module's memory resource, in registration order
+    std::vector<MemoryBudgetStats> GetModuleMemoryStats() const;
+    
+    // Scratch memory for the current frame, rewound at the end of every Update
+    FrameArena& GetFrameArena() { return m_frameArena; }
+    // Same, but allocations stay valid through the next frame as well
+    FrameArena& GetDoubleBufferedFrameArena() { return m_doubleBufferedFrameArena; }
+    
+    // Origin for float-precision positions; move it with the camera or player
+    // between Updates and modules rebase their local coordinates
+    FloatingOrigin& GetFloatingOrigin() { return m_floatingOrigin; }
+    
+    // Per-module and per-zone frame timings; zones only record in profiling builds
+    Profiler& GetProfiler() { return Profiler::GetInstance(); }
+    
 private:
+    void AddModule(std::unique_ptr<Module> module);
     void CalculateDeltaTime();
+    void RunFrame();
+    void StepModules();
+    void RebuildSchedule();
     
-    std::unordered_map<std::type_index, std::unique_ptr<Module>> m_modules;
-    std::vector<std::type_index> m_moduleOrder;
+    // Modules in registration order, plus a slot table indexed by ModuleTypeId
+    std::vector<std::unique_ptr<Module>> m_modules;
+    std::vector<Module*> m_moduleSlots;
+    
+    JobSystem m_jobSystem;
+    FrameArena m_frameArena{FrameArenaBuffering::Single};
+    FrameArena m_doubleBufferedFrameArena{FrameArenaBuffering::Double};
+    ModuleScheduler m_scheduler{m_jobSystem};
+    FloatingOrigin m_floatingOrigin;
+    uint32_t m_workerThreadCount = 0;
+    bool m_scheduleDirty = true;
     
     bool m_initialized = false;
     bool m_running = false;
     float m_deltaTime = 0.0f;
     
+    TimestepSettings m_timestep;
+    float m_accumulator = 0.0f;
+    float m_interpolationAlpha = 0.0f;
+    uint64_t m_simulationTick = 0;
+    
     std::chrono::high_resolution_clock::time_point m_lastFrameTime;
 };
 
@@ -0,0 +1,181 @@
+#pragma once
+
+#include "SimdMath.h"
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+// Cheaper replacements for std::sqrt, std::sin and std::cos in per-object
+// loops. Each call site picks its accuracy tier through the template argument;
+// the bounds below are what Benchmarks/FastMathBenchmark measures.
+namespace Daisy::FastMath {
+
+enum class Accuracy {
+    // The standard library, for anything that accumulates or is compared exactly
+    Exact,
+    // InverseSqrt: relative error < 3e-7 with SSE, exact in scalar builds.
+    // SinCos: absolute error < 1e-7 for |x| <= 8192, falling back to Exact beyond.
+    Fast,
+    // InverseSqrt: relative error < 4e-4 with SSE, < 2e-3 in scalar builds.
+    // SinCos: absolute error < 4e-4 for |x| <= 8192, falling back to Exact beyond.
+    Approximate
+};
+
+// Beyond this the range reduction loses bits and the standard library is used
+constexpr float SinCosRangeLimit = 8192.0f;
+
+namespace Detail {
+    // pi/2 split so that n * PiOverTwoHigh is exact for the quadrant counts in range
+    constexpr float TwoOverPi = 0.636619772367581343f;
+    constexpr float RoundingBias = 12582912.0f;
+    constexpr float PiOverTwoHigh = 1.5703125f;
+    constexpr float PiOverTwoMid = 4.837512969970703125e-4f;
+    constexpr float PiOverTwoLow = 7.54978995489188216e-8f;
+    
+    // Minimax polynomials on [-pi/4, pi/4]
+    constexpr float Sin1 = -1.6666654611e-1f;
+    constexpr float Sin2 = 8.3321608736e-3f;
+    constexpr float Sin3 = -1.9515295891e-4f;
+    constexpr float Cos1 = 4.166664568298827e-2f;
+    constexpr float Cos2 = -1.388731625493765e-3f;
+    constexpr float Cos3 = 2.443315711809948e-5f;
+    
+    template<Accuracy A>
+    inline void SinCosReduced(float r, float& sinR, float& cosR) {
+        float r2 = r * r;
+        if constexpr (A == Accuracy::Fast) {
+            sinR = r + r * r2 * (Sin1 + r2 * (Sin2 + r2 * Sin3));
+            cosR = 1.0f - 0.5f * r2 + r2 * r2 * (Cos1 + r2 * (Cos2 + r2 * Cos3));
+        } else {
+            // Taylor terms up to r^5 and r^4
+            sinR = r + r * r2 * (-1.0f / 6.0f + r2 * (1.0f / 120.0f));
+            cosR = 1.0f + r2 * (-0.5f + r2 * (1.0f / 24.0f));
+        }
+    }
+}
+
+// x must be positive and finite
+template<Accuracy A = Accuracy::Fast>
+inline float InverseSqrt(float x) {
+    if constexpr (A == Accuracy::Exact) {
+        return 1.0f / std::sqrt(x);
+    } else {
+#if defined(DAISY_SIMD_SSE41)
+        // 12-bit hardware estimate; one Newton-Raphson step roughly doubles the bits.
+        // Broadcasting avoids the false dependency rsqrtss has on its destination.
+        float estimate = _mm_cvtss_f32(_mm_rsqrt_ps(_mm_set1_ps(x)));
+        if constexpr (A == Accuracy::Fast) {
+            estimate = estimate * (1.5f - 0.5f * x * estimate * estimate);
+        }
+        return estimate;
+#else
+        // Without an estimate instruction the refinement steps cost more than a
+        // hardware square root, so only the Approximate tier takes the bit trick
+        if constexpr (A == Accuracy::Fast) {
+            return 1.0f / std::sqrt(x);
+        }
+        float estimate = std::bit_cast<float>(0x5F375A86u - (std::bit_cast<uint32_t>(x) >> 1));
+        return estimate * (1.5f - 0.5f * x * estimate * estimate);
+#endif
+    }
+}
+
+// Zero and negative inputs give zero
+template<Accuracy A = Accuracy::Fast>
+inline float Sqrt(float x) {
+    if constexpr (A == Accuracy::Exact) {
+        return std::sqrt(x);
+    } else {
+        return x > 0.0f ? x * InverseSqrt<A>(x) : 0.0f;
+    }
+}
+
+template<Accuracy A = Accuracy::Fast>
+inline void SinCos(float x, float& sin, float& cos) {
+    if (A == Accuracy::Exact || !(std::fabs(x) <= SinCosRangeLimit)) {
+        sin = std::sin(x);
+        cos = std::cos(x);
+        return;
+    }
+    
+    // x = n * pi/2 + r with |r| <= pi/4; the low two bits of n pick the quadrant.
+    // Adding and removing 1.5 * 2^23 rounds to nearest even, as the SIMD batch does.
+    float fn = (x * Detail::TwoOverPi + Detail::RoundingBias) - Detail::RoundingBias;
+    int32_t n = static_cast<int32_t>(fn);
+    float r = ((x - fn * Detail::PiOverTwoHigh) - fn * Detail::PiOverTwoMid) - fn * Detail::PiOverTwoLow;
+    
+    float sinR, cosR;
+    Detail::SinCosReduced<A>(r, sinR, cosR);
+    
+    // Random angles make the quadrant unpredictable, so swap and flip signs with bit masks
+    uint32_t quadrant = static_cast<uint32_t>(n);
+    uint32_t sinBits = std::bit_cast<uint32_t>(sinR);
+    uint32_t cosBits = std::bit_cast<uint32_t>(cosR);
+    uint32_t swap = (sinBits ^ cosBits) & (0u - (quadrant & 1));
+    sin = std::bit_cast<float>(sinBits ^ swap ^ ((quadrant & 2) << 30));
+    cos = std::bit_cast<float>(cosBits ^ swap ^ (((quadrant + 1) & 2) << 30));
+}
+
+template<Accuracy A = Accuracy::Fast>
+inline float Sin(float x) {
+    float sin, cos;
+    SinCos<A>(x, sin, cos);
+    return sin;
+}
+
+template<Accuracy A = Accuracy::Fast>
+inline float Cos(float x) {
+    float sin, cos;
+    SinCos<A>(x, sin, cos);
+    return cos;
+}
+
+// Zero-length input gives a zero vector, as Vector3::Normalized does
+template<Accuracy A = Accuracy::Fast>
+inline Vector3 Normalize(const Vector3& v) {
+    if constexpr (A == Accuracy::Exact) {
+        return v.Normalized();
+    }
+    float lengthSquared = v.LengthSquared();
+    return lengthSquared > 0.0f ? v * InverseSqrt<A>(lengthSquared) : Vector3();
+}
+
+// Zero-length input gives the identity, as Quaternion::Normalized does
+template<Accuracy A = Accuracy::Fast>
+inline Quaternion Normalize(const Quaternion& q) {
+    if constexpr (A == Accuracy::Exact) {
+        return q.Normalized();
+    }
+    float lengthSquared = q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w;
+    if (!(lengthSquared > 0.0f)) {
+        return Quaternion();
+    }
+    float inverseLength = InverseSqrt<A>(lengthSquared);
+    return Quaternion(q.x * inverseLength, q.y * inverseLength, q.z * inverseLength, q.w * inverseLength);
+}
+
+// For call sites that want one accuracy tier throughout. It is not reliably
+// cheaper than Quaternion::FromAxisAngle: FastMathBenchmark has measured it
+// anywhere from no faster to modestly faster depending on the build.
+template<Accuracy A = Accuracy::Fast>
+inline Quaternion FromAxisAngle(const Vector3& axis, float angle) {
+    if constexpr (A == Accuracy::Exact) {
+        return Quaternion::FromAxisAngle(axis, angle);
+    }
+    float sin, cos;
+    SinCos<A>(angle * 0.5f, sin, cos);
+    Vector3 normalizedAxis = Normalize<A>(axis) * sin;
+    return Quaternion(normalizedAxis.x, normalizedAxis.y, normalizedAxis.z, cos);
+}
+
+// Batch versions, 8 (AVX2) or 4 (SSE4.1) lanes at a time with the same error
+// bounds as the single-value functions. out may alias the input.
+template<Accuracy A = Accuracy::Fast>
+void InverseSqrt(const float* values, float* out, size_t count);
+template<Accuracy A = Accuracy::Fast>
+void SinCos(const float* angles, float* sin, float* cos, size_t count);
+// Normalizes in place; zero-length vectors stay zero
+template<Accuracy A = Accuracy::Fast>
+void Normalize(Simd::Vector3Stream vectors, size_t count);
+
+}
\ No newline at end of file
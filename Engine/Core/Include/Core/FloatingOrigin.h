@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Math.h"
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace Daisy {
+
+// Gets the previous and the new origin; local positions shift by previous - current
+using RebaseCallback = std::function<void(const DVector3& previous, const DVector3& current)>;
+
+// Reference point for systems that keep float positions (audio, AI, anything
+// handed to float-only math). Their local coordinates are world positions
+// minus the origin, and the origin jumps to the observer whenever the observer
+// strays past the rebase distance, so local values stay small and precise
+// anywhere in the world. Not thread-safe: update it between Engine::Update
+// calls, when no module is running.
+class FloatingOrigin {
+public:
+    // Within 8 km of the origin a float position still resolves a millimetre
+    static constexpr double DefaultRebaseDistance = 8192.0;
+    
+    const DVector3& GetOrigin() const { return m_origin; }
+    Vector3 ToLocal(const DVector3& world) const { return (world - m_origin).ToVector3(); }
+    DVector3 ToWorld(const Vector3& local) const { return m_origin + DVector3(local); }
+    // For rebase listeners: the same point, local to current instead of previous
+    static Vector3 Rebase(const Vector3& local, const DVector3& previous, const DVector3& current) {
+        return ((previous - current) + DVector3(local)).ToVector3();
+    }
+    
+    void SetRebaseDistance(double distance) { m_rebaseDistance = distance; }
+    double GetRebaseDistance() const { return m_rebaseDistance; }
+    
+    // Rebases onto the observer once it is further than the rebase distance;
+    // returns true if it did
+    bool Update(const DVector3& observer);
+    // Rebases unconditionally
+    void SetOrigin(const DVector3& origin);
+    uint64_t GetRebaseCount() const { return m_rebaseCount; }
+    
+    // Called after every rebase; returns an ID for RemoveRebaseListener
+    uint32_t AddRebaseListener(RebaseCallback callback);
+    void RemoveRebaseListener(uint32_t id);
+    
+private:
+    DVector3 m_origin;
+    double m_rebaseDistance = DefaultRebaseDistance;
+    uint64_t m_rebaseCount = 0;
+    
+    std::vector<std::pair<uint32_t, RebaseCallback>> m_listeners;
+    uint32_t m_nextListenerId = 1;
+};
+
+}
\ No newline at end of file
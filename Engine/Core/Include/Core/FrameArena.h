@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Daisy {
+
+// Bump allocator over a list of blocks. Reset rewinds to the first block and
+// keeps every block, so after a few frames it settles at the high-water mark
+// and allocates nothing from the system.
+class LinearArena {
+public:
+    explicit LinearArena(size_t blockSize = 256 * 1024);
+    ~LinearArena();
+    
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+    
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        uintptr_t aligned = (m_cursor + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+        if (aligned + size <= m_end && aligned >= m_cursor) {
+            m_cursor = aligned + size;
+            return reinterpret_cast<void*>(aligned);
+        }
+        return AllocateSlow(size, alignment);
+    }
+    
+    void Reset();
+    
+    size_t GetBytesUsed() const;
+    size_t GetCapacity() const;
+    
+private:
+    struct Block {
+        std::byte* data;
+        size_t size;
+    };
+    
+    void* AllocateSlow(size_t size, size_t alignment);
+    void UseBlock(size_t index);
+    
+    std::vector<Block> m_blocks;
+    size_t m_currentBlock = 0;
+    size_t m_usedInFullBlocks = 0;
+    uintptr_t m_cursor = 0;
+    uintptr_t m_end = 0;
+    size_t m_blockSize;
+};
+
+enum class FrameArenaBuffering {
+    Single,     // Memory is valid until the end of the frame it was allocated in
+    Double      // Memory also survives the following frame
+};
+
+// Per-thread linear arenas for frame temporaries. Each thread allocates from
+// its own arena without locking; Reset, called by the Engine at the end of
+// every frame, rewinds all of them at once and must not race with allocations.
+// When a thread exits, its arena passes to the next thread that registers, or
+// is freed by Reset once the memory it handed out has expired.
+class FrameArena {
+public:
+    explicit FrameArena(FrameArenaBuffering buffering = FrameArenaBuffering::Single, size_t blockSize = 256 * 1024);
+    ~FrameArena();
+    
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+    
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        return GetThreadArena().buffers[m_frameParity].Allocate(size, alignment);
+    }
+    
+    // Uninitialized storage for count objects; nothing is ever destroyed
+    template<typename T>
+    T* AllocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "Frame memory is released without running destructors");
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    }
+    
+    // For std::pmr containers; allocates from the arena of whichever thread
+    // calls it, so a container may be filled on a different thread than the one
+    // that created it. Deallocation is a no-op.
+    std::pmr::memory_resource* GetResource() { return &m_resource; }
+    
+    void Reset();
+    
+    FrameArenaBuffering GetBuffering() const { return m_buffering; }
+    // Bytes handed out during the last completed frame, across all threads
+    size_t GetLastFrameBytes() const { return m_lastFrameBytes.load(std::memory_order_relaxed); }
+    size_t GetPeakFrameBytes() const { return m_peakFrameBytes.load(std::memory_order_relaxed); }
+    size_t GetCapacity() const;
+    
+private:
+    struct ThreadArena {
+        explicit ThreadArena(size_t blockSize) : buffers{LinearArena(blockSize), LinearArena(blockSize)} {}
+        
+        LinearArena buffers[2];
+        std::thread::id thread;
+        // Set by the owning thread as it exits; shared so it outlives either side
+        std::shared_ptr<std::atomic<bool>> retired = std::make_shared<std::atomic<bool>>(false);
+        uint32_t resetsSinceRetired = 0;    // Guarded by m_threadsMutex
+    };
+    
+    class Resource : public std::pmr::memory_resource {
+    public:
+        explicit Resource(FrameArena& arena) : m_arena(arena) {}
+        
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override { return m_arena.Allocate(bytes, alignment); }
+        void do_deallocate(void*, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+        
+        FrameArena& m_arena;
+    };
+    
+    ThreadArena& GetThreadArena();
+    ThreadArena& RegisterThread();
+    
+    // Distinguishes arenas in the per-thread cache, even one reusing a freed address
+    const uint64_t m_id;
+    FrameArenaBuffering m_buffering;
+    size_t m_blockSize;
+    uint32_t m_frameParity = 0;
+    Resource m_resource{*this};
+    
+    mutable std::mutex m_threadsMutex;
+    std::vector<std::unique_ptr<ThreadArena>> m_threads;
+    
+    std::atomic<size_t> m_lastFrameBytes{0};
+    std::atomic<size_t> m_peakFrameBytes{0};
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace Daisy {
+
+struct Job;
+
+class JobHandle {
+public:
+    JobHandle() = default;
+    
+    bool IsValid() const { return m_job != nullptr; }
+    bool IsComplete() const;
+    
+private:
+    friend class JobSystem;
+    explicit JobHandle(std::shared_ptr<Job> job) : m_job(std::move(job)) {}
+    
+    std::shared_ptr<Job> m_job;
+};
+
+// Work-stealing job system: each worker owns a deque it pushes and pops at the
+// back, idle workers steal from the front of the others. Threads that are not
+// workers submit through a shared queue and help execute jobs while waiting.
+class JobSystem {
+public:
+    JobSystem() = default;
+    ~JobSystem();
+    
+    void Initialize(uint32_t workerCount);
+    void Shutdown();
+    
+    JobHandle Schedule(std::function<void()> work, std::span<const JobHandle> dependencies = {});
+    
+    // Splits [begin, end) into chunks of grainSize (0 picks four per thread,
+    // counting the caller, so uneven chunks still balance) and calls
+    // body(chunkBegin, chunkEnd) for each; the handle completes with the last chunk
+    JobHandle ParallelFor(size_t begin, size_t end, size_t grainSize,
+                          std::function<void(size_t, size_t)> body,
+                          std::span<const JobHandle> dependencies = {});
+    
+    // Executes other jobs on the calling thread until the handle completes,
+    // sleeping while there is nothing to run
+    void Wait(const JobHandle& handle);
+    void Wait(std::span<const JobHandle> handles);
+    
+    // Runs one queued job on the calling thread, returns false if none was found
+    bool RunPendingJob();
+    
+    uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+    
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::shared_ptr<Job>> jobs;
+    };
+    
+    void WorkerLoop(uint32_t workerIndex);
+    void Enqueue(std::shared_ptr<Job> job);
+    void Execute(const std::shared_ptr<Job>& job);
+    void Finish(const std::shared_ptr<Job>& job);
+    void AddDependency(const std::shared_ptr<Job>& job, const JobHandle& dependency);
+    void SpawnChild(std::function<void()> work);
+    void WakeWaiters();
+    std::shared_ptr<Job> FindJob(int workerIndex);
+    int CurrentWorkerIndex() const;
+    
+    std::vector<std::thread> m_workers;
+    std::vector<std::unique_ptr<WorkQueue>> m_workerQueues;
+    WorkQueue m_sharedQueue;
+    
+    std::atomic<int32_t> m_queuedJobs{0};
+    std::atomic<uint32_t> m_sleepingWorkers{0};
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCondition;
+    std::atomic<bool> m_stopping{false};
+    
+    // Threads blocked in Wait, woken when a job finishes or is queued
+    std::atomic<uint32_t> m_waitingThreads{0};
+    std::mutex m_waitMutex;
+    std::condition_variable m_waitCondition;
+};
+
+}
\ No newline at end of file
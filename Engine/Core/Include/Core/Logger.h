@@ -5,6 +5,16 @@
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+#include <array>
+#include <cstdint>
+#include <charconv>
+#include <concepts>
+#include <string_view>
+#include <type_traits>
 
 namespace Daisy {
 
@@ -15,84 +25,386 @@ enum class LogLevel {
     Error = 3
 };
 
+// Each channel has its own level, so one subsystem can log at Debug without the rest
+enum class LogChannel : uint8_t {
+    General = 0,
+    Platform,
+    Physics,
+    Render,
+    Audio,
+    AI,
+    Net,
+    Streamer,
+    Script,
+    Editor,
+    Count
+};
+
+constexpr size_t LogChannelCount = static_cast<size_t>(LogChannel::Count);
+
+enum class LogOverflowPolicy {
+    Drop,   // Discard the record and count it
+    Block   // Wait for the writer thread to make room
+};
+
+struct LoggerSettings {
+    // Callers only enqueue; a background thread writes in batches
+    bool async = true;
+    size_t queueCapacity = 8192;    // Rounded up to a power of two
+    LogOverflowPolicy overflowPolicy = LogOverflowPolicy::Drop;
+};
+
+// Placeholder forms: {} and {:spec}, spec = [.precision][type] with type one of
+// f, e, g (floating point), d, x (integers). {{ and }} are literal braces.
+struct LogFormatSpec {
+    int precision = -1;
+    char type = '\0';
+};
+
+// Parses the placeholder starting at format[position] == '{' and moves position
+// past its closing brace; returns false on a malformed placeholder
+constexpr bool ParseLogPlaceholder(std::string_view format, size_t& position, LogFormatSpec& spec) {
+    spec = LogFormatSpec{};
+    size_t i = position + 1;
+    
+    if (i < format.size() && format[i] == ':') {
+        ++i;
+        if (i < format.size() && format[i] == '.') {
+            ++i;
+            if (i >= format.size() || format[i] < '0' || format[i] > '9') {
+                return false;
+            }
+            spec.precision = 0;
+            while (i < format.size() && format[i] >= '0' && format[i] <= '9') {
+                spec.precision = spec.precision * 10 + (format[i] - '0');
+                ++i;
+            }
+        }
+        if (i < format.size() && format[i] != '}') {
+            char type = format[i];
+            if (type != 'f' && type != 'e' && type != 'g' && type != 'd' && type != 'x') {
+                return false;
+            }
+            spec.type = type;
+            ++i;
+        }
+    }
+    
+    if (i >= format.size() || format[i] != '}') {
+        return false;
+    }
+    
+    position = i + 1;
+    return true;
+}
+
+// Number of placeholders, or -1 if the format string is malformed
+constexpr int CountLogPlaceholders(std::string_view format) {
+    int count = 0;
+    size_t i = 0;
+    while (i < format.size()) {
+        if (format[i] == '{') {
+            if (i + 1 < format.size() && format[i + 1] == '{') {
+                i += 2;
+                continue;
+            }
+            LogFormatSpec spec;
+            if (!ParseLogPlaceholder(format, i, spec)) {
+                return -1;
+            }
+            ++count;
+        } else if (format[i] == '}') {
+            if (i + 1 >= format.size() || format[i + 1] != '}') {
+                return -1;
+            }
+            i += 2;
+        } else {
+            ++i;
+        }
+    }
+    return count;
+}
+
+// Deliberately not constexpr: reaching it during constant evaluation is the compile error
+inline void InvalidLogFormatString() {}
+
+// Format string validated at compile time against the argument count
+template<typename... Args>
+class LogFormatString {
+public:
+    template<typename T>
+        requires std::convertible_to<const T&, std::string_view>
+    consteval LogFormatString(const T& format) : m_format(format) {
+        if (CountLogPlaceholders(m_format) != static_cast<int>(sizeof...(Args))) {
+            InvalidLogFormatString();
+        }
+    }
+    
+    std::string_view Get() const { return m_format; }
+    
+private:
+    std::string_view m_format;
+};
+
+enum class LogArgType : uint8_t {
+    Bool = 1,
+    Char,
+    Integer,
+    Unsigned,
+    Float,
+    String,
+    Pointer
+};
+
+// Argument normalized to one of a few value types, so formatting and binary
+// encoding are plain switches rather than templates
+struct LogArg {
+    LogArgType type = LogArgType::Integer;
+    union {
+        bool boolean;
+        char character;
+        long long integer;
+        unsigned long long unsignedInteger = 0;
+        double floating;
+        const void* pointer;
+    };
+    std::string_view text;
+    std::string storage;    // Only used by types formatted through operator<<
+    
+    std::string_view GetText() const { return storage.empty() ? text : std::string_view(storage); }
+};
+
+// Formats into a per-thread buffer; the view stays valid until the thread formats again
+std::string_view FormatLogMessage(std::string_view format, const LogArg* args, size_t count);
+
+template<typename T>
+concept LogStreamable = requires(std::ostream& stream, const T& value) { stream << value; };
+
+template<typename T>
+LogArg MakeLogArg(const T& value) {
+    LogArg arg;
+    
+    if constexpr (std::is_same_v<T, bool>) {
+        arg.type = LogArgType::Bool;
+        arg.boolean = value;
+    } else if constexpr (std::is_same_v<T, char>) {
+        arg.type = LogArgType::Char;
+        arg.character = value;
+    } else if constexpr (std::is_enum_v<T> && !LogStreamable<T>) {
+        arg.type = LogArgType::Integer;
+        arg.integer = static_cast<long long>(value);
+    } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        arg.type = LogArgType::Integer;
+        arg.integer = value;
+    } else if constexpr (std::is_integral_v<T>) {
+        arg.type = LogArgType::Unsigned;
+        arg.unsignedInteger = value;
+    } else if constexpr (std::is_floating_point_v<T>) {
+        arg.type = LogArgType::Float;
+        arg.floating = static_cast<double>(value);
+    } else if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*>) {
+        arg.type = LogArgType::String;
+        arg.text = value ? std::string_view(value) : std::string_view("(null)");
+    } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+        arg.type = LogArgType::String;
+        arg.text = std::string_view(value);
+    } else if constexpr (std::is_pointer_v<T>) {
+        arg.type = LogArgType::Pointer;
+        arg.pointer = value;
+    } else {
+        static_assert(LogStreamable<T>, "Type cannot be logged");
+        // Slow path for types that only provide operator<<
+        std::ostringstream stream;
+        stream << value;
+        arg.type = LogArgType::String;
+        arg.storage = stream.str();
+    }
+    
+    return arg;
+}
+
+class LogQueue;
+class BinaryLogSink;
+
 class Logger {
 public:
     static Logger& GetInstance();
     
-    void Initialize(const std::string& logFile = "daisy_engine.log");
+    void Initialize(const std::string& logFile = "daisy_engine.log", const LoggerSettings& settings = {});
+    // Sets every channel; use SetChannelLevel afterwards for targeted diagnostics
     void SetLogLevel(LogLevel level);
+    void SetChannelLevel(LogChannel channel, LogLevel level);
+    LogLevel GetChannelLevel(LogChannel channel) const {
+        return m_channelLevels[static_cast<size_t>(channel)].load(std::memory_order_relaxed);
+    }
+    // Applies a spec such as "Streamer=Debug,Physics=Warning"; a bare level sets
+    // every channel. Returns false, leaving levels unchanged, if any entry is invalid.
+    bool ConfigureChannels(std::string_view spec);
+    // Accept the names from GetChannelName and GetLogLevelString, case-insensitively
+    static bool ParseChannel(std::string_view name, LogChannel& channel);
+    static bool ParseLogLevel(std::string_view name, LogLevel& level);
+    
+    // Blocks until every record logged before the call has been written
+    void Flush();
+    // Drains the queue and stops the writer thread
+    void Shutdown();
+    
+    uint64_t GetDroppedCount() const { return m_droppedRecords.load(std::memory_order_relaxed); }
+    
+    // Binary sink for levels too chatty for text; decode offline with DaisyLogDecoder
+    bool OpenBinaryLog(const std::string& path, LogLevel level = LogLevel::Debug);
+    void CloseBinaryLog();
+    
+    // True if the text log or the binary log takes this level on the channel
+    bool IsEnabled(LogChannel channel, LogLevel level) const {
+        return level >= m_enabledLevels[static_cast<size_t>(channel)].load(std::memory_order_relaxed);
+    }
+    bool IsEnabled(LogLevel level) const { return IsEnabled(LogChannel::General, level); }
+    
+    static std::string GetLogLevelString(LogLevel level);
+    static const char* GetChannelName(LogChannel channel);
     
-    void Debug(const std::string& message);
-    void Info(const std::string& message);
-    void Warning(const std::string& message);
-    void Error(const std::string& message);
+    // Messages without arguments are written verbatim
+    void Debug(std::string_view message);
+    void Info(std::string_view message);
+    void Warning(std::string_view message);
+    void Error(std::string_view message);
+    
+    void Debug(LogChannel channel, std::string_view message);
+    void Info(LogChannel channel, std::string_view message);
+    void Warning(LogChannel channel, std::string_view message);
+    void Error(LogChannel channel, std::string_view message);
     
     template<typename... Args>
-    void Debug(const std::string& format, Args&&... args) {
-        if (m_logLevel <= LogLevel::Debug) {
-            Log(LogLevel::Debug, FormatString(format, std::forward<Args>(args)...));
-        }
+    void Debug(LogFormatString<std::type_identity_t<Args>...> format, const Args&... args) {
+        LogFormatted(LogChannel::General, LogLevel::Debug, format.Get(), args...);
     }
     
     template<typename... Args>
-    void Info(const std::string& format, Args&&... args) {
-        if (m_logLevel <= LogLevel::Info) {
-            Log(LogLevel::Info, FormatString(format, std::forward<Args>(args)...));
-        }
+    void Debug(LogChannel channel, LogFormatString<std::type_identity_t<Args>...> format, const Args&... args) {
+        LogFormatted(channel, LogLevel::Debug, format.Get(), args...);
     }
     
     template<typename... Args>
-    void Warning(const std::string& format, Args&&... args) {
-        if (m_logLevel <= LogLevel::Warning) {
-            Log(LogLevel::Warning, FormatString(format, std::forward<Args>(args)...));
-        }
+    void Info(LogFormatString<std::type_identity_t<Args>...> format, const Args&... args) {
+        LogFormatted(LogChannel::General, LogLevel::Info, format.Get(), args...);
     }
     
     template<typename... Args>
-    void Error(const std::string& format, Args&&... args) {
-        if (m_logLevel <= LogLevel::Error) {
-            Log(LogLevel::Error, FormatString(format, std::forward<Args>(args)...));
-        }
+    void Info(LogChannel channel, LogFormatString<std::type_identity_t<Args>...> format, const Args&... args) {
+        LogFormatted(channel, LogLevel::Info, format.Get(), args...);
     }
     
-private:
-    Logger() = default;
+    template<typename... Args>
+    void Warning(LogFormatString<std::type_identity_t<Args>...> format, const Args&... args) {
+        LogFormatted(LogChannel::General, LogLevel::Warning, format.Get(), args...);
+    }
     
-    void Log(LogLevel level, const std::string& message);
-    std::string GetTimestamp();
-    std::string GetLogLevelString(LogLevel level);
+    template<typename... Args>
+    void Warning(LogChannel channel, LogFormatString<std::type_identity_t<Args>...> format, const Args&... args) {
+        LogFormatted(channel, LogLevel::Warning, format.Get(), args...);
+    }
     
     template<typename... Args>
-    std::string FormatString(const std::string& format, Args&&... args) {
-        std::ostringstream oss;
-        FormatStringImpl(oss, format, std::forward<Args>(args)...);
-        return oss.str();
-    }
-    
-    template<typename T, typename... Args>
-    void FormatStringImpl(std::ostringstream& oss, const std::string& format, T&& value, Args&&... args) {
-        size_t pos = format.find("{}");
-        if (pos != std::string::npos) {
-            oss << format.substr(0, pos) << value;
-            FormatStringImpl(oss, format.substr(pos + 2), std::forward<Args>(args)...);
-        } else {
-            oss << format;
-        }
+    void Error(LogFormatString<std::type_identity_t<Args>...> format, const Args&... args) {
+        LogFormatted(LogChannel::General, LogLevel::Error, format.Get(), args...);
+    }
+    
+    template<typename... Args>
+    void Error(LogChannel channel, LogFormatString<std::type_identity_t<Args>...> format, const Args&... args) {
+        LogFormatted(channel, LogLevel::Error, format.Get(), args...);
     }
     
-    void FormatStringImpl(std::ostringstream& oss, const std::string& format) {
-        oss << format;
+private:
+    Logger();
+    ~Logger();
+    
+    template<typename... Args>
+    void LogFormatted(LogChannel channel, LogLevel level, std::string_view format, const Args&... args) {
+        if (!IsEnabled(channel, level)) {
+            return;
+        }
+        
+        std::array<LogArg, sizeof...(Args)> packed{MakeLogArg(args)...};
+        if (m_binaryEnabled.load(std::memory_order_relaxed) && level >= m_binaryLevel.load(std::memory_order_relaxed)) {
+            WriteBinary(channel, level, format, packed.data(), packed.size());
+        }
+        if (level >= GetChannelLevel(channel)) {
+            Log(channel, level, FormatLogMessage(format, packed.data(), packed.size()));
+        }
     }
     
+    void LogMessage(LogChannel channel, LogLevel level, std::string_view message);
+    void WriteBinary(LogChannel channel, LogLevel level, std::string_view format, const LogArg* args, size_t count);
+    void UpdateEnabledLevels();
+    
+    void Log(LogChannel channel, LogLevel level, std::string_view message);
+    void WriteSync(LogChannel channel, LogLevel level, std::string_view message);
+    void WriterLoop();
+    // Writes whatever is left in the queue, on the calling thread
+    void DrainQueue();
+    void AppendRecord(std::string& output, LogChannel channel, LogLevel level,
+                      std::chrono::system_clock::time_point time, std::string_view message);
+    void WriteOutput(const std::string& output);
+    std::string GetTimestamp(std::chrono::system_clock::time_point time);
+    
     std::unique_ptr<std::ofstream> m_logFile;
-    LogLevel m_logLevel = LogLevel::Info;
+    // Text level per channel, and the lower of it and the binary level so the
+    // enabled check is a single relaxed load
+    std::array<std::atomic<LogLevel>, LogChannelCount> m_channelLevels;
+    std::array<std::atomic<LogLevel>, LogChannelCount> m_enabledLevels;
+    std::mutex m_levelMutex;
+    
+    std::unique_ptr<BinaryLogSink> m_binarySink;
+    std::atomic<bool> m_binaryEnabled{false};
+    std::atomic<LogLevel> m_binaryLevel{LogLevel::Debug};
     std::mutex m_mutex;
+    
+    // Async backend
+    std::unique_ptr<LogQueue> m_queue;
+    LogOverflowPolicy m_overflowPolicy = LogOverflowPolicy::Drop;
+    std::thread m_writerThread;
+    std::atomic<bool> m_async{false};
+    std::atomic<bool> m_stopping{false};
+    std::atomic<uint64_t> m_enqueuedRecords{0};
+    std::atomic<uint64_t> m_writtenRecords{0};
+    std::atomic<uint64_t> m_droppedRecords{0};
+    std::atomic<uint64_t> m_flushTarget{0};
+    std::mutex m_writerMutex;
+    std::condition_variable m_writerCondition;
+    std::condition_variable m_flushCondition;
+    
+    // Timestamp prefix cache, guarded by m_mutex
+    int64_t m_cachedSecond = -1;
+    std::string m_cachedTimestamp;
 };
 
 }
 
 #define DAISY_LOG Daisy::Logger::GetInstance()
-#define DAISY_DEBUG(...) DAISY_LOG.Debug(__VA_ARGS__)
-#define DAISY_INFO(...) DAISY_LOG.Info(__VA_ARGS__)
-#define DAISY_WARNING(...) DAISY_LOG.Warning(__VA_ARGS__)
-#define DAISY_ERROR(...) DAISY_LOG.Error(__VA_ARGS__)
\ No newline at end of file
+
+// Arguments are not evaluated when the level is disabled
+#define DAISY_LOG_IF_ENABLED(level, method, ...) \
+    do { \
+        if (DAISY_LOG.IsEnabled(level)) { \
+            DAISY_LOG.method(__VA_ARGS__); \
+        } \
+    } while (0)
+    
+#define DAISY_DEBUG(...) DAISY_LOG_IF_ENABLED(Daisy::LogLevel::Debug, Debug, __VA_ARGS__)
+#define DAISY_INFO(...) DAISY_LOG_IF_ENABLED(Daisy::LogLevel::Info, Info, __VA_ARGS__)
+#define DAISY_WARNING(...) DAISY_LOG_IF_ENABLED(Daisy::LogLevel::Warning, Warning, __VA_ARGS__)
+#define DAISY_ERROR(...) DAISY_LOG_IF_ENABLED(Daisy::LogLevel::Error, Error, __VA_ARGS__)
+
+#define DAISY_CHANNEL_LOG_IF_ENABLED(channel, level, method, ...) \
+    do { \
+        if (DAISY_LOG.IsEnabled(Daisy::LogChannel::channel, level)) { \
+            DAISY_LOG.method(Daisy::LogChannel::channel, __VA_ARGS__); \
+        } \
+    } while (0)
+    
+// Channel is the bare enumerator name, e.g. DAISY_CHANNEL_DEBUG(Streamer, "Loading chunk {}", id)
+#define DAISY_CHANNEL_DEBUG(channel, ...) DAISY_CHANNEL_LOG_IF_ENABLED(channel, Daisy::LogLevel::Debug, Debug, __VA_ARGS__)
+#define DAISY_CHANNEL_INFO(channel, ...) DAISY_CHANNEL_LOG_IF_ENABLED(channel, Daisy::LogLevel::Info, Info, __VA_ARGS__)
+#define DAISY_CHANNEL_WARNING(channel, ...) DAISY_CHANNEL_LOG_IF_ENABLED(channel, Daisy::LogLevel::Warning, Warning, __VA_ARGS__)
+#define DAISY_CHANNEL_ERROR(channel, ...) DAISY_CHANNEL_LOG_IF_ENABLED(channel, Daisy::LogLevel::Error, Error, __VA_ARGS__)
\ No newline at end of file
@@ -32,7 +32,35 @@ struct Vector3 {
     Vector3 Normalized() const { float len = Length(); return len > 0 ? *this / len : Vector3(); }
 };
 
-struct Vector4 {
+// World-space position for planetary and larger scenes. A float Vector3 is
+// down to half-metre steps at Earth's radius; a double still resolves a
+// fraction of a millimetre at 1e12 m. Store absolute positions as DVector3 and
+// subtract before converting, so the float math only sees small offsets.
+struct DVector3 {
+    double x, y, z;
+    
+    DVector3() : x(0), y(0), z(0) {}
+    DVector3(double x, double y, double z) : x(x), y(y), z(z) {}
+    // Widening is exact, so this one is implicit; narrowing goes through ToVector3
+    DVector3(const Vector3& v) : x(v.x), y(v.y), z(v.z) {}
+    
+    DVector3 operator+(const DVector3& other) const { return {x + other.x, y + other.y, z + other.z}; }
+    DVector3 operator-(const DVector3& other) const { return {x - other.x, y - other.y, z - other.z}; }
+    DVector3 operator*(double scalar) const { return {x * scalar, y * scalar, z * scalar}; }
+    DVector3 operator/(double scalar) const { return {x / scalar, y / scalar, z / scalar}; }
+    bool operator==(const DVector3& other) const { return x == other.x && y == other.y && z == other.z; }
+    
+    double Dot(const DVector3& other) const { return x * other.x + y * other.y + z * other.z; }
+    double Length() const { return std::sqrt(x * x + y * y + z * z); }
+    double LengthSquared() const { return x * x + y * y + z * z; }
+    DVector3 Normalized() const { double len = Length(); return len > 0 ? *this / len : DVector3(); }
+    
+    Vector3 ToVector3() const { return Vector3(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)); }
+};
+
+// Vector4, Matrix4 and Quaternion are 16-byte aligned for the SIMD kernels in
+// SimdMath.h; Vector3 stays packed so vertex and body layouts do not grow
+struct alignas(16) Vector4 {
     float x, y, z, w;
     
     Vector4() : x(0), y(0), z(0), w(0) {}
@@ -40,7 +68,7 @@ struct Vector4 {
     Vector4(const Vector3& v3, float w) : x(v3.x), y(v3.y), z(v3.z), w(w) {}
 };
 
-struct Matrix4 {
+struct alignas(16) Matrix4 {
     float m[16];
     
     Matrix4() { Identity(); }
@@ -60,7 +88,7 @@ struct Matrix4 {
     Vector4 operator*(const Vector4& vec) const;
 };
 
-struct Quaternion {
+struct alignas(16) Quaternion {
     float x, y, z, w;
     
     Quaternion() : x(0), y(0), z(0), w(1) {}
@@ -1,86 +1,399 @@
 #pragma once
 
 #include <memory>
-#include <unordered_map>
+#include <string>
+#include <string_view>
 #include <mutex>
 #include <atomic>
-#include <queue>
+#include <array>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
 #include <vector>
 
+// Keyed on DAISY_RELEASE like the profiler; DAISY_TRACK_MEMORY keeps tracking
+// on in release configurations such as soak-test builds
+#if defined(DAISY_TRACK_MEMORY) || !defined(DAISY_RELEASE)
+#define DAISY_MEMORY_TRACKING_ENABLED 1
+#else
+#define DAISY_MEMORY_TRACKING_ENABLED 0
+#endif
+
 namespace Daisy {
 
+using MemoryTag = uint16_t;
+
+// Allocations made outside any MemoryTagScope
+constexpr MemoryTag GeneralMemoryTag = 0;
+
+struct MemoryTrackerSettings {
+    // Record call site and tag for roughly one allocation per this many bytes;
+    // 0 records every allocation. Global totals are always exact.
+    size_t sampleInterval = 0;
+    // Live sampled allocations each thread's slab keeps, rounded up to 1024;
+    // past it, samples are dropped. A new thread takes over an exited thread's
+    // slab along with whatever it left live.
+    size_t maxTrackedAllocations = 1 << 16;
+};
+
+// Per-tag figures come from sampled allocations, scaled by their sample weight
+struct MemoryTagStats {
+    std::string name;
+    size_t currentBytes = 0;
+    size_t peakBytes = 0;
+    uint64_t liveAllocations = 0;
+    uint64_t totalAllocations = 0;
+};
+
+struct MemoryCallSiteStats {
+    const char* file = nullptr;
+    int line = 0;
+    MemoryTag tag = GeneralMemoryTag;
+    uint64_t liveAllocations = 0;   // Sampled allocations still live
+    size_t estimatedBytes = 0;
+};
+
+struct MemorySampleRecord;
+struct MemoryThreadSamples;
+
+// What RecordAllocation decided for one allocation; RecordDeallocation needs it back
+struct MemorySample {
+    MemorySampleRecord* record = nullptr;  // Null when the allocation was not sampled
+    size_t weight = 0;
+    MemoryTag tag = GeneralMemoryTag;
+};
+
+// Allocation tracker for DAISY_NEW/DAISY_DELETE. Recording is lock-free: global
+// counters are atomics, and each thread records its sampled allocations in its
+// own slab, which reports merge so leaks can be grouped by call site. A free
+// on any thread only marks the allocating thread's record.
 class MemoryTracker {
 public:
+    static constexpr MemoryTag MaxTags = 64;
+    
     static MemoryTracker& GetInstance();
     
-    void RecordAllocation(void* ptr, size_t size, const char* file, int line);
-    void RecordDeallocation(void* ptr);
+    // Call before other threads start allocating
+    void Configure(const MemoryTrackerSettings& settings);
+    
+    // Returns the existing tag if the name is already registered
+    MemoryTag RegisterTag(std::string_view name);
     
-    size_t GetTotalAllocated() const { return m_totalAllocated.load(); }
-    size_t GetActiveAllocations() const { return m_activeAllocations.load(); }
+    // Charged to the calling thread's current tag (see MemoryTagScope). Keep
+    // the result and pass it to RecordDeallocation with the same size.
+    MemorySample RecordAllocation(void* ptr, size_t size, const char* file, int line);
+    MemorySample RecordAllocation(void* ptr, size_t size, MemoryTag tag, const char* file, int line);
+    void RecordDeallocation(void* ptr, size_t size, const MemorySample& sample);
+    
+    size_t GetTotalAllocated() const { return m_currentBytes.load(std::memory_order_relaxed); }
+    size_t GetPeakAllocated() const { return m_peakBytes.load(std::memory_order_relaxed); }
+    size_t GetActiveAllocations() const { return m_activeAllocations.load(std::memory_order_relaxed); }
+    // Sampled allocations past a thread's maxTrackedAllocations, missing from reports
+    uint64_t GetDroppedSamples() const { return m_droppedSamples.load(std::memory_order_relaxed); }
+    
+    std::vector<MemoryTagStats> GetTagStats() const;
+    // Sorted by estimated bytes, largest first
+    std::vector<MemoryCallSiteStats> GetLiveCallSites() const;
     
     void PrintMemoryReport() const;
     
+    static MemoryTag GetCurrentTag();
+    static void SetCurrentTag(MemoryTag tag);
+    
 private:
-    struct AllocationInfo {
-        size_t size;
-        const char* file;
-        int line;
+    MemoryTracker();
+    ~MemoryTracker();
+    
+    MemoryThreadSamples& GetThreadSamples();
+    
+    struct alignas(64) TagCounters {
+        std::atomic<size_t> currentBytes{0};
+        std::atomic<size_t> peakBytes{0};
+        std::atomic<uint64_t> liveAllocations{0};
+        std::atomic<uint64_t> totalAllocations{0};
     };
     
-    std::unordered_map<void*, AllocationInfo> m_allocations;
-    mutable std::mutex m_mutex;
-    std::atomic<size_t> m_totalAllocated{0};
+    bool ShouldSample(size_t size, size_t& weight) const;
+    static void UpdatePeak(std::atomic<size_t>& peak, size_t value);
+    
+    std::atomic<size_t> m_sampleInterval{0};
+    std::atomic<size_t> m_maxThreadSamples{MemoryTrackerSettings{}.maxTrackedAllocations};
+    std::atomic<uint64_t> m_droppedSamples{0};
+    
+    // Every thread's slab; a new thread takes over one whose thread has exited
+    mutable std::mutex m_threadSamplesMutex;
+    std::vector<std::shared_ptr<MemoryThreadSamples>> m_threadSamples;
+    
+    alignas(64) std::atomic<size_t> m_currentBytes{0};
+    std::atomic<size_t> m_peakBytes{0};
     std::atomic<size_t> m_activeAllocations{0};
+    
+    std::array<TagCounters, MaxTags> m_tags;
+    std::array<std::string, MaxTags> m_tagNames;
+    std::atomic<MemoryTag> m_tagCount{1};
+    mutable std::mutex m_tagMutex;
+};
+
+// Charges DAISY_NEW allocations on this thread to a tag until the scope ends
+class MemoryTagScope {
+public:
+    explicit MemoryTagScope(MemoryTag tag) : m_previous(MemoryTracker::GetCurrentTag()) {
+        MemoryTracker::SetCurrentTag(tag);
+    }
+    ~MemoryTagScope() { MemoryTracker::SetCurrentTag(m_previous); }
+    
+    MemoryTagScope(const MemoryTagScope&) = delete;
+    MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+    
+private:
+    MemoryTag m_previous;
 };
 
+namespace Detail {
+    // Sits right before each DAISY_NEW object, so DAISY_DELETE charges back
+    // what was allocated even when it gets a base class pointer
+    struct TrackedHeader {
+        void* block;
+        size_t size;
+        size_t alignment;
+        MemorySample sample;
+    };
+    
+    template<typename T, typename... Args>
+    T* TrackedNew(const char* file, int line, Args&&... args) {
+        constexpr size_t alignment = std::max(alignof(T), alignof(TrackedHeader));
+        // Whole multiple of the alignment, so the object after it stays aligned
+        constexpr size_t prefix = (sizeof(TrackedHeader) + alignment - 1) / alignment * alignment;
+        
+        void* block = ::operator new(prefix + sizeof(T), std::align_val_t(alignment));
+        T* object;
+        try {
+            object = new (static_cast<char*>(block) + prefix) T(std::forward<Args>(args)...);
+        } catch (...) {
+            ::operator delete(block, std::align_val_t(alignment));
+            throw;
+        }
+        
+        MemorySample sample = MemoryTracker::GetInstance().RecordAllocation(object, sizeof(T), file, line);
+        new (reinterpret_cast<char*>(object) - sizeof(TrackedHeader)) TrackedHeader{block, sizeof(T), alignment, sample};
+        return object;
+    }
+    
+    template<typename T>
+    void TrackedDelete(T* ptr) {
+        // The header is in front of the complete object, not of a base subobject
+        const void* object;
+        if constexpr (std::is_polymorphic_v<T>) {
+            object = dynamic_cast<const void*>(ptr);
+        } else {
+            object = ptr;
+        }
+        
+        TrackedHeader header = *reinterpret_cast<const TrackedHeader*>(static_cast<const char*>(object) - sizeof(TrackedHeader));
+        MemoryTracker::GetInstance().RecordDeallocation(const_cast<void*>(object), header.size, header.sample);
+        ptr->~T();
+        ::operator delete(header.block, std::align_val_t(header.alignment));
+    }
+}
+
+// Fixed-type object pool. Objects live in contiguous slabs; free slots are
+// linked through an index stored in each slot and popped from a lock-free
+// tagged stack, so Acquire and Release never take a lock. When the free list
+// runs dry the pool grows by a whole slab, each twice the size of the last.
 template<typename T>
 class PoolAllocator {
 public:
-    explicit PoolAllocator(size_t poolSize = 1024) : m_poolSize(poolSize) {
-        m_pool.reserve(m_poolSize);
-        for (size_t i = 0; i < m_poolSize; ++i) {
-            m_pool.emplace_back(std::make_unique<T>());
-            m_available.push(m_pool.back().get());
+    // initialCapacity is rounded up to a power of two and allocated up front
+    explicit PoolAllocator(size_t initialCapacity = 1024)
+        : m_slabShift(static_cast<uint32_t>(std::bit_width(std::clamp<size_t>(initialCapacity, 2, MaxInitialCapacity) - 1))) {
+        m_maxSlabs = std::min<uint32_t>(MaxSlabs, 32 - m_slabShift);
+        
+        std::lock_guard<std::mutex> lock(m_growMutex);
+        uint32_t first = AddSlab();
+        if (first != InvalidIndex) {
+            PushChain(first, first + GetSlabCapacity(0) - 1);
         }
     }
     
-    T* Acquire() {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        if (m_available.empty()) {
-            return new T();
+    ~PoolAllocator() {
+        // Objects still acquired are not destroyed; release them first
+        for (uint32_t i = 0; i < m_slabCount.load(std::memory_order_relaxed); ++i) {
+            ::operator delete(m_slabs[i].load(std::memory_order_relaxed), std::align_val_t(alignof(Slot)));
+        }
+    }
+    
+    PoolAllocator(const PoolAllocator&) = delete;
+    PoolAllocator& operator=(const PoolAllocator&) = delete;
+    
+    template<typename... Args>
+    T* Acquire(Args&&... args) {
+        uint32_t index = Pop();
+        if (index == InvalidIndex) {
+            index = Grow();
         }
         
-        T* obj = m_available.front();
-        m_available.pop();
-        return obj;
+        Slot* slot = GetSlot(index);
+        T* object;
+        try {
+            object = new (slot->storage) T(std::forward<Args>(args)...);
+        } catch (...) {
+            Push(index);
+            throw;
+        }
+        m_activeCount.fetch_add(1, std::memory_order_relaxed);
+        return object;
     }
     
-    void Release(T* obj) {
-        if (!obj) return;
+    void Release(T* object) {
+        if (!object) return;
         
-        std::lock_guard<std::mutex> lock(m_mutex);
+        uint32_t index = GetIndex(object);
+        if (index == InvalidIndex) {
+            // Not ours; allocated with new elsewhere
+            delete object;
+            return;
+        }
         
-        bool isFromPool = false;
-        for (const auto& poolObj : m_pool) {
-            if (poolObj.get() == obj) {
-                isFromPool = true;
-                break;
+        object->~T();
+        m_activeCount.fetch_sub(1, std::memory_order_relaxed);
+        Push(index);
+    }
+    
+    bool Owns(const T* object) const { return GetIndex(object) != InvalidIndex; }
+    
+    size_t GetCapacity() const {
+        uint32_t slabs = m_slabCount.load(std::memory_order_acquire);
+        return slabs == 0 ? 0 : GetSlabBase(slabs);
+    }
+    size_t GetActiveCount() const { return m_activeCount.load(std::memory_order_relaxed); }
+    
+private:
+    struct Slot {
+        // The object is constructed at storage, so a pointer to it is a pointer to the slot
+        alignas(T) unsigned char storage[sizeof(T)];
+        std::atomic<uint32_t> next;
+    };
+    
+    static constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+    static constexpr uint32_t MaxSlabs = 24;
+    static constexpr size_t MaxInitialCapacity = size_t(1) << 24;
+    
+    // Head of the free list: slot index in the low half, ABA tag in the high half
+    static constexpr uint64_t PackHead(uint32_t index, uint32_t tag) {
+        return (static_cast<uint64_t>(tag) << 32) | index;
+    }
+    
+    uint32_t GetSlabCapacity(uint32_t slab) const { return 1u << (m_slabShift + slab); }
+    // Index of the first slot in a slab; slab k holds (1 << shift) << k slots
+    uint32_t GetSlabBase(uint32_t slab) const { return ((1u << slab) - 1) << m_slabShift; }
+    
+    Slot* GetSlot(uint32_t index) const {
+        uint32_t slab = static_cast<uint32_t>(std::bit_width((index >> m_slabShift) + 1)) - 1;
+        return m_slabs[slab].load(std::memory_order_acquire) + (index - GetSlabBase(slab));
+    }
+    
+    // Address-range check; there are at most MaxSlabs ranges to compare
+    uint32_t GetIndex(const T* object) const {
+        auto address = reinterpret_cast<uintptr_t>(object);
+        uint32_t slabs = m_slabCount.load(std::memory_order_acquire);
+        for (uint32_t i = 0; i < slabs; ++i) {
+            auto begin = reinterpret_cast<uintptr_t>(m_slabs[i].load(std::memory_order_relaxed));
+            uintptr_t offset = address - begin;
+            if (address >= begin && offset < static_cast<uintptr_t>(GetSlabCapacity(i)) * sizeof(Slot)) {
+                return offset % sizeof(Slot) == 0 ? GetSlabBase(i) + static_cast<uint32_t>(offset / sizeof(Slot))
+                                                  : InvalidIndex;
             }
         }
+        return InvalidIndex;
+    }
+    
+    uint32_t Pop() {
+        uint64_t head = m_freeHead.load(std::memory_order_acquire);
+        for (;;) {
+            uint32_t index = static_cast<uint32_t>(head);
+            if (index == InvalidIndex) {
+                return InvalidIndex;
+            }
+            
+            // next may be stale if another thread won the race; the tag makes the CAS fail then
+            uint32_t next = GetSlot(index)->next.load(std::memory_order_relaxed);
+            uint64_t newHead = PackHead(next, static_cast<uint32_t>(head >> 32) + 1);
+            if (m_freeHead.compare_exchange_weak(head, newHead, std::memory_order_acquire, std::memory_order_acquire)) {
+                return index;
+            }
+        }
+    }
+    
+    void Push(uint32_t index) {
+        PushChain(index, index);
+    }
+    
+    // Pushes first..last, already linked through next, as one unit
+    void PushChain(uint32_t first, uint32_t last) {
+        Slot* tail = GetSlot(last);
+        uint64_t head = m_freeHead.load(std::memory_order_relaxed);
+        for (;;) {
+            tail->next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+            uint64_t newHead = PackHead(first, static_cast<uint32_t>(head >> 32) + 1);
+            if (m_freeHead.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
+    
+    uint32_t Grow() {
+        std::lock_guard<std::mutex> lock(m_growMutex);
         
-        if (isFromPool) {
-            m_available.push(obj);
-        } else {
-            delete obj;
+        // Another thread may have grown the pool or released slots meanwhile
+        uint32_t index = Pop();
+        if (index != InvalidIndex) {
+            return index;
+        }
+        
+        uint32_t slab = m_slabCount.load(std::memory_order_relaxed);
+        uint32_t first = AddSlab();
+        if (first == InvalidIndex) {
+            throw std::bad_alloc();
         }
+        
+        // Keep the first slot for the caller and publish the rest
+        uint32_t last = first + GetSlabCapacity(slab) - 1;
+        if (last > first) {
+            PushChain(first + 1, last);
+        }
+        return first;
     }
     
-private:
-    std::vector<std::unique_ptr<T>> m_pool;
-    std::queue<T*> m_available;
-    std::mutex m_mutex;
-    size_t m_poolSize;
+    // Called with m_growMutex held; returns the first index of the new slab
+    uint32_t AddSlab() {
+        uint32_t slab = m_slabCount.load(std::memory_order_relaxed);
+        if (slab >= m_maxSlabs) {
+            return InvalidIndex;
+        }
+        
+        uint32_t capacity = GetSlabCapacity(slab);
+        uint32_t base = GetSlabBase(slab);
+        auto* slots = static_cast<Slot*>(::operator new(sizeof(Slot) * capacity, std::align_val_t(alignof(Slot))));
+        for (uint32_t i = 0; i < capacity; ++i) {
+            uint32_t next = i + 1 < capacity ? base + i + 1 : InvalidIndex;
+            new (&slots[i].next) std::atomic<uint32_t>(next);
+        }
+        
+        m_slabs[slab].store(slots, std::memory_order_release);
+        m_slabCount.store(slab + 1, std::memory_order_release);
+        return base;
+    }
+    
+    const uint32_t m_slabShift;
+    uint32_t m_maxSlabs = MaxSlabs;
+    std::array<std::atomic<Slot*>, MaxSlabs> m_slabs{};
+    std::atomic<uint32_t> m_slabCount{0};
+    alignas(64) std::atomic<uint64_t> m_freeHead{PackHead(InvalidIndex, 0)};
+    alignas(64) std::atomic<size_t> m_activeCount{0};
+    std::mutex m_growMutex;
 };
 
 template<typename T, typename... Args>
@@ -95,23 +408,28 @@ std::shared_ptr<T> MakeShared(Args&&... args) {
 
 }
 
-#ifdef DAISY_DEBUG
-    #define DAISY_NEW(type, ...) \
-        ([&]() { \
-            auto ptr = new type(__VA_ARGS__); \
-            Daisy::MemoryTracker::GetInstance().RecordAllocation(ptr, sizeof(type), __FILE__, __LINE__); \
-            return ptr; \
-        })()
+#define DAISY_MEMORY_CONCAT_IMPL(a, b) a##b
+#define DAISY_MEMORY_CONCAT(a, b) DAISY_MEMORY_CONCAT_IMPL(a, b)
+
+#if DAISY_MEMORY_TRACKING_ENABLED
+    // DAISY_NEW puts a header in front of the object, so the result must be
+    // freed with DAISY_DELETE only: plain delete, or handing it to a smart
+    // pointer with the default deleter, is undefined behaviour. With tracking
+    // off both are plain new and delete, so a mismatch only fails in tracked
+    // builds.
+    #define DAISY_NEW(type, ...) Daisy::Detail::TrackedNew<type>(__FILE__, __LINE__ __VA_OPT__(,) __VA_ARGS__)
     
     #define DAISY_DELETE(ptr) \
         do { \
             if (ptr) { \
-                Daisy::MemoryTracker::GetInstance().RecordDeallocation(ptr); \
-                delete ptr; \
+                Daisy::Detail::TrackedDelete(ptr); \
                 ptr = nullptr; \
             } \
         } while(0)
+        
+    #define DAISY_MEMORY_TAG_SCOPE(tag) Daisy::MemoryTagScope DAISY_MEMORY_CONCAT(daisyMemoryTagScope, __LINE__)(tag)
 #else
     #define DAISY_NEW(type, ...) new type(__VA_ARGS__)
     #define DAISY_DELETE(ptr) delete ptr; ptr = nullptr
+    #define DAISY_MEMORY_TAG_SCOPE(tag) ((void)0)
 #endif
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Daisy {
+
+struct MemoryBudget {
+    size_t softLimit = 0;   // Listeners are told when usage rises past this; 0 disables
+    size_t hardLimit = 0;   // Allocations past this fail with std::bad_alloc; 0 disables
+};
+
+enum class MemoryBudgetEvent {
+    SoftLimitExceeded,  // Usage just crossed the soft limit; allocation continues
+    HardLimitReached    // An allocation would pass the hard limit; it is retried once after listeners run
+};
+
+struct MemoryBudgetStats {
+    std::string name;
+    size_t currentBytes = 0;
+    size_t peakBytes = 0;
+    uint64_t liveAllocations = 0;
+    uint64_t failedAllocations = 0;
+    MemoryBudget budget;
+};
+
+class MemoryBudgetResource;
+
+// Runs on the allocating thread, possibly inside a container operation, so it
+// should only record the pressure and let the owner free memory later
+using MemoryBudgetCallback = std::function<void(MemoryBudgetResource& resource, MemoryBudgetEvent event)>;
+
+// Counting std::pmr::memory_resource placed in front of an upstream resource,
+// giving each module exact figures for the containers built on it
+class MemoryBudgetResource : public std::pmr::memory_resource {
+public:
+    explicit MemoryBudgetResource(std::string name,
+                                  std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    
+    MemoryBudgetResource(const MemoryBudgetResource&) = delete;
+    MemoryBudgetResource& operator=(const MemoryBudgetResource&) = delete;
+    
+    void SetBudget(const MemoryBudget& budget);
+    MemoryBudget GetBudget() const;
+    
+    // Returns an ID for RemoveListener
+    uint32_t AddListener(MemoryBudgetCallback callback);
+    void RemoveListener(uint32_t id);
+    
+    // Outstanding allocations must be releasable through the new upstream, e.g.
+    // a VirtualMemoryResource whose own upstream is the old one. Not thread-safe.
+    void SetUpstream(std::pmr::memory_resource* upstream) { m_upstream = upstream; }
+    std::pmr::memory_resource* GetUpstream() const { return m_upstream; }
+    
+    const std::string& GetName() const { return m_name; }
+    size_t GetCurrentBytes() const { return m_currentBytes.load(std::memory_order_relaxed); }
+    size_t GetPeakBytes() const { return m_peakBytes.load(std::memory_order_relaxed); }
+    bool IsOverSoftLimit() const;
+    MemoryBudgetStats GetStats() const;
+    
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    
+    void Notify(MemoryBudgetEvent event);
+    
+    std::string m_name;
+    std::pmr::memory_resource* m_upstream;
+    
+    std::atomic<size_t> m_softLimit{0};
+    std::atomic<size_t> m_hardLimit{0};
+    std::atomic<size_t> m_currentBytes{0};
+    std::atomic<size_t> m_peakBytes{0};
+    std::atomic<uint64_t> m_liveAllocations{0};
+    std::atomic<uint64_t> m_failedAllocations{0};
+    
+    mutable std::mutex m_listenerMutex;
+    std::vector<std::pair<uint32_t, MemoryBudgetCallback>> m_listeners;
+    uint32_t m_nextListenerId = 1;
+};
+
+// unique_ptr whose object lives in a memory resource, for containers of owned objects
+template<typename T>
+struct ResourceDeleter {
+    std::pmr::memory_resource* resource = nullptr;
+    
+    void operator()(T* object) const {
+        std::pmr::polymorphic_allocator<T>(resource).delete_object(object);
+    }
+};
+
+template<typename T>
+using ResourceUniquePtr = std::unique_ptr<T, ResourceDeleter<T>>;
+
+template<typename T, typename... Args>
+ResourceUniquePtr<T> MakeUniqueIn(std::pmr::memory_resource* resource, Args&&... args) {
+    T* object = std::pmr::polymorphic_allocator<T>(resource).template new_object<T>(std::forward<Args>(args)...);
+    return ResourceUniquePtr<T>(object, ResourceDeleter<T>{resource});
+}
+
+}
\ No newline at end of file
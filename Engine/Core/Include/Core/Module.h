@@ -1,25 +1,147 @@
 #pragma once
 
+#include "FrameArena.h"
+#include "Memory.h"
+#include "MemoryBudget.h"
+#include "VirtualMemory.h"
+#include <cstdint>
 #include <string>
 #include <memory>
+#include <atomic>
+#include <vector>
 
 namespace Daisy {
 
+class Engine;
+class JobSystem;
+
+// How the engine may schedule a module's Update relative to other modules
+enum class ModuleThreading {
+    Exclusive,  // Main thread, ordered against every other module (default)
+    MainThread, // Main thread, may overlap worker modules it does not depend on
+    Worker      // Any worker thread, may overlap every module it does not depend on
+};
+
+enum class ModuleAccess {
+    Read,  // Runs after the other module has updated this frame
+    Write  // Never overlaps the other module, ordered by registration
+};
+
+// Which engine ticks drive a module; see Engine::SetTimestepSettings
+enum class ModuleTick : uint8_t {
+    Variable = 1 << 0, // Update once per rendered frame
+    Fixed = 1 << 1,    // FixedUpdate once per simulation step
+    Both = Variable | Fixed
+};
+
+inline bool HasTick(ModuleTick ticks, ModuleTick tick) {
+    return (static_cast<uint8_t>(ticks) & static_cast<uint8_t>(tick)) != 0;
+}
+
+// Dense per-type slot index. This is a run-time counter, not a compile-time
+// index: each module type takes the next ID the first time ModuleTypeIdOf<T>()
+// runs, so IDs follow the order types are first used (usually registration
+// order) and are only stable within one run.
+using ModuleTypeId = uint32_t;
+
+inline ModuleTypeId AllocateModuleTypeId() {
+    static std::atomic<ModuleTypeId> nextTypeId{0};
+    return nextTypeId.fetch_add(1, std::memory_order_relaxed);
+}
+
+// A function-local static rather than a variable template, whose dynamic
+// initialization would be unordered against other static initializers
+template<typename T>
+inline ModuleTypeId ModuleTypeIdOf() {
+    static const ModuleTypeId typeId = AllocateModuleTypeId();
+    return typeId;
+}
+
+struct ModuleDependency {
+    ModuleTypeId module;
+    ModuleAccess access;
+};
+
 class Module {
 public:
-    Module(const std::string& name) : m_name(name) {}
+    Module(const std::string& name) : m_name(name), m_memoryResource(name) {}
     virtual ~Module() = default;
     
     virtual bool Initialize() = 0;
     virtual void Update(float deltaTime) = 0;
     virtual void Shutdown() = 0;
     
+    // Fixed-tick modules that do not override this step their regular Update
+    virtual void FixedUpdate(float fixedDeltaTime) { Update(fixedDeltaTime); }
+    
     const std::string& GetName() const { return m_name; }
     bool IsInitialized() const { return m_initialized; }
     
+    ModuleThreading GetThreading() const { return m_threading; }
+    ModuleTick GetTick() const { return m_tick; }
+    const std::vector<ModuleDependency>& GetDependencies() const { return m_dependencies; }
+    
+    Engine* GetEngine() const { return m_engine; }
+    JobSystem* GetJobSystem() const { return m_jobSystem; }
+    FrameArena* GetFrameArena() const { return m_frameArena; }
+    // Allocation tag named after the module; DAISY_NEW inside its Update is charged to it
+    MemoryTag GetMemoryTag() const { return m_memoryTag; }
+    // Long-lived module containers allocate through this so usage and budgets are per module
+    MemoryBudgetResource& GetMemoryResource() { return m_memoryResource; }
+    const MemoryBudgetResource& GetMemoryResource() const { return m_memoryResource; }
+    // Routes the module's large allocations (see VirtualMemoryResource) to
+    // reserved address space with the given page size and NUMA placement.
+    // Without a reserveSize the region follows the module's hard budget, and
+    // is resized when Engine::SetModuleMemoryBudget changes it.
+    // Call before Initialize; fails once large arrays have been allocated.
+    bool UseVirtualMemory(const VirtualMemorySettings& settings) {
+        if (m_virtualMemory && m_virtualMemory->GetLiveBytes() > 0) {
+            return false;
+        }
+        size_t reserveSize = VirtualMemoryResource::GetReserveSize(settings, m_memoryResource.GetBudget().hardLimit);
+        // Drop the old reservation first so both are never mapped at once
+        m_memoryResource.SetUpstream(std::pmr::new_delete_resource());
+        m_virtualMemory.reset();
+        m_virtualMemory = std::make_unique<VirtualMemoryResource>(
+            settings, reserveSize, VirtualMemoryResource::DefaultMinAllocationSize, std::pmr::new_delete_resource());
+        m_memoryResource.SetUpstream(m_virtualMemory.get());
+        m_virtualMemorySettings = settings;
+        return true;
+    }
+    const VirtualMemoryResource* GetVirtualMemory() const { return m_virtualMemory.get(); }
+    // Frame arena resource once registered with an Engine, the default heap before that
+    std::pmr::memory_resource* GetFrameResource() const {
+        return m_frameArena ? m_frameArena->GetResource() : std::pmr::get_default_resource();
+    }
+    ModuleTypeId GetTypeId() const { return m_typeId; }
+    
 protected:
+    void SetThreading(ModuleThreading threading) { m_threading = threading; }
+    void SetTick(ModuleTick tick) { m_tick = tick; }
+    
+    template<typename T>
+    void ReadsModule() { m_dependencies.push_back({ModuleTypeIdOf<T>(), ModuleAccess::Read}); }
+    
+    template<typename T>
+    void WritesModule() { m_dependencies.push_back({ModuleTypeIdOf<T>(), ModuleAccess::Write}); }
+    
     std::string m_name;
     bool m_initialized = false;
+    ModuleThreading m_threading = ModuleThreading::Exclusive;
+    ModuleTick m_tick = ModuleTick::Variable;
+    std::vector<ModuleDependency> m_dependencies;
+    
+private:
+    friend class Engine;
+    
+    Engine* m_engine = nullptr;
+    JobSystem* m_jobSystem = nullptr;
+    FrameArena* m_frameArena = nullptr;
+    MemoryTag m_memoryTag = GeneralMemoryTag;
+    MemoryBudgetResource m_memoryResource;
+    std::unique_ptr<VirtualMemoryResource> m_virtualMemory;
+    VirtualMemorySettings m_virtualMemorySettings;
+    ModuleTypeId m_typeId = 0;
 };
 
 template<typename T>
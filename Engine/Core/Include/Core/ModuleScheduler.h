@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Module.h"
+#include "JobSystem.h"
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+namespace Daisy {
+
+// Runs module updates as a dependency graph: modules without a path between
+// them in the graph update concurrently, so a frame costs its critical path.
+// Worker modules run as jobs; the main thread helps with jobs while it waits.
+class ModuleScheduler {
+public:
+    explicit ModuleScheduler(JobSystem& jobSystem) : m_jobSystem(jobSystem) {}
+    
+    // Modules in registration order
+    void Build(const std::vector<Module*>& modules);
+    
+    // Runs every module driven by one of the given ticks; a module in both
+    // gets FixedUpdate before Update
+    void Execute(float deltaTime, ModuleTick ticks);
+    
+    uint32_t GetWorkerCount() const { return m_jobSystem.GetWorkerCount(); }
+    size_t GetCriticalPathLength() const { return m_criticalPathLength; }
+    
+private:
+    struct Node {
+        Module* module = nullptr;
+        bool mainThread = true;
+        std::vector<size_t> successors;
+        uint32_t predecessorCount = 0;
+        uint32_t pendingPredecessors = 0;
+    };
+    
+    bool IsScheduled(size_t nodeIndex) const;
+    bool SortNodes();
+    void BuildSerialChain();
+    void Dispatch(size_t nodeIndex);
+    void Complete(size_t nodeIndex);
+    void RunNode(size_t nodeIndex);
+    
+    JobSystem& m_jobSystem;
+    std::vector<Node> m_nodes;
+    size_t m_criticalPathLength = 0;
+    
+    // Per-frame state, guarded by m_frameMutex
+    std::mutex m_frameMutex;
+    std::condition_variable m_frameCondition;
+    std::vector<size_t> m_mainThreadReady;
+    size_t m_remainingNodes = 0;
+    float m_deltaTime = 0.0f;
+    ModuleTick m_ticks = ModuleTick::Both;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Keyed on DAISY_RELEASE: DAISY_DEBUG is also the debug log macro, so it is defined in every build
+#if defined(DAISY_PROFILE) || !defined(DAISY_RELEASE)
+#define DAISY_PROFILING_ENABLED 1
+#else
+#define DAISY_PROFILING_ENABLED 0
+#endif
+
+namespace Daisy {
+
+struct ProfileThreadBuffer;
+
+struct ProfileZoneStats {
+    std::string name;
+    double lastMs = 0.0;        // Total time spent in the zone during the last frame it ran
+    double minMs = 0.0;         // Rolling stats over the last ProfileWindowFrames frames
+    double averageMs = 0.0;
+    double p99Ms = 0.0;
+    uint32_t callsLastFrame = 0;
+};
+
+// Collects zone timings recorded on any thread. Each thread writes complete
+// zones into its own single-producer ring buffer; EndFrame drains them on the
+// main thread into per-zone rolling stats and, while tracing, a trace capture.
+class Profiler {
+public:
+    static constexpr size_t ProfileWindowFrames = 240;
+    
+    static Profiler& GetInstance();
+    
+    // Nanoseconds since the profiler was first used
+    static uint64_t Now();
+    
+    // Zone names must stay valid until the next EndFrame
+    void Record(const char* name, uint64_t startNs, uint64_t endNs);
+    
+    void EndFrame();
+    
+    bool GetZoneStats(const std::string& name, ProfileZoneStats& stats) const;
+    std::vector<ProfileZoneStats> GetAllZoneStats() const;
+    void ResetStats();
+    
+    // Chrome trace-event capture (chrome://tracing, Perfetto)
+    void BeginTrace();
+    bool EndTrace(const std::string& path);
+    bool IsTracing() const { return m_tracing.load(std::memory_order_relaxed); }
+    
+    uint64_t GetDroppedEventCount() const { return m_droppedEvents.load(std::memory_order_relaxed); }
+    
+private:
+    Profiler() = default;
+    
+    struct Zone {
+        std::string name;
+        std::vector<float> samples;
+        size_t nextSample = 0;
+        uint64_t frameTotalNs = 0;
+        uint32_t frameCalls = 0;
+        double lastMs = 0.0;
+        uint32_t lastCalls = 0;
+    };
+    
+    struct TraceEvent {
+        uint32_t zone;
+        uint32_t threadId;
+        uint64_t startNs;
+        uint64_t endNs;
+    };
+    
+    friend struct ProfileThreadBuffer;
+    ProfileThreadBuffer& GetThreadBuffer();
+    uint32_t InternZone(const char* name);
+    void FillStats(const Zone& zone, ProfileZoneStats& stats) const;
+    
+    std::mutex m_buffersMutex;
+    std::vector<std::shared_ptr<ProfileThreadBuffer>> m_buffers;
+    uint32_t m_nextThreadId = 0;
+    std::atomic<uint64_t> m_droppedEvents{0};
+    
+    // Written by EndFrame only, read under m_statsMutex
+    mutable std::mutex m_statsMutex;
+    std::vector<Zone> m_zones;
+    std::unordered_map<const char*, uint32_t> m_zonesByPointer;     // This frame's names only
+    std::unordered_map<std::string, uint32_t> m_zonesByName;
+    
+    std::atomic<bool> m_tracing{false};
+    std::vector<TraceEvent> m_traceEvents;
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : m_name(name), m_startNs(Profiler::Now()) {}
+    ~ProfileScope() { Profiler::GetInstance().Record(m_name, m_startNs, Profiler::Now()); }
+    
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+    
+private:
+    const char* m_name;
+    uint64_t m_startNs;
+};
+
+}
+
+#define DAISY_PROFILE_CONCAT_IMPL(a, b) a##b
+#define DAISY_PROFILE_CONCAT(a, b) DAISY_PROFILE_CONCAT_IMPL(a, b)
+
+#if DAISY_PROFILING_ENABLED
+#define DAISY_PROFILE_SCOPE(name) Daisy::ProfileScope DAISY_PROFILE_CONCAT(daisyProfileScope, __LINE__)(name)
+#define DAISY_PROFILE_FUNCTION() DAISY_PROFILE_SCOPE(__func__)
+#else
+#define DAISY_PROFILE_SCOPE(name) ((void)0)
+#define DAISY_PROFILE_FUNCTION() ((void)0)
+#endif
\ No newline at end of file
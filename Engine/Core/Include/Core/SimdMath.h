@@ -0,0 +1,270 @@
+#pragma once
+
+#include "Math.h"
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+// Instruction set is fixed at compile time by the target flags (see DAISY_SIMD
+// in the root CMakeLists.txt); DAISY_SIMD_SCALAR forces the portable path
+#if !defined(DAISY_SIMD_SCALAR)
+    #if !defined(DAISY_SIMD_AVX2) && defined(__AVX2__)
+        #define DAISY_SIMD_AVX2 1
+    #endif
+    #if !defined(DAISY_SIMD_SSE41) && (defined(__SSE4_1__) || defined(__AVX__) || defined(DAISY_SIMD_AVX2))
+        #define DAISY_SIMD_SSE41 1
+    #endif
+#endif
+
+#if defined(DAISY_SIMD_SSE41)
+    #include <immintrin.h>
+#endif
+
+namespace Daisy::Simd {
+
+static_assert(sizeof(Vector3) == 3 * sizeof(float), "Batch kernels treat Vector3 arrays as packed floats");
+static_assert(sizeof(Vector4) == 4 * sizeof(float) && sizeof(Quaternion) == 4 * sizeof(float));
+static_assert(sizeof(Matrix4) == 16 * sizeof(float));
+
+constexpr const char* GetInstructionSet() {
+#if defined(DAISY_SIMD_AVX2)
+    return "AVX2";
+#elif defined(DAISY_SIMD_SSE41)
+    return "SSE4.1";
+#else
+    return "Scalar";
+#endif
+}
+
+// Single-value kernels behind the Matrix4 and Quaternion operators. Inputs
+// and output may alias; pointers need not be 16-byte aligned.
+
+// out = a * b in Matrix4's convention: out[i][j] = sum over k of a[i][k] * b[k][j]
+inline void MultiplyMatrix4(const float* a, const float* b, float* out) {
+#if defined(DAISY_SIMD_AVX2)
+    // Two rows of a per 256-bit register; each row of b is repeated in both halves
+    __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b));
+    __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 4));
+    __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 8));
+    __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 12));
+    __m256 a01 = _mm256_loadu_ps(a);
+    __m256 a23 = _mm256_loadu_ps(a + 8);
+    
+    __m256 r01 = _mm256_mul_ps(_mm256_permute_ps(a01, 0x00), b0);
+    __m256 r23 = _mm256_mul_ps(_mm256_permute_ps(a23, 0x00), b0);
+    #if defined(__FMA__)
+    r01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, 0x55), b1, r01);
+    r23 = _mm256_fmadd_ps(_mm256_permute_ps(a23, 0x55), b1, r23);
+    r01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, 0xAA), b2, r01);
+    r23 = _mm256_fmadd_ps(_mm256_permute_ps(a23, 0xAA), b2, r23);
+    r01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, 0xFF), b3, r01);
+    r23 = _mm256_fmadd_ps(_mm256_permute_ps(a23, 0xFF), b3, r23);
+    #else
+    r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_permute_ps(a01, 0x55), b1));
+    r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_permute_ps(a23, 0x55), b1));
+    r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_permute_ps(a01, 0xAA), b2));
+    r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_permute_ps(a23, 0xAA), b2));
+    r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_permute_ps(a01, 0xFF), b3));
+    r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_permute_ps(a23, 0xFF), b3));
+    #endif
+    _mm256_storeu_ps(out, r01);
+    _mm256_storeu_ps(out + 8, r23);
+#elif defined(DAISY_SIMD_SSE41)
+    __m128 b0 = _mm_loadu_ps(b);
+    __m128 b1 = _mm_loadu_ps(b + 4);
+    __m128 b2 = _mm_loadu_ps(b + 8);
+    __m128 b3 = _mm_loadu_ps(b + 12);
+    __m128 rows[4];
+    for (int i = 0; i < 4; ++i) {
+        __m128 row = _mm_loadu_ps(a + i * 4);
+        __m128 r = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+        rows[i] = r;
+    }
+    for (int i = 0; i < 4; ++i) {
+        _mm_storeu_ps(out + i * 4, rows[i]);
+    }
+#else
+    float result[16];
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            result[i * 4 + j] = a[i * 4] * b[j] + a[i * 4 + 1] * b[4 + j] +
+                                a[i * 4 + 2] * b[8 + j] + a[i * 4 + 3] * b[12 + j];
+        }
+    }
+    for (int i = 0; i < 16; ++i) {
+        out[i] = result[i];
+    }
+#endif
+}
+
+// out = m * v with m's columns at m[0..3], m[4..7], m[8..11], m[12..15]
+inline void TransformVector4(const float* m, const float* v, float* out) {
+#if defined(DAISY_SIMD_SSE41)
+    __m128 r = _mm_mul_ps(_mm_loadu_ps(m), _mm_set1_ps(v[0]));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 4), _mm_set1_ps(v[1])));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 8), _mm_set1_ps(v[2])));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 12), _mm_set1_ps(v[3])));
+    _mm_storeu_ps(out, r);
+#else
+    float x = v[0], y = v[1], z = v[2], w = v[3];
+    out[0] = m[0] * x + m[4] * y + m[8]  * z + m[12] * w;
+    out[1] = m[1] * x + m[5] * y + m[9]  * z + m[13] * w;
+    out[2] = m[2] * x + m[6] * y + m[10] * z + m[14] * w;
+    out[3] = m[3] * x + m[7] * y + m[11] * z + m[15] * w;
+#endif
+}
+
+// Hamilton product of (x, y, z, w) quaternions
+inline void MultiplyQuaternion(const float* a, const float* b, float* out) {
+#if defined(DAISY_SIMD_SSE41)
+    __m128 q = _mm_loadu_ps(b);
+    const __m128 signs1 = _mm_castsi128_ps(_mm_setr_epi32(0, int(0x80000000), 0, int(0x80000000)));
+    const __m128 signs2 = _mm_castsi128_ps(_mm_setr_epi32(0, 0, int(0x80000000), int(0x80000000)));
+    const __m128 signs3 = _mm_castsi128_ps(_mm_setr_epi32(int(0x80000000), 0, 0, int(0x80000000)));
+    
+    __m128 r = _mm_mul_ps(_mm_set1_ps(a[3]), q);
+    __m128 t1 = _mm_xor_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 1, 2, 3)), signs1);  // ( w, -z,  y, -x)
+    __m128 t2 = _mm_xor_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(1, 0, 3, 2)), signs2);  // ( z,  w, -x, -y)
+    __m128 t3 = _mm_xor_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(2, 3, 0, 1)), signs3);  // (-y,  x,  w, -z)
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a[0]), t1));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a[1]), t2));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a[2]), t3));
+    _mm_storeu_ps(out, r);
+#else
+    float x = a[3] * b[0] + a[0] * b[3] + a[1] * b[2] - a[2] * b[1];
+    float y = a[3] * b[1] - a[0] * b[2] + a[1] * b[3] + a[2] * b[0];
+    float z = a[3] * b[2] + a[0] * b[1] - a[1] * b[0] + a[2] * b[3];
+    float w = a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2];
+    out[0] = x;
+    out[1] = y;
+    out[2] = z;
+    out[3] = w;
+#endif
+}
+
+// Zero-length input gives the identity
+inline void NormalizeQuaternion(const float* q, float* out) {
+#if defined(DAISY_SIMD_SSE41)
+    __m128 v = _mm_loadu_ps(q);
+    __m128 lengthSquared = _mm_dp_ps(v, v, 0xFF);
+    if (_mm_cvtss_f32(lengthSquared) > 0.0f) {
+        _mm_storeu_ps(out, _mm_div_ps(v, _mm_sqrt_ps(lengthSquared)));
+    } else {
+        _mm_storeu_ps(out, _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+    }
+#else
+    float length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    if (length > 0.0f) {
+        out[0] = q[0] / length;
+        out[1] = q[1] / length;
+        out[2] = q[2] / length;
+        out[3] = q[3] / length;
+    } else {
+        out[0] = out[1] = out[2] = 0.0f;
+        out[3] = 1.0f;
+    }
+#endif
+}
+
+// Batch kernels over arrays. out may be the same array as an input, but
+// must not otherwise overlap one.
+
+// out[i] = m * (points[i], 1), dropping w
+void TransformPoints(const Matrix4& m, const Vector3* points, Vector3* out, size_t count);
+// out[i] = m * vectors[i]
+void TransformVectors(const Matrix4& m, const Vector4* vectors, Vector4* out, size_t count);
+// out[i] = a[i] * b[i]
+void MultiplyMatrices(const Matrix4* a, const Matrix4* b, Matrix4* out, size_t count);
+// out[i] = a[i] + b[i] * scale, e.g. position + velocity * deltaTime
+void MultiplyAdd(const Vector3* a, const Vector3* b, float scale, Vector3* out, size_t count);
+void NormalizeQuaternions(Quaternion* quaternions, size_t count);
+
+// Structure-of-arrays views: element i is (x[i], y[i], z[i]). The SoA kernels
+// below work on 8 (AVX2) or 4 (SSE4.1) elements per instruction with no
+// shuffling, so they are the ones to use for thousands of objects per call.
+struct Vector3Stream {
+    float* x;
+    float* y;
+    float* z;
+};
+
+struct ConstVector3Stream {
+    const float* x;
+    const float* y;
+    const float* z;
+    
+    ConstVector3Stream(const float* x, const float* y, const float* z) : x(x), y(y), z(z) {}
+    ConstVector3Stream(const Vector3Stream& stream) : x(stream.x), y(stream.y), z(stream.z) {}
+};
+
+struct QuaternionStream {
+    float* x;
+    float* y;
+    float* z;
+    float* w;
+};
+
+// out[i] = m * (points[i], 1), dropping w
+void TransformPoints(const Matrix4& m, ConstVector3Stream points, Vector3Stream out, size_t count);
+// out[i] = |points[i] - origin|^2; compare against a squared radius to avoid the square root
+void DistancesSquared(ConstVector3Stream points, const Vector3& origin, float* out, size_t count);
+// out[i] = |points[i] - origin|
+void Distances(ConstVector3Stream points, const Vector3& origin, float* out, size_t count);
+// Zero-length entries become the identity
+void NormalizeQuaternions(QuaternionStream quaternions, size_t count);
+
+}
+
+namespace Daisy {
+
+// SoA storage for gathering positions out of objects into one batch call.
+// Usually built on a module's frame resource so it costs nothing to free.
+class Vector3Array {
+public:
+    explicit Vector3Array(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : m_x(resource), m_y(resource), m_z(resource) {}
+        
+    void Reserve(size_t count) {
+        m_x.reserve(count);
+        m_y.reserve(count);
+        m_z.reserve(count);
+    }
+    void Resize(size_t count) {
+        m_x.resize(count);
+        m_y.resize(count);
+        m_z.resize(count);
+    }
+    void Clear() {
+        m_x.clear();
+        m_y.clear();
+        m_z.clear();
+    }
+    
+    void PushBack(const Vector3& value) {
+        m_x.push_back(value.x);
+        m_y.push_back(value.y);
+        m_z.push_back(value.z);
+    }
+    void Set(size_t index, const Vector3& value) {
+        m_x[index] = value.x;
+        m_y[index] = value.y;
+        m_z[index] = value.z;
+    }
+    Vector3 Get(size_t index) const { return Vector3(m_x[index], m_y[index], m_z[index]); }
+    
+    size_t Size() const { return m_x.size(); }
+    bool Empty() const { return m_x.empty(); }
+    
+    Simd::Vector3Stream GetStream() { return {m_x.data(), m_y.data(), m_z.data()}; }
+    Simd::ConstVector3Stream GetStream() const { return {m_x.data(), m_y.data(), m_z.data()}; }
+    
+private:
+    std::pmr::vector<float> m_x;
+    std::pmr::vector<float> m_y;
+    std::pmr::vector<float> m_z;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory_resource>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Daisy {
+
+// Generational handle into a SlotMap<T>. Once the object is erased its slot's
+// generation moves on, so the handle stops resolving even after the slot is
+// reused. A default-constructed handle is invalid.
+template<typename T>
+struct Handle {
+    static constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+    
+    uint32_t index = InvalidIndex;
+    uint32_t generation = 0;
+    
+    bool IsValid() const { return index != InvalidIndex; }
+    explicit operator bool() const { return IsValid(); }
+    
+    uint64_t ToBits() const { return (static_cast<uint64_t>(generation) << 32) | index; }
+    static Handle FromBits(uint64_t bits) { return Handle{static_cast<uint32_t>(bits), static_cast<uint32_t>(bits >> 32)}; }
+    
+    friend bool operator==(const Handle&, const Handle&) = default;
+};
+
+// Objects live by value in one dense array, so per-frame loops walk contiguous
+// memory; a sparse slot array maps handles to dense positions. Insert, Erase
+// and Get are O(1). Erase moves the last object into the hole, so pointers and
+// references are only valid until the next Insert or Erase. Tag names the
+// handle type, for maps that hold only part of what a handle stands for.
+template<typename T, typename Tag = T>
+class SlotMap {
+public:
+    using HandleType = Handle<Tag>;
+    using iterator = typename std::pmr::vector<T>::iterator;
+    using const_iterator = typename std::pmr::vector<T>::const_iterator;
+    
+    // No default: module maps must name their module's resource, or they
+    // silently miss its budget and virtual memory
+    explicit SlotMap(std::pmr::memory_resource* resource)
+        : m_values(resource), m_valueSlots(resource), m_slots(resource) {}
+        
+    template<typename... Args>
+    HandleType Insert(Args&&... args) {
+        if (m_freeHead == InvalidIndex) {
+            m_slots.push_back(Slot{InvalidIndex, 1});
+            m_freeHead = static_cast<uint32_t>(m_slots.size() - 1);
+        }
+        
+        // Claim the slot only once the object exists, so a throwing
+        // constructor leaves the map unchanged
+        m_valueSlots.push_back(m_freeHead);
+        try {
+            m_values.emplace_back(std::forward<Args>(args)...);
+        } catch (...) {
+            m_valueSlots.pop_back();
+            throw;
+        }
+        
+        uint32_t index = m_freeHead;
+        Slot& slot = m_slots[index];
+        m_freeHead = slot.target;
+        slot.target = static_cast<uint32_t>(m_values.size() - 1);
+        return HandleType{index, slot.generation};
+    }
+    
+    // Returns false for a stale or invalid handle
+    bool Erase(HandleType handle) {
+        if (!Contains(handle)) {
+            return false;
+        }
+        
+        Slot& slot = m_slots[handle.index];
+        uint32_t dense = slot.target;
+        uint32_t last = static_cast<uint32_t>(m_values.size() - 1);
+        if (dense != last) {
+            m_values[dense] = std::move(m_values[last]);
+            m_valueSlots[dense] = m_valueSlots[last];
+            m_slots[m_valueSlots[dense]].target = dense;
+        }
+        m_values.pop_back();
+        m_valueSlots.pop_back();
+        
+        Release(handle.index);
+        return true;
+    }
+    
+    bool Contains(HandleType handle) const {
+        return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation &&
+               IsOccupied(handle.index);
+    }
+    
+    T* Get(HandleType handle) {
+        return Contains(handle) ? &m_values[m_slots[handle.index].target] : nullptr;
+    }
+    
+    const T* Get(HandleType handle) const {
+        return Contains(handle) ? &m_values[m_slots[handle.index].target] : nullptr;
+    }
+    
+    // Position in the dense array, for arrays kept parallel to it: Insert
+    // appends, Erase moves the last position into the erased one. Returns
+    // HandleType::InvalidIndex for a stale or invalid handle.
+    uint32_t GetDenseIndex(HandleType handle) const {
+        return Contains(handle) ? m_slots[handle.index].target : InvalidIndex;
+    }
+    
+    // Handle of the object at a position in the dense array, for loops that
+    // need to refer back to what they visit
+    HandleType GetHandle(size_t denseIndex) const {
+        uint32_t index = m_valueSlots[denseIndex];
+        return HandleType{index, m_slots[index].generation};
+    }
+    
+    void Clear() {
+        for (uint32_t index : m_valueSlots) {
+            Release(index);
+        }
+        m_values.clear();
+        m_valueSlots.clear();
+    }
+    
+    void Reserve(size_t count) {
+        m_values.reserve(count);
+        m_valueSlots.reserve(count);
+        m_slots.reserve(count);
+    }
+    
+    size_t Size() const { return m_values.size(); }
+    bool Empty() const { return m_values.empty(); }
+    
+    std::span<T> Values() { return m_values; }
+    std::span<const T> Values() const { return m_values; }
+    
+    iterator begin() { return m_values.begin(); }
+    iterator end() { return m_values.end(); }
+    const_iterator begin() const { return m_values.begin(); }
+    const_iterator end() const { return m_values.end(); }
+    
+private:
+    static constexpr uint32_t InvalidIndex = HandleType::InvalidIndex;
+    
+    struct Slot {
+        uint32_t target;        // Dense index while occupied, next free slot while free
+        uint32_t generation;
+    };
+    
+    bool IsOccupied(uint32_t index) const {
+        uint32_t dense = m_slots[index].target;
+        return dense < m_valueSlots.size() && m_valueSlots[dense] == index;
+    }
+    
+    void Release(uint32_t index) {
+        Slot& slot = m_slots[index];
+        // A slot whose generation would wrap is retired rather than reused,
+        // so an old handle can never match it again
+        if (++slot.generation == 0) {
+            slot.target = InvalidIndex;
+            return;
+        }
+        slot.target = m_freeHead;
+        m_freeHead = index;
+    }
+    
+    std::pmr::vector<T> m_values;
+    std::pmr::vector<uint32_t> m_valueSlots;    // Dense index -> slot index
+    std::pmr::vector<Slot> m_slots;
+    uint32_t m_freeHead = InvalidIndex;
+};
+
+}
+
+template<typename T>
+struct std::hash<Daisy::Handle<T>> {
+    size_t operator()(const Daisy::Handle<T>& handle) const noexcept {
+        return std::hash<uint64_t>{}(handle.ToBits());
+    }
+};
\ No newline at end of file
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+
+namespace Daisy {
+
+enum class LargePageMode {
+    None,
+    Transparent,    // Ask the OS to back the region with huge pages when it can (Linux THP)
+    Explicit        // Pre-reserved huge pages (MAP_HUGETLB); falls back to Transparent if none are free
+};
+
+struct VirtualMemorySettings {
+    LargePageMode largePages = LargePageMode::Transparent;
+    int numaNode = -1;      // Bind physical pages to this node; -1 leaves placement to the OS
+    // Address space to reserve; 0 sizes it from the owner's budget (see
+    // VirtualMemoryResource::GetReserveSize)
+    size_t reserveSize = 0;
+};
+
+namespace VirtualMemory {
+    size_t GetPageSize();
+    size_t GetLargePageSize();
+    // 1 on machines without NUMA or where it cannot be queried
+    uint32_t GetNumaNodeCount();
+}
+
+// Address space reserved up front and backed by physical memory only where
+// committed. Commit and Decommit take offsets into the region, must cover
+// whole commit granules (the large page size when large pages are in use) and
+// must not overlap ranges already in that state.
+class VirtualMemoryRegion {
+public:
+    VirtualMemoryRegion() = default;
+    ~VirtualMemoryRegion();
+    
+    VirtualMemoryRegion(const VirtualMemoryRegion&) = delete;
+    VirtualMemoryRegion& operator=(const VirtualMemoryRegion&) = delete;
+    
+    bool Reserve(size_t size, const VirtualMemorySettings& settings = {});
+    void Release();
+    
+    bool Commit(size_t offset, size_t size);
+    void Decommit(size_t offset, size_t size);
+    
+    bool IsReserved() const { return m_base != nullptr; }
+    bool Contains(const void* ptr) const {
+        return ptr >= m_base && ptr < m_base + m_reservedSize;
+    }
+    std::byte* GetBase() const { return m_base; }
+    size_t GetReservedSize() const { return m_reservedSize; }
+    size_t GetCommittedSize() const { return m_committedSize; }
+    size_t GetCommitGranule() const { return m_granule; }
+    // What the region actually got, which may be less than was asked for
+    LargePageMode GetLargePageMode() const { return m_largePages; }
+    int GetNumaNode() const { return m_numaNode; }
+    
+private:
+    std::byte* m_base = nullptr;
+    size_t m_reservedSize = 0;
+    size_t m_granule = 0;
+    LargePageMode m_largePages = LargePageMode::None;
+    int m_numaNode = -1;
+    size_t m_committedSize = 0;
+};
+
+// pmr resource for a module's large arrays. Allocations of at least
+// minAllocationSize are bump-allocated from a VirtualMemoryRegion in whole
+// commit granules and committed as they are handed out. Freeing one returns
+// its memory to the OS but not its address space (unless it was the most
+// recent), so reserve several times the expected peak. Smaller allocations,
+// and everything once the reservation is used up, go to the upstream resource.
+class VirtualMemoryResource : public std::pmr::memory_resource {
+public:
+    // Only address space unless large pages are explicit; used when there is no budget
+    static constexpr size_t DefaultReserveSize = size_t(16) << 30;
+    static constexpr size_t DefaultMinAllocationSize = 512 * 1024;
+    // Freed address space is mostly not reused
+    static constexpr size_t BudgetReserveFactor = 4;
+    
+    // settings.reserveSize if set, otherwise BudgetReserveFactor times the hard
+    // limit, or the hard limit alone for explicit large pages since those are
+    // taken from the huge page pool at reservation
+    static size_t GetReserveSize(const VirtualMemorySettings& settings, size_t hardLimit);
+    
+    explicit VirtualMemoryResource(const VirtualMemorySettings& settings = {},
+                                   size_t reserveSize = DefaultReserveSize,
+                                   size_t minAllocationSize = DefaultMinAllocationSize,
+                                   std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    
+    const VirtualMemoryRegion& GetRegion() const { return m_region; }
+    // Bytes in live allocations served from the region
+    size_t GetLiveBytes() const;
+    
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    
+    VirtualMemoryRegion m_region;
+    std::pmr::memory_resource* m_upstream;
+    size_t m_minAllocationSize;
+    
+    mutable std::mutex m_mutex;
+    size_t m_top = 0;
+    size_t m_liveBytes = 0;
+    bool m_exhaustedLogged = false;
+};
+
+}
\ No newline at end of file
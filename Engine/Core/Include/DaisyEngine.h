@@ -5,15 +5,40 @@
 #include "Core/Logger.h"
 #include "Core/Memory.h"
 #include "Core/Math.h"
+#include "Core/JobSystem.h"
+#include "Core/Profiler.h"
 
 namespace Daisy {
 
+enum class RunMode {
+    Unpaced,        // Update back to back as fast as possible
+    Paced,          // Sleep between frames to hold targetFrameRate
+    Deterministic   // frameCount frames with a constant delta, no pacing
+};
+
+struct RunSettings {
+    RunMode mode = RunMode::Unpaced;
+    float targetFrameRate = 60.0f;          // Paced
+    uint64_t frameCount = 0;                // Deterministic, 0 runs until stopped
+    float fixedDeltaTime = 1.0f / 60.0f;    // Deterministic
+};
+
+struct FrameStats {
+    uint64_t frames = 0;
+    double elapsedSeconds = 0.0;
+    double minFrameMs = 0.0;            // Frame times include pacing
+    double averageFrameMs = 0.0;
+    double p99FrameMs = 0.0;            // Over the most recent frames only
+    double maxFrameMs = 0.0;
+    double averageUpdateMs = 0.0;       // Time spent inside Engine::Update
+};
+
 class DaisyEngine {
 public:
     static DaisyEngine& GetInstance();
     
     bool Initialize();
-    void Run();
+    void Run(const RunSettings& settings = {});
     void Shutdown();
     
     template<typename T>
@@ -21,11 +46,14 @@ public:
     
     Engine* GetEngine() { return m_engine.get(); }
     
+    const FrameStats& GetLastRunStats() const { return m_lastRunStats; }
+    
 private:
     DaisyEngine() = default;
     ~DaisyEngine() = default;
     
     std::unique_ptr<Engine> m_engine;
+    FrameStats m_lastRunStats;
     bool m_initialized = false;
 };
 
@@ -0,0 +1,474 @@
+#include "Core/BinaryLog.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <thread>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+namespace Daisy {
+
+namespace {
+    constexpr char BinaryLogMagic[8] = {'D', 'A', 'I', 'S', 'Y', 'L', 'O', 'G'};
+    constexpr uint32_t BinaryLogVersion = 1;
+    constexpr size_t MaxRecordSize = 64 * 1024;
+    constexpr size_t MaxArgs = 255;
+    
+    std::atomic<uint64_t> s_nextGeneration{1};
+    
+    constexpr size_t AlignRecord(size_t size) {
+        return (size + 7) & ~size_t(7);
+    }
+    
+    // Per-thread format ID cache so a known format costs one hash lookup and no lock
+    struct FormatIdCache {
+        const BinaryLogSink* sink = nullptr;
+        uint64_t generation = 0;
+        std::unordered_map<const char*, uint32_t> ids;
+    };
+    
+    thread_local FormatIdCache t_formatIds;
+    thread_local std::vector<uint8_t> t_record;
+    
+    void EncodeBytes(std::vector<uint8_t>& out, const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        out.insert(out.end(), bytes, bytes + size);
+    }
+    
+    template<typename T>
+    void EncodeValue(std::vector<uint8_t>& out, const T& value) {
+        EncodeBytes(out, &value, sizeof(T));
+    }
+    
+    void EncodeArg(std::vector<uint8_t>& out, const LogArg& arg) {
+        out.push_back(static_cast<uint8_t>(arg.type));
+        switch (arg.type) {
+            case LogArgType::Bool:     out.push_back(arg.boolean ? 1 : 0); break;
+            case LogArgType::Char:     out.push_back(static_cast<uint8_t>(arg.character)); break;
+            case LogArgType::Integer:  EncodeValue(out, static_cast<int64_t>(arg.integer)); break;
+            case LogArgType::Unsigned: EncodeValue(out, static_cast<uint64_t>(arg.unsignedInteger)); break;
+            case LogArgType::Float:    EncodeValue(out, arg.floating); break;
+            case LogArgType::Pointer:  EncodeValue(out, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(arg.pointer))); break;
+            case LogArgType::String: {
+                std::string_view text = arg.GetText();
+                size_t room = MaxRecordSize - std::min(MaxRecordSize, out.size() + sizeof(uint32_t));
+                uint32_t length = static_cast<uint32_t>(std::min(text.size(), room));
+                EncodeValue(out, length);
+                EncodeBytes(out, text.data(), length);
+                break;
+            }
+        }
+    }
+    
+    // Bounds-checked reads over one chunk; any overrun marks the record bad
+    struct RecordCursor {
+        const uint8_t* data;
+        size_t size;
+        size_t position = 0;
+        bool valid = true;
+        
+        template<typename T>
+        T Read() {
+            T value{};
+            if (position + sizeof(T) > size) {
+                valid = false;
+                return value;
+            }
+            std::memcpy(&value, data + position, sizeof(T));
+            position += sizeof(T);
+            return value;
+        }
+        
+        std::string_view ReadText(size_t length) {
+            if (position + length > size) {
+                valid = false;
+                return {};
+            }
+            std::string_view text(reinterpret_cast<const char*>(data + position), length);
+            position += length;
+            return text;
+        }
+    };
+}
+
+BinaryLogSink::BinaryLogSink() : m_chunks(std::make_unique<std::atomic<uint8_t*>[]>(MaxChunks)) {
+}
+
+BinaryLogSink::~BinaryLogSink() {
+    Close();
+}
+
+bool BinaryLogSink::Open(const std::string& path) {
+    Close();
+    
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    m_file = reinterpret_cast<intptr_t>(file);
+#else
+    int file = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (file < 0) {
+        return false;
+    }
+    m_file = file;
+#endif
+
+    m_fileSize = 0;
+    for (uint32_t i = 0; i < MaxChunks; ++i) {
+        m_chunks[i].store(nullptr, std::memory_order_relaxed);
+    }
+    
+    uint8_t* firstChunk = GetChunk(0);
+    if (!firstChunk) {
+        Close();
+        return false;
+    }
+    
+    m_steadyStart = std::chrono::steady_clock::now();
+    
+    BinaryLogHeader header{};
+    std::memcpy(header.magic, BinaryLogMagic, sizeof(header.magic));
+    header.version = BinaryLogVersion;
+    header.chunkSize = ChunkSize;
+    header.wallClockStartNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::memcpy(firstChunk, &header, sizeof(header));
+    
+    {
+        std::lock_guard<std::mutex> lock(m_formatMutex);
+        m_formatIds.clear();
+        m_nextFormatId = 1;
+    }
+    
+    m_generation = s_nextGeneration.fetch_add(1);
+    m_writePosition.store(AlignRecord(sizeof(BinaryLogHeader)));
+    m_open.store(true, std::memory_order_release);
+    return true;
+}
+
+void BinaryLogSink::Close() {
+    // Sequentially consistent with the writers' increment-then-check: a writer
+    // either sees the sink closed or is waited for here
+    m_open.store(false);
+    while (m_activeWriters.load() > 0) {
+        std::this_thread::yield();
+    }
+    
+    if (m_file == -1) {
+        return;
+    }
+    
+    UnmapAll();
+    
+    uint64_t finalSize = std::min(m_writePosition.load(), m_fileSize);
+#if defined(_WIN32)
+    HANDLE file = reinterpret_cast<HANDLE>(m_file);
+    LARGE_INTEGER size;
+    size.QuadPart = static_cast<LONGLONG>(finalSize);
+    SetFilePointerEx(file, size, nullptr, FILE_BEGIN);
+    SetEndOfFile(file);
+    CloseHandle(file);
+#else
+    if (::ftruncate(static_cast<int>(m_file), static_cast<off_t>(finalSize)) != 0) {
+        // The tail stays zero-filled, which the reader treats as padding
+    }
+    ::close(static_cast<int>(m_file));
+#endif
+
+    m_file = -1;
+    m_fileSize = 0;
+    m_writePosition.store(0);
+}
+
+void BinaryLogSink::Write(LogChannel channel, LogLevel level, std::string_view format, const LogArg* args, size_t count) {
+    m_activeWriters.fetch_add(1);
+    if (m_open.load()) {
+        WriteRecord(channel, level, BinaryLogRecordType::Message, GetFormatId(format), {}, args, count);
+    }
+    m_activeWriters.fetch_sub(1);
+}
+
+void BinaryLogSink::WriteVerbatim(LogChannel channel, LogLevel level, std::string_view message) {
+    m_activeWriters.fetch_add(1);
+    if (m_open.load()) {
+        LogArg arg;
+        arg.type = LogArgType::String;
+        arg.text = message;
+        WriteRecord(channel, level, BinaryLogRecordType::Message, 0, {}, &arg, 1);
+    }
+    m_activeWriters.fetch_sub(1);
+}
+
+uint32_t BinaryLogSink::GetFormatId(std::string_view format) {
+    FormatIdCache& cache = t_formatIds;
+    if (cache.sink != this || cache.generation != m_generation) {
+        cache.sink = this;
+        cache.generation = m_generation;
+        cache.ids.clear();
+    }
+    
+    // Format strings are literals, so their address identifies them
+    auto cached = cache.ids.find(format.data());
+    if (cached != cache.ids.end()) {
+        return cached->second;
+    }
+    
+    uint32_t id;
+    {
+        std::lock_guard<std::mutex> lock(m_formatMutex);
+        auto it = m_formatIds.find(format.data());
+        if (it != m_formatIds.end()) {
+            id = it->second;
+        } else {
+            // The definition is committed before the ID is published, so it
+            // always precedes the first message that uses it in the file
+            id = m_nextFormatId++;
+            WriteRecord(LogChannel::General, LogLevel::Debug, BinaryLogRecordType::Format, id, format, nullptr, 0);
+            m_formatIds.emplace(format.data(), id);
+        }
+    }
+    
+    cache.ids.emplace(format.data(), id);
+    return id;
+}
+
+void BinaryLogSink::WriteRecord(LogChannel channel, LogLevel level, BinaryLogRecordType type, uint32_t formatId,
+                                std::string_view text, const LogArg* args, size_t count) {
+    std::vector<uint8_t>& record = t_record;
+    record.clear();
+    record.resize(sizeof(BinaryLogRecordHeader));
+    
+    count = std::min(count, MaxArgs);
+    if (type == BinaryLogRecordType::Format) {
+        EncodeBytes(record, text.data(), std::min(text.size(), MaxRecordSize - record.size()));
+    }
+    for (size_t i = 0; i < count; ++i) {
+        EncodeArg(record, args[i]);
+    }
+    
+    BinaryLogRecordHeader header{};
+    header.type = type;
+    header.level = static_cast<uint8_t>(level);
+    header.channel = static_cast<uint8_t>(channel);
+    header.argCount = static_cast<uint16_t>(count);
+    header.size = static_cast<uint32_t>(record.size());
+    header.formatId = formatId;
+    header.timestampNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - m_steadyStart).count());
+    std::memcpy(record.data(), &header, sizeof(header));
+    
+    Commit(record.data(), record.size());
+}
+
+void BinaryLogSink::Commit(const uint8_t* data, size_t size) {
+    size_t alignedSize = AlignRecord(size);
+    
+    for (;;) {
+        uint64_t position = m_writePosition.fetch_add(alignedSize, std::memory_order_relaxed);
+        uint64_t chunkIndex = position / ChunkSize;
+        uint64_t chunkOffset = position % ChunkSize;
+        
+        // A reservation crossing the boundary is abandoned. Its tail in this chunk
+        // stays zero; the part spilling into the next chunk is marked as padding.
+        if (chunkOffset + alignedSize > ChunkSize) {
+            if (uint8_t* nextChunk = GetChunk(chunkIndex + 1)) {
+                BinaryLogRecordHeader padding{};
+                padding.type = BinaryLogRecordType::Padding;
+                padding.size = static_cast<uint32_t>(chunkOffset + alignedSize - ChunkSize);
+                std::memcpy(nextChunk, &padding, offsetof(BinaryLogRecordHeader, formatId));
+            }
+            continue;
+        }
+        
+        uint8_t* chunk = GetChunk(chunkIndex);
+        if (!chunk) {
+            return;
+        }
+        
+        std::memcpy(chunk + chunkOffset, data, size);
+        return;
+    }
+}
+
+uint8_t* BinaryLogSink::GetChunk(uint64_t index) {
+    if (index >= MaxChunks) {
+        return nullptr;
+    }
+    
+    uint8_t* chunk = m_chunks[index].load(std::memory_order_acquire);
+    if (chunk) {
+        return chunk;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_chunkMutex);
+    chunk = m_chunks[index].load(std::memory_order_relaxed);
+    if (chunk) {
+        return chunk;
+    }
+    
+    uint64_t offset = index * ChunkSize;
+    uint64_t requiredSize = std::max(m_fileSize, offset + ChunkSize);
+    
+#if defined(_WIN32)
+    // Creating a mapping larger than the file grows the file
+    HANDLE mapping = CreateFileMappingA(reinterpret_cast<HANDLE>(m_file), nullptr, PAGE_READWRITE,
+                                        static_cast<DWORD>(requiredSize >> 32),
+                                        static_cast<DWORD>(requiredSize & 0xFFFFFFFF), nullptr);
+    if (!mapping) {
+        return nullptr;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_WRITE, static_cast<DWORD>(offset >> 32),
+                               static_cast<DWORD>(offset & 0xFFFFFFFF), ChunkSize);
+    CloseHandle(mapping);
+    if (!view) {
+        return nullptr;
+    }
+#else
+    if (requiredSize > m_fileSize && ::ftruncate(static_cast<int>(m_file), static_cast<off_t>(requiredSize)) != 0) {
+        return nullptr;
+    }
+    void* view = ::mmap(nullptr, ChunkSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+                        static_cast<int>(m_file), static_cast<off_t>(offset));
+    if (view == MAP_FAILED) {
+        return nullptr;
+    }
+#endif
+
+    m_fileSize = requiredSize;
+    chunk = static_cast<uint8_t*>(view);
+    m_chunks[index].store(chunk, std::memory_order_release);
+    return chunk;
+}
+
+void BinaryLogSink::UnmapAll() {
+    // Chunks are only unmapped here: while the sink is open a stalled writer
+    // could still be copying into an old one. The OS writes dirty pages back.
+    std::lock_guard<std::mutex> lock(m_chunkMutex);
+    for (uint32_t i = 0; i < MaxChunks; ++i) {
+        uint8_t* chunk = m_chunks[i].exchange(nullptr);
+        if (!chunk) {
+            continue;
+        }
+#if defined(_WIN32)
+        UnmapViewOfFile(chunk);
+#else
+        ::munmap(chunk, ChunkSize);
+#endif
+    }
+}
+
+bool BinaryLogReader::Open(const std::string& path) {
+    m_file.open(path, std::ios::in | std::ios::binary);
+    if (!m_file.is_open()) {
+        m_error = "cannot open " + path;
+        return false;
+    }
+    
+    if (!m_file.read(reinterpret_cast<char*>(&m_header), sizeof(m_header)) ||
+        std::memcmp(m_header.magic, BinaryLogMagic, sizeof(BinaryLogMagic)) != 0) {
+        m_error = path + " is not a Daisy binary log";
+        return false;
+    }
+    
+    if (m_header.version != BinaryLogVersion || m_header.chunkSize == 0) {
+        m_error = "unsupported binary log version " + std::to_string(m_header.version);
+        return false;
+    }
+    
+    // Records in the first chunk start after the file header
+    m_file.seekg(0);
+    m_formats.clear();
+    LoadNextChunk();
+    m_offset = AlignRecord(sizeof(BinaryLogHeader));
+    return true;
+}
+
+bool BinaryLogReader::LoadNextChunk() {
+    m_chunk.resize(m_header.chunkSize);
+    m_file.read(reinterpret_cast<char*>(m_chunk.data()), m_header.chunkSize);
+    m_chunk.resize(static_cast<size_t>(m_file.gcount()));
+    m_offset = 0;
+    return !m_chunk.empty();
+}
+
+bool BinaryLogReader::Next(BinaryLogEntry& entry) {
+    for (;;) {
+        if (m_offset + sizeof(BinaryLogRecordHeader) > m_chunk.size() || m_chunk[m_offset] == 0) {
+            if (!LoadNextChunk()) {
+                return false;
+            }
+            continue;
+        }
+        
+        BinaryLogRecordHeader header;
+        std::memcpy(&header, m_chunk.data() + m_offset, sizeof(header));
+        
+        if (header.type == BinaryLogRecordType::Padding && header.size > 0) {
+            m_offset += AlignRecord(header.size);
+            continue;
+        }
+        
+        if (header.size < sizeof(header) || m_offset + header.size > m_chunk.size()) {
+            // Corrupt or torn record: nothing after it in this chunk can be trusted
+            m_offset = m_chunk.size();
+            continue;
+        }
+        
+        RecordCursor cursor{m_chunk.data() + m_offset, header.size, sizeof(header)};
+        m_offset += AlignRecord(header.size);
+        
+        if (header.type == BinaryLogRecordType::Format) {
+            m_formats[header.formatId] = std::string(cursor.ReadText(header.size - sizeof(header)));
+            continue;
+        }
+        if (header.type != BinaryLogRecordType::Message) {
+            continue;
+        }
+        
+        m_args.resize(header.argCount);
+        for (auto& arg : m_args) {
+            arg.type = static_cast<LogArgType>(cursor.Read<uint8_t>());
+            switch (arg.type) {
+                case LogArgType::Bool:     arg.boolean = cursor.Read<uint8_t>() != 0; break;
+                case LogArgType::Char:     arg.character = static_cast<char>(cursor.Read<uint8_t>()); break;
+                case LogArgType::Integer:  arg.integer = cursor.Read<int64_t>(); break;
+                case LogArgType::Unsigned: arg.unsignedInteger = cursor.Read<uint64_t>(); break;
+                case LogArgType::Float:    arg.floating = cursor.Read<double>(); break;
+                case LogArgType::Pointer:  arg.pointer = reinterpret_cast<const void*>(static_cast<uintptr_t>(cursor.Read<uint64_t>())); break;
+                case LogArgType::String:   arg.text = cursor.ReadText(cursor.Read<uint32_t>()); break;
+                default:                   cursor.valid = false; break;
+            }
+        }
+        if (!cursor.valid) {
+            continue;
+        }
+        
+        if (header.formatId == 0) {
+            entry.message = m_args.empty() ? std::string_view() : FormatLogMessage("{}", m_args.data(), m_args.size());
+        } else {
+            auto format = m_formats.find(header.formatId);
+            entry.message = format != m_formats.end()
+                ? FormatLogMessage(format->second, m_args.data(), m_args.size())
+                : FormatLogMessage("<unknown format>", nullptr, 0);
+        }
+        
+        entry.level = static_cast<LogLevel>(header.level);
+        entry.channel = header.channel < LogChannelCount ? static_cast<LogChannel>(header.channel) : LogChannel::General;
+        entry.time = std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::nanoseconds(m_header.wallClockStartNs + static_cast<int64_t>(header.timestampNs))));
+        return true;
+    }
+}
+
+}
\ No newline at end of file
@@ -1,8 +1,82 @@
 #include "DaisyEngine.h"
 #include "Core/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+    #include <timeapi.h>
+#endif
 
 namespace Daisy {
 
+namespace {
+    using Clock = std::chrono::steady_clock;
+    
+    // OS sleeps overshoot by up to a scheduler quantum; the tail is spun
+    constexpr auto SpinWaitWindow = std::chrono::microseconds(2000);
+    constexpr size_t FrameHistorySize = 1 << 16;
+    
+    void WaitUntil(Clock::time_point deadline) {
+        auto remaining = deadline - Clock::now();
+        if (remaining > SpinWaitWindow) {
+            std::this_thread::sleep_for(remaining - SpinWaitWindow);
+        }
+        
+        while (Clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+    }
+    
+    class FrameStatsCollector {
+    public:
+        FrameStatsCollector() {
+            m_history.reserve(FrameHistorySize);
+        }
+        
+        void AddFrame(double frameMs, double updateMs) {
+            if (m_history.size() < FrameHistorySize) {
+                m_history.push_back(static_cast<float>(frameMs));
+            } else {
+                m_history[m_stats.frames % FrameHistorySize] = static_cast<float>(frameMs);
+            }
+            
+            m_stats.minFrameMs = m_stats.frames == 0 ? frameMs : std::min(m_stats.minFrameMs, frameMs);
+            m_stats.maxFrameMs = std::max(m_stats.maxFrameMs, frameMs);
+            m_totalFrameMs += frameMs;
+            m_totalUpdateMs += updateMs;
+            m_stats.frames++;
+        }
+        
+        FrameStats Finish(double elapsedSeconds) {
+            m_stats.elapsedSeconds = elapsedSeconds;
+            if (m_stats.frames > 0) {
+                m_stats.averageFrameMs = m_totalFrameMs / m_stats.frames;
+                m_stats.averageUpdateMs = m_totalUpdateMs / m_stats.frames;
+                
+                size_t p99Index = std::min(m_history.size() - 1, (m_history.size() * 99) / 100);
+                std::nth_element(m_history.begin(), m_history.begin() + p99Index, m_history.end());
+                m_stats.p99FrameMs = m_history[p99Index];
+            }
+            return m_stats;
+        }
+        
+    private:
+        FrameStats m_stats;
+        std::vector<float> m_history;
+        double m_totalFrameMs = 0.0;
+        double m_totalUpdateMs = 0.0;
+    };
+    
+    double ToMilliseconds(Clock::duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+}
+
 DaisyEngine& DaisyEngine::GetInstance() {
     static DaisyEngine instance;
     return instance;
@@ -15,6 +89,10 @@ bool DaisyEngine::Initialize() {
     }
     
     DAISY_LOG.Initialize();
+    // e.g. DAISY_LOG_CHANNELS="Streamer=Debug,Editor=Warning"
+    if (const char* channels = std::getenv("DAISY_LOG_CHANNELS")) {
+        DAISY_LOG.ConfigureChannels(channels);
+    }
     DAISY_INFO("Starting Daisy Engine initialization...");
     
     m_engine = std::make_unique<Engine>();
@@ -29,7 +107,7 @@ bool DaisyEngine::Initialize() {
     return true;
 }
 
-void DaisyEngine::Run() {
+void DaisyEngine::Run(const RunSettings& settings) {
     if (!m_initialized) {
         DAISY_ERROR("DaisyEngine not initialized. Call Initialize() first.");
         return;
@@ -37,11 +115,67 @@ void DaisyEngine::Run() {
     
     DAISY_INFO("Starting main engine loop...");
     
+    bool paced = settings.mode == RunMode::Paced && settings.targetFrameRate > 0.0f;
+    bool deterministic = settings.mode == RunMode::Deterministic;
+    auto framePeriod = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(paced ? 1.0 / settings.targetFrameRate : 0.0));
+    
+#if defined(_WIN32)
+    // The default 15.6ms timer granularity is coarser than a frame
+    if (paced) {
+        timeBeginPeriod(1);
+    }
+#endif
+
+    FrameStatsCollector collector;
+    auto runStart = Clock::now();
+    auto frameStart = runStart;
+    auto nextFrame = runStart + framePeriod;
+    
+    uint64_t frames = 0;
     while (m_engine->IsRunning()) {
-        m_engine->Update();
+        if (deterministic && settings.frameCount > 0 && frames >= settings.frameCount) {
+            break;
+        }
+        frames++;
+        
+        if (deterministic) {
+            m_engine->Update(settings.fixedDeltaTime);
+        } else {
+            m_engine->Update();
+        }
+        
+        auto updateEnd = Clock::now();
+        
+        if (paced) {
+            // Deadlines advance by whole periods so sleep error does not drift the rate;
+            // after a long stall the schedule restarts instead of bursting to catch up
+            if (updateEnd > nextFrame + framePeriod) {
+                nextFrame = updateEnd;
+            } else {
+                WaitUntil(nextFrame);
+            }
+            nextFrame += framePeriod;
+        }
+        
+        auto frameEnd = Clock::now();
+        collector.AddFrame(ToMilliseconds(frameEnd - frameStart), ToMilliseconds(updateEnd - frameStart));
+        frameStart = frameEnd;
+    }
+    
+#if defined(_WIN32)
+    if (paced) {
+        timeEndPeriod(1);
     }
+#endif
+
+    m_lastRunStats = collector.Finish(std::chrono::duration<double>(Clock::now() - runStart).count());
     
     DAISY_INFO("Engine loop ended");
+    DAISY_INFO("Frame stats: {} frames in {}s, frame ms min {} / avg {} / p99 {} / max {}, update avg {}ms",
+        m_lastRunStats.frames, m_lastRunStats.elapsedSeconds,
+        m_lastRunStats.minFrameMs, m_lastRunStats.averageFrameMs,
+        m_lastRunStats.p99FrameMs, m_lastRunStats.maxFrameMs, m_lastRunStats.averageUpdateMs);
 }
 
 void DaisyEngine::Shutdown() {
@@ -58,6 +192,7 @@ void DaisyEngine::Shutdown() {
     
     m_initialized = false;
     DAISY_INFO("DaisyEngine shutdown complete");
+    DAISY_LOG.Flush();
 }
 
 }
\ No newline at end of file
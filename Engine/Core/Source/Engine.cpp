@@ -1,11 +1,17 @@
 #include "Core/Engine.h"
 #include "Core/Logger.h"
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <thread>
 
 namespace Daisy {
 
 Engine::Engine() {
     m_lastFrameTime = std::chrono::high_resolution_clock::now();
+    
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    m_workerThreadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
 }
 
 Engine::~Engine() {
@@ -22,16 +28,19 @@ bool Engine::Initialize() {
     
     DAISY_INFO("Initializing Daisy Engine...");
     
-    for (auto& typeIndex : m_moduleOrder) {
-        auto& module = m_modules[typeIndex];
+    for (auto& module : m_modules) {
         DAISY_INFO("Initializing module: {}", module->GetName());
         
+        DAISY_MEMORY_TAG_SCOPE(module->GetMemoryTag());
         if (!module->Initialize()) {
             DAISY_ERROR("Failed to initialize module: {}", module->GetName());
             return false;
         }
     }
     
+    m_jobSystem.Initialize(m_workerThreadCount);
+    m_scheduleDirty = true;
+    
     m_initialized = true;
     m_running = true;
     
@@ -45,13 +54,61 @@ void Engine::Update() {
     }
     
     CalculateDeltaTime();
+    RunFrame();
+}
+
+void Engine::Update(float deltaTime) {
+    if (!m_initialized || !m_running) {
+        return;
+    }
     
-    for (auto& typeIndex : m_moduleOrder) {
-        auto& module = m_modules[typeIndex];
-        if (module->IsInitialized()) {
-            module->Update(m_deltaTime);
-        }
+    m_deltaTime = deltaTime;
+    m_lastFrameTime = std::chrono::high_resolution_clock::now();
+    RunFrame();
+}
+
+void Engine::RunFrame() {
+    if (m_scheduleDirty) {
+        RebuildSchedule();
     }
+    
+    {
+        DAISY_PROFILE_SCOPE("Frame");
+        StepModules();
+    }
+    
+    Profiler::GetInstance().EndFrame();
+    
+    // Every module has finished, so no thread is allocating
+    m_frameArena.Reset();
+    m_doubleBufferedFrameArena.Reset();
+}
+
+void Engine::StepModules() {
+    if (!m_timestep.fixedTimestep) {
+        m_scheduler.Execute(m_deltaTime, ModuleTick::Both);
+        m_simulationTick++;
+        return;
+    }
+    
+    float fixedDeltaTime = GetFixedDeltaTime();
+    m_accumulator += m_deltaTime;
+    
+    uint32_t steps = 0;
+    while (m_accumulator >= fixedDeltaTime && steps < m_timestep.maxCatchUpSteps) {
+        m_scheduler.Execute(fixedDeltaTime, ModuleTick::Fixed);
+        m_accumulator -= fixedDeltaTime;
+        m_simulationTick++;
+        steps++;
+    }
+    
+    // Drop the backlog after a hitch instead of spiralling into ever longer frames
+    if (m_accumulator >= fixedDeltaTime) {
+        m_accumulator = std::fmod(m_accumulator, fixedDeltaTime);
+    }
+    
+    m_interpolationAlpha = m_accumulator / fixedDeltaTime;
+    m_scheduler.Execute(m_deltaTime, ModuleTick::Variable);
 }
 
 void Engine::Shutdown() {
@@ -61,8 +118,10 @@ void Engine::Shutdown() {
     
     DAISY_INFO("Shutting down Daisy Engine...");
     
-    for (auto it = m_moduleOrder.rbegin(); it != m_moduleOrder.rend(); ++it) {
-        auto& module = m_modules[*it];
+    m_jobSystem.Shutdown();
+    
+    for (auto it = m_modules.rbegin(); it != m_modules.rend(); ++it) {
+        auto& module = *it;
         if (module->IsInitialized()) {
             DAISY_INFO("Shutting down module: {}", module->GetName());
             module->Shutdown();
@@ -70,13 +129,90 @@ void Engine::Shutdown() {
     }
     
     m_modules.clear();
-    m_moduleOrder.clear();
+    m_moduleSlots.clear();
     m_initialized = false;
     m_running = false;
     
     DAISY_INFO("Daisy Engine shut down successfully");
 }
 
+void Engine::SetTimestepSettings(const TimestepSettings& settings) {
+    m_timestep = settings;
+    m_timestep.simulationRate = std::max(settings.simulationRate, 1.0f);
+    m_timestep.maxCatchUpSteps = std::max(settings.maxCatchUpSteps, 1u);
+    m_accumulator = 0.0f;
+    m_interpolationAlpha = 0.0f;
+}
+
+std::chrono::nanoseconds Engine::GetTimeUntilNextTick() const {
+    if (!m_timestep.fixedTimestep) {
+        return std::chrono::nanoseconds(0);
+    }
+    
+    auto untilTick = std::chrono::duration<float>(GetFixedDeltaTime() - m_accumulator);
+    auto nextTickTime = m_lastFrameTime + std::chrono::duration_cast<std::chrono::nanoseconds>(untilTick);
+    auto remaining = nextTickTime - std::chrono::high_resolution_clock::now();
+    
+    return std::max(std::chrono::duration_cast<std::chrono::nanoseconds>(remaining), std::chrono::nanoseconds(0));
+}
+
+std::vector<MemoryBudgetStats> Engine::GetModuleMemoryStats() const {
+    std::vector<MemoryBudgetStats> stats;
+    stats.reserve(m_modules.size());
+    
+    for (const auto& module : m_modules) {
+        stats.push_back(module->GetMemoryResource().GetStats());
+    }
+    return stats;
+}
+
+void Engine::SetWorkerThreadCount(uint32_t count) {
+    m_workerThreadCount = count;
+    
+    if (m_initialized) {
+        m_jobSystem.Initialize(m_workerThreadCount);
+        m_scheduleDirty = true;
+    }
+}
+
+void Engine::AddModule(std::unique_ptr<Module> module) {
+    module->m_memoryTag = MemoryTracker::GetInstance().RegisterTag(module->GetName());
+    
+    ModuleTypeId typeId = module->GetTypeId();
+    if (typeId >= m_moduleSlots.size()) {
+        m_moduleSlots.resize(typeId + 1, nullptr);
+    }
+    
+    // Registering a type twice replaces the earlier instance in place
+    Module* existing = m_moduleSlots[typeId];
+    m_moduleSlots[typeId] = module.get();
+    
+    auto it = std::find_if(m_modules.begin(), m_modules.end(),
+        [existing](const std::unique_ptr<Module>& registered) {
+            return registered.get() == existing;
+        });
+        
+    if (existing && it != m_modules.end()) {
+        *it = std::move(module);
+    } else {
+        m_modules.push_back(std::move(module));
+    }
+    
+    m_scheduleDirty = true;
+}
+
+void Engine::RebuildSchedule() {
+    std::vector<Module*> modules;
+    modules.reserve(m_modules.size());
+    
+    for (auto& module : m_modules) {
+        modules.push_back(module.get());
+    }
+    
+    m_scheduler.Build(modules);
+    m_scheduleDirty = false;
+}
+
 void Engine::CalculateDeltaTime() {
     auto currentTime = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(currentTime - m_lastFrameTime);
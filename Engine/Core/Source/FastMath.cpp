@@ -0,0 +1,224 @@
+#include "Core/FastMath.h"
+
+namespace Daisy::FastMath {
+
+namespace {
+
+#if defined(DAISY_SIMD_SSE41)
+    template<Accuracy A>
+    inline __m128 InverseSqrt4(__m128 x) {
+        __m128 estimate = _mm_rsqrt_ps(x);
+        if constexpr (A == Accuracy::Fast) {
+            __m128 halfX = _mm_mul_ps(_mm_set1_ps(0.5f), x);
+            __m128 correction = _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(halfX, _mm_mul_ps(estimate, estimate)));
+            estimate = _mm_mul_ps(estimate, correction);
+        }
+        return estimate;
+    }
+    
+    template<Accuracy A>
+    inline void SinCos4(__m128 x, __m128& sin, __m128& cos) {
+        // Same reduction as the scalar SinCos, rounding to nearest even
+        __m128i n = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(Detail::TwoOverPi)));
+        __m128 fn = _mm_cvtepi32_ps(n);
+        __m128 r = _mm_sub_ps(x, _mm_mul_ps(fn, _mm_set1_ps(Detail::PiOverTwoHigh)));
+        r = _mm_sub_ps(r, _mm_mul_ps(fn, _mm_set1_ps(Detail::PiOverTwoMid)));
+        r = _mm_sub_ps(r, _mm_mul_ps(fn, _mm_set1_ps(Detail::PiOverTwoLow)));
+        
+        __m128 r2 = _mm_mul_ps(r, r);
+        __m128 sinR, cosR;
+        if constexpr (A == Accuracy::Fast) {
+            __m128 s = _mm_add_ps(_mm_set1_ps(Detail::Sin2), _mm_mul_ps(r2, _mm_set1_ps(Detail::Sin3)));
+            s = _mm_add_ps(_mm_set1_ps(Detail::Sin1), _mm_mul_ps(r2, s));
+            sinR = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), s));
+            __m128 c = _mm_add_ps(_mm_set1_ps(Detail::Cos2), _mm_mul_ps(r2, _mm_set1_ps(Detail::Cos3)));
+            c = _mm_add_ps(_mm_set1_ps(Detail::Cos1), _mm_mul_ps(r2, c));
+            cosR = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), r2)),
+                              _mm_mul_ps(_mm_mul_ps(r2, r2), c));
+        } else {
+            __m128 s = _mm_add_ps(_mm_set1_ps(-1.0f / 6.0f), _mm_mul_ps(r2, _mm_set1_ps(1.0f / 120.0f)));
+            sinR = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), s));
+            __m128 c = _mm_add_ps(_mm_set1_ps(-0.5f), _mm_mul_ps(r2, _mm_set1_ps(1.0f / 24.0f)));
+            cosR = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(r2, c));
+        }
+        
+        __m128i one = _mm_set1_epi32(1);
+        __m128i two = _mm_set1_epi32(2);
+        __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(n, one), one));
+        __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(n, two), 30));
+        __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(n, one), two), 30));
+        sin = _mm_xor_ps(_mm_blendv_ps(sinR, cosR, swap), sinSign);
+        cos = _mm_xor_ps(_mm_blendv_ps(cosR, sinR, swap), cosSign);
+    }
+    
+    // Lanes the reduction cannot handle (including NaN), as a movemask
+    inline int OutOfRange4(__m128 x) {
+        __m128 magnitude = _mm_andnot_ps(_mm_set1_ps(-0.0f), x);
+        return _mm_movemask_ps(_mm_cmpnle_ps(magnitude, _mm_set1_ps(SinCosRangeLimit)));
+    }
+    
+    // Recomputes the lanes flagged in mask with the standard library
+    void FixOutOfRange(const float* angles, float* sin, float* cos, int mask) {
+        for (int lane = 0; mask != 0; ++lane, mask >>= 1) {
+            if (mask & 1) {
+                sin[lane] = std::sin(angles[lane]);
+                cos[lane] = std::cos(angles[lane]);
+            }
+        }
+    }
+#endif
+
+#if defined(DAISY_SIMD_AVX2)
+    template<Accuracy A>
+    inline __m256 InverseSqrt8(__m256 x) {
+        __m256 estimate = _mm256_rsqrt_ps(x);
+        if constexpr (A == Accuracy::Fast) {
+            __m256 halfX = _mm256_mul_ps(_mm256_set1_ps(0.5f), x);
+            __m256 correction = _mm256_sub_ps(_mm256_set1_ps(1.5f), _mm256_mul_ps(halfX, _mm256_mul_ps(estimate, estimate)));
+            estimate = _mm256_mul_ps(estimate, correction);
+        }
+        return estimate;
+    }
+    
+    template<Accuracy A>
+    inline void SinCos8(__m256 x, __m256& sin, __m256& cos) {
+        __m256i n = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(Detail::TwoOverPi)));
+        __m256 fn = _mm256_cvtepi32_ps(n);
+        __m256 r = _mm256_sub_ps(x, _mm256_mul_ps(fn, _mm256_set1_ps(Detail::PiOverTwoHigh)));
+        r = _mm256_sub_ps(r, _mm256_mul_ps(fn, _mm256_set1_ps(Detail::PiOverTwoMid)));
+        r = _mm256_sub_ps(r, _mm256_mul_ps(fn, _mm256_set1_ps(Detail::PiOverTwoLow)));
+        
+        __m256 r2 = _mm256_mul_ps(r, r);
+        __m256 sinR, cosR;
+        if constexpr (A == Accuracy::Fast) {
+            __m256 s = _mm256_add_ps(_mm256_set1_ps(Detail::Sin2), _mm256_mul_ps(r2, _mm256_set1_ps(Detail::Sin3)));
+            s = _mm256_add_ps(_mm256_set1_ps(Detail::Sin1), _mm256_mul_ps(r2, s));
+            sinR = _mm256_add_ps(r, _mm256_mul_ps(_mm256_mul_ps(r, r2), s));
+            __m256 c = _mm256_add_ps(_mm256_set1_ps(Detail::Cos2), _mm256_mul_ps(r2, _mm256_set1_ps(Detail::Cos3)));
+            c = _mm256_add_ps(_mm256_set1_ps(Detail::Cos1), _mm256_mul_ps(r2, c));
+            cosR = _mm256_add_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(_mm256_set1_ps(0.5f), r2)),
+                                 _mm256_mul_ps(_mm256_mul_ps(r2, r2), c));
+        } else {
+            __m256 s = _mm256_add_ps(_mm256_set1_ps(-1.0f / 6.0f), _mm256_mul_ps(r2, _mm256_set1_ps(1.0f / 120.0f)));
+            sinR = _mm256_add_ps(r, _mm256_mul_ps(_mm256_mul_ps(r, r2), s));
+            __m256 c = _mm256_add_ps(_mm256_set1_ps(-0.5f), _mm256_mul_ps(r2, _mm256_set1_ps(1.0f / 24.0f)));
+            cosR = _mm256_add_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(r2, c));
+        }
+        
+        __m256i one = _mm256_set1_epi32(1);
+        __m256i two = _mm256_set1_epi32(2);
+        __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(n, one), one));
+        __m256 sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(n, two), 30));
+        __m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(n, one), two), 30));
+        sin = _mm256_xor_ps(_mm256_blendv_ps(sinR, cosR, swap), sinSign);
+        cos = _mm256_xor_ps(_mm256_blendv_ps(cosR, sinR, swap), cosSign);
+    }
+    
+    inline int OutOfRange8(__m256 x) {
+        __m256 magnitude = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), x);
+        return _mm256_movemask_ps(_mm256_cmp_ps(magnitude, _mm256_set1_ps(SinCosRangeLimit), _CMP_NLE_UQ));
+    }
+#endif
+}
+
+template<Accuracy A>
+void InverseSqrt(const float* values, float* out, size_t count) {
+    size_t i = 0;
+    if constexpr (A != Accuracy::Exact) {
+#if defined(DAISY_SIMD_AVX2)
+        for (; i + 8 <= count; i += 8) {
+            _mm256_storeu_ps(out + i, InverseSqrt8<A>(_mm256_loadu_ps(values + i)));
+        }
+#endif
+#if defined(DAISY_SIMD_SSE41)
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_ps(out + i, InverseSqrt4<A>(_mm_loadu_ps(values + i)));
+        }
+#endif
+    }
+    for (; i < count; ++i) {
+        out[i] = InverseSqrt<A>(values[i]);
+    }
+}
+
+template<Accuracy A>
+void SinCos(const float* angles, float* sin, float* cos, size_t count) {
+    size_t i = 0;
+    if constexpr (A != Accuracy::Exact) {
+#if defined(DAISY_SIMD_AVX2)
+        for (; i + 8 <= count; i += 8) {
+            __m256 x = _mm256_loadu_ps(angles + i);
+            __m256 s, c;
+            SinCos8<A>(x, s, c);
+            _mm256_storeu_ps(sin + i, s);
+            _mm256_storeu_ps(cos + i, c);
+            if (int outside = OutOfRange8(x)) {
+                FixOutOfRange(angles + i, sin + i, cos + i, outside);
+            }
+        }
+#endif
+#if defined(DAISY_SIMD_SSE41)
+        for (; i + 4 <= count; i += 4) {
+            __m128 x = _mm_loadu_ps(angles + i);
+            __m128 s, c;
+            SinCos4<A>(x, s, c);
+            _mm_storeu_ps(sin + i, s);
+            _mm_storeu_ps(cos + i, c);
+            if (int outside = OutOfRange4(x)) {
+                FixOutOfRange(angles + i, sin + i, cos + i, outside);
+            }
+        }
+#endif
+    }
+    for (; i < count; ++i) {
+        SinCos<A>(angles[i], sin[i], cos[i]);
+    }
+}
+
+template<Accuracy A>
+void Normalize(Simd::Vector3Stream v, size_t count) {
+    size_t i = 0;
+    if constexpr (A != Accuracy::Exact) {
+#if defined(DAISY_SIMD_AVX2)
+        for (; i + 8 <= count; i += 8) {
+            __m256 x = _mm256_loadu_ps(v.x + i), y = _mm256_loadu_ps(v.y + i), z = _mm256_loadu_ps(v.z + i);
+            __m256 lengthSquared = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z));
+            // Zero lanes give an infinite estimate; the mask turns them back into zeros
+            __m256 valid = _mm256_cmp_ps(lengthSquared, _mm256_setzero_ps(), _CMP_GT_OQ);
+            __m256 scale = _mm256_and_ps(InverseSqrt8<A>(lengthSquared), valid);
+            _mm256_storeu_ps(v.x + i, _mm256_mul_ps(x, scale));
+            _mm256_storeu_ps(v.y + i, _mm256_mul_ps(y, scale));
+            _mm256_storeu_ps(v.z + i, _mm256_mul_ps(z, scale));
+        }
+#endif
+#if defined(DAISY_SIMD_SSE41)
+        for (; i + 4 <= count; i += 4) {
+            __m128 x = _mm_loadu_ps(v.x + i), y = _mm_loadu_ps(v.y + i), z = _mm_loadu_ps(v.z + i);
+            __m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+            __m128 valid = _mm_cmpgt_ps(lengthSquared, _mm_setzero_ps());
+            __m128 scale = _mm_and_ps(InverseSqrt4<A>(lengthSquared), valid);
+            _mm_storeu_ps(v.x + i, _mm_mul_ps(x, scale));
+            _mm_storeu_ps(v.y + i, _mm_mul_ps(y, scale));
+            _mm_storeu_ps(v.z + i, _mm_mul_ps(z, scale));
+        }
+#endif
+    }
+    for (; i < count; ++i) {
+        Vector3 normalized = Normalize<A>(Vector3(v.x[i], v.y[i], v.z[i]));
+        v.x[i] = normalized.x;
+        v.y[i] = normalized.y;
+        v.z[i] = normalized.z;
+    }
+}
+
+template void InverseSqrt<Accuracy::Exact>(const float*, float*, size_t);
+template void InverseSqrt<Accuracy::Fast>(const float*, float*, size_t);
+template void InverseSqrt<Accuracy::Approximate>(const float*, float*, size_t);
+template void SinCos<Accuracy::Exact>(const float*, float*, float*, size_t);
+template void SinCos<Accuracy::Fast>(const float*, float*, float*, size_t);
+template void SinCos<Accuracy::Approximate>(const float*, float*, float*, size_t);
+template void Normalize<Accuracy::Exact>(Simd::Vector3Stream, size_t);
+template void Normalize<Accuracy::Fast>(Simd::Vector3Stream, size_t);
+template void Normalize<Accuracy::Approximate>(Simd::Vector3Stream, size_t);
+
+}
\ No newline at end of file
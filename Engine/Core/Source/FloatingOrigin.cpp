@@ -0,0 +1,39 @@
+#include "Core/FloatingOrigin.h"
+#include "Core/Logger.h"
+#include <algorithm>
+
+namespace Daisy {
+
+bool FloatingOrigin::Update(const DVector3& observer) {
+    if ((observer - m_origin).LengthSquared() <= m_rebaseDistance * m_rebaseDistance) {
+        return false;
+    }
+    
+    SetOrigin(observer);
+    return true;
+}
+
+void FloatingOrigin::SetOrigin(const DVector3& origin) {
+    DVector3 previous = m_origin;
+    m_origin = origin;
+    m_rebaseCount++;
+    
+    DAISY_DEBUG("Floating origin rebased to ({:.1f}, {:.1f}, {:.1f})", origin.x, origin.y, origin.z);
+    
+    for (const auto& listener : m_listeners) {
+        listener.second(previous, m_origin);
+    }
+}
+
+uint32_t FloatingOrigin::AddRebaseListener(RebaseCallback callback) {
+    uint32_t id = m_nextListenerId++;
+    m_listeners.emplace_back(id, std::move(callback));
+    return id;
+}
+
+void FloatingOrigin::RemoveRebaseListener(uint32_t id) {
+    m_listeners.erase(std::remove_if(m_listeners.begin(), m_listeners.end(),
+        [id](const auto& listener) { return listener.first == id; }), m_listeners.end());
+}
+
+}
\ No newline at end of file
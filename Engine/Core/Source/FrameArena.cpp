@@ -0,0 +1,194 @@
+#include "Core/FrameArena.h"
+#include <algorithm>
+#include <new>
+
+namespace Daisy {
+
+namespace {
+    constexpr size_t ThreadCacheSize = 4;
+    
+    // Recently used arenas on this thread, so switching between the engine's
+    // frame arenas does not fall back to the registry lookup
+    struct ThreadArenaCache {
+        uint64_t owners[ThreadCacheSize] = {};
+        void* arenas[ThreadCacheSize] = {};
+        uint32_t next = 0;
+    };
+    
+    // Marks every arena this thread registered with as retired when it exits
+    struct ThreadArenaRetirer {
+        std::vector<std::shared_ptr<std::atomic<bool>>> flags;
+        
+        void Add(std::shared_ptr<std::atomic<bool>> flag) {
+            // Drop flags whose FrameArena is gone
+            flags.erase(std::remove_if(flags.begin(), flags.end(),
+                [](const auto& existing) { return existing.use_count() == 1; }), flags.end());
+            flags.push_back(std::move(flag));
+        }
+        
+        ~ThreadArenaRetirer() {
+            for (const auto& flag : flags) {
+                flag->store(true, std::memory_order_release);
+            }
+        }
+    };
+    
+    thread_local ThreadArenaCache t_arenaCache;
+    thread_local ThreadArenaRetirer t_arenaRetirer;
+    std::atomic<uint64_t> s_nextArenaId{1};
+}
+
+LinearArena::LinearArena(size_t blockSize) : m_blockSize(std::max<size_t>(blockSize, 4096)) {
+}
+
+LinearArena::~LinearArena() {
+    for (const Block& block : m_blocks) {
+        ::operator delete(block.data, std::align_val_t(alignof(std::max_align_t)));
+    }
+}
+
+void* LinearArena::AllocateSlow(size_t size, size_t alignment) {
+    size_t required = size + alignment;
+    
+    // Move on to the next retained block that fits before adding a new one
+    size_t next = m_blocks.empty() ? 0 : m_currentBlock + 1;
+    while (next < m_blocks.size() && m_blocks[next].size < required) {
+        ++next;
+    }
+    
+    if (next >= m_blocks.size()) {
+        Block block;
+        block.size = std::max(m_blockSize, required);
+        block.data = static_cast<std::byte*>(::operator new(block.size, std::align_val_t(alignof(std::max_align_t))));
+        m_blocks.push_back(block);
+        next = m_blocks.size() - 1;
+    }
+    
+    if (!m_blocks.empty() && m_end != 0) {
+        m_usedInFullBlocks += m_cursor - reinterpret_cast<uintptr_t>(m_blocks[m_currentBlock].data);
+    }
+    UseBlock(next);
+    
+    return Allocate(size, alignment);
+}
+
+void LinearArena::UseBlock(size_t index) {
+    m_currentBlock = index;
+    m_cursor = reinterpret_cast<uintptr_t>(m_blocks[index].data);
+    m_end = m_cursor + m_blocks[index].size;
+}
+
+void LinearArena::Reset() {
+    m_usedInFullBlocks = 0;
+    if (m_blocks.empty()) {
+        return;
+    }
+    UseBlock(0);
+}
+
+size_t LinearArena::GetBytesUsed() const {
+    if (m_blocks.empty()) {
+        return 0;
+    }
+    return m_usedInFullBlocks + (m_cursor - reinterpret_cast<uintptr_t>(m_blocks[m_currentBlock].data));
+}
+
+size_t LinearArena::GetCapacity() const {
+    size_t capacity = 0;
+    for (const Block& block : m_blocks) {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+FrameArena::FrameArena(FrameArenaBuffering buffering, size_t blockSize)
+    : m_id(s_nextArenaId.fetch_add(1, std::memory_order_relaxed))
+    , m_buffering(buffering)
+    , m_blockSize(blockSize) {
+}
+
+FrameArena::~FrameArena() = default;
+
+FrameArena::ThreadArena& FrameArena::GetThreadArena() {
+    ThreadArenaCache& cache = t_arenaCache;
+    for (size_t i = 0; i < ThreadCacheSize; ++i) {
+        if (cache.owners[i] == m_id) {
+            return *static_cast<ThreadArena*>(cache.arenas[i]);
+        }
+    }
+    
+    ThreadArena& arena = RegisterThread();
+    uint32_t slot = cache.next++ % ThreadCacheSize;
+    cache.owners[slot] = m_id;
+    cache.arenas[slot] = &arena;
+    return arena;
+}
+
+FrameArena::ThreadArena& FrameArena::RegisterThread() {
+    std::thread::id thread = std::this_thread::get_id();
+    
+    std::lock_guard<std::mutex> lock(m_threadsMutex);
+    for (auto& arena : m_threads) {
+        if (arena->thread == thread && !arena->retired->load(std::memory_order_acquire)) {
+            return *arena;
+        }
+    }
+    
+    // Take over an exited thread's arena; its cursors carry on, so memory it
+    // handed out this frame is not reused
+    ThreadArena* adopted = nullptr;
+    for (auto& arena : m_threads) {
+        bool retired = true;
+        if (arena->retired->compare_exchange_strong(retired, false, std::memory_order_acquire)) {
+            adopted = arena.get();
+            break;
+        }
+    }
+    
+    if (!adopted) {
+        m_threads.push_back(std::make_unique<ThreadArena>(m_blockSize));
+        adopted = m_threads.back().get();
+    }
+    adopted->thread = thread;
+    adopted->resetsSinceRetired = 0;
+    t_arenaRetirer.Add(adopted->retired);
+    return *adopted;
+}
+
+void FrameArena::Reset() {
+    std::lock_guard<std::mutex> lock(m_threadsMutex);
+    
+    size_t frameBytes = 0;
+    for (auto& arena : m_threads) {
+        frameBytes += arena->buffers[m_frameParity].GetBytesUsed();
+    }
+    m_lastFrameBytes.store(frameBytes, std::memory_order_relaxed);
+    m_peakFrameBytes.store(std::max(frameBytes, m_peakFrameBytes.load(std::memory_order_relaxed)),
+        std::memory_order_relaxed);
+    
+    // Double buffering flips to the other half and rewinds the memory from two frames ago
+    if (m_buffering == FrameArenaBuffering::Double) {
+        m_frameParity ^= 1;
+    }
+    for (auto& arena : m_threads) {
+        arena->buffers[m_frameParity].Reset();
+    }
+    
+    // Free arenas of exited threads once nothing they handed out is still valid
+    uint32_t expiredAfter = m_buffering == FrameArenaBuffering::Double ? 2 : 1;
+    m_threads.erase(std::remove_if(m_threads.begin(), m_threads.end(), [&](const auto& arena) {
+        return arena->retired->load(std::memory_order_acquire) && ++arena->resetsSinceRetired >= expiredAfter;
+    }), m_threads.end());
+}
+
+size_t FrameArena::GetCapacity() const {
+    std::lock_guard<std::mutex> lock(m_threadsMutex);
+    
+    size_t capacity = 0;
+    for (const auto& arena : m_threads) {
+        capacity += arena->buffers[0].GetCapacity() + arena->buffers[1].GetCapacity();
+    }
+    return capacity;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,321 @@
+#include "Core/JobSystem.h"
+#include <algorithm>
+
+namespace Daisy {
+
+struct Job {
+    std::function<void()> work;
+    std::shared_ptr<Job> parent;
+    
+    // Counts the job itself plus every child still running
+    std::atomic<uint32_t> unfinished{1};
+    // Starts at 1 so dependencies can be attached before the job is released
+    std::atomic<uint32_t> pendingDependencies{1};
+    
+    std::mutex continuationMutex;
+    std::vector<std::shared_ptr<Job>> continuations;
+    std::atomic<bool> complete{false};
+};
+
+namespace {
+    thread_local JobSystem* t_jobSystem = nullptr;
+    thread_local int t_workerIndex = -1;
+    thread_local std::shared_ptr<Job> t_currentJob;
+}
+
+bool JobHandle::IsComplete() const {
+    return !m_job || m_job->complete.load(std::memory_order_acquire);
+}
+
+JobSystem::~JobSystem() {
+    Shutdown();
+}
+
+void JobSystem::Initialize(uint32_t workerCount) {
+    Shutdown();
+    
+    m_stopping.store(false);
+    m_queuedJobs.store(0);
+    m_workerQueues.clear();
+    for (uint32_t i = 0; i < workerCount; ++i) {
+        m_workerQueues.push_back(std::make_unique<WorkQueue>());
+    }
+    
+    m_workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+}
+
+void JobSystem::Shutdown() {
+    // Drain outstanding work so no handle is left waiting forever
+    while (RunPendingJob()) {
+    }
+    
+    if (m_workers.empty()) {
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping.store(true);
+    }
+    m_sleepCondition.notify_all();
+    
+    // Workers empty their own deques before they exit, including children
+    // that jobs still running at this point spawn
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    
+    // Anything those last jobs submitted to the shared queue
+    while (RunPendingJob()) {
+    }
+    
+    m_workers.clear();
+    m_workerQueues.clear();
+    m_queuedJobs.store(0);
+}
+
+JobHandle JobSystem::Schedule(std::function<void()> work, std::span<const JobHandle> dependencies) {
+    auto job = std::make_shared<Job>();
+    job->work = std::move(work);
+    
+    for (const auto& dependency : dependencies) {
+        AddDependency(job, dependency);
+    }
+    
+    if (job->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        Enqueue(job);
+    }
+    
+    return JobHandle(job);
+}
+
+JobHandle JobSystem::ParallelFor(size_t begin, size_t end, size_t grainSize,
+                                 std::function<void(size_t, size_t)> body,
+                                 std::span<const JobHandle> dependencies) {
+    if (grainSize == 0) {
+        size_t chunks = std::max<size_t>(1, (m_workers.size() + 1) * 4);
+        grainSize = std::max<size_t>(1, (end - std::min(begin, end) + chunks - 1) / chunks);
+    }
+    
+    // The root job fans out the chunks once its dependencies are met; they
+    // register as its children so the handle covers the whole range
+    auto sharedBody = std::make_shared<std::function<void(size_t, size_t)>>(std::move(body));
+    return Schedule([this, begin, end, grainSize, sharedBody]() {
+        for (size_t chunkBegin = begin; chunkBegin < end; chunkBegin += grainSize) {
+            size_t chunkEnd = std::min(end, chunkBegin + grainSize);
+            SpawnChild([sharedBody, chunkBegin, chunkEnd]() { (*sharedBody)(chunkBegin, chunkEnd); });
+        }
+    }, dependencies);
+}
+
+void JobSystem::Wait(const JobHandle& handle) {
+    while (!handle.IsComplete()) {
+        if (RunPendingJob()) {
+            continue;
+        }
+        
+        // The job is running elsewhere; sleep until something finishes or
+        // becomes available to help with. Pairs with the fence in WakeWaiters.
+        m_waitingThreads.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        {
+            std::unique_lock<std::mutex> lock(m_waitMutex);
+            m_waitCondition.wait(lock, [this, &handle] {
+                return handle.IsComplete() || m_queuedJobs.load() > 0;
+            });
+        }
+        m_waitingThreads.fetch_sub(1);
+    }
+}
+
+void JobSystem::Wait(std::span<const JobHandle> handles) {
+    for (const auto& handle : handles) {
+        Wait(handle);
+    }
+}
+
+bool JobSystem::RunPendingJob() {
+    auto job = FindJob(CurrentWorkerIndex());
+    if (!job) {
+        return false;
+    }
+    
+    Execute(job);
+    return true;
+}
+
+void JobSystem::WorkerLoop(uint32_t workerIndex) {
+    t_jobSystem = this;
+    t_workerIndex = static_cast<int>(workerIndex);
+    
+    for (;;) {
+        if (auto job = FindJob(t_workerIndex)) {
+            Execute(job);
+            continue;
+        }
+        // Only stop once nothing is left, so no queued job loses its handle
+        if (m_stopping.load(std::memory_order_acquire)) {
+            break;
+        }
+        
+        m_sleepingWorkers.fetch_add(1);
+        {
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_sleepCondition.wait(lock, [this] {
+                return m_stopping.load() || m_queuedJobs.load() > 0;
+            });
+        }
+        m_sleepingWorkers.fetch_sub(1);
+    }
+    
+    t_jobSystem = nullptr;
+    t_workerIndex = -1;
+}
+
+void JobSystem::Enqueue(std::shared_ptr<Job> job) {
+    int workerIndex = CurrentWorkerIndex();
+    WorkQueue& queue = workerIndex >= 0 ? *m_workerQueues[workerIndex] : m_sharedQueue;
+    
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    
+    m_queuedJobs.fetch_add(1);
+    if (m_sleepingWorkers.load() > 0) {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_sleepCondition.notify_one();
+    }
+    WakeWaiters();
+}
+
+void JobSystem::Execute(const std::shared_ptr<Job>& job) {
+    std::shared_ptr<Job> previousJob = std::move(t_currentJob);
+    t_currentJob = job;
+    
+    job->work();
+    job->work = nullptr;
+    
+    t_currentJob = std::move(previousJob);
+    
+    if (job->unfinished.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        Finish(job);
+    }
+}
+
+void JobSystem::Finish(const std::shared_ptr<Job>& job) {
+    std::vector<std::shared_ptr<Job>> continuations;
+    {
+        std::lock_guard<std::mutex> lock(job->continuationMutex);
+        job->complete.store(true, std::memory_order_release);
+        continuations.swap(job->continuations);
+    }
+    WakeWaiters();
+    
+    for (auto& continuation : continuations) {
+        if (continuation->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            Enqueue(std::move(continuation));
+        }
+    }
+    
+    if (job->parent && job->parent->unfinished.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        Finish(job->parent);
+    }
+}
+
+void JobSystem::AddDependency(const std::shared_ptr<Job>& job, const JobHandle& dependency) {
+    if (!dependency.m_job) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(dependency.m_job->continuationMutex);
+    if (!dependency.m_job->complete.load(std::memory_order_acquire)) {
+        job->pendingDependencies.fetch_add(1, std::memory_order_relaxed);
+        dependency.m_job->continuations.push_back(job);
+    }
+}
+
+void JobSystem::SpawnChild(std::function<void()> work) {
+    auto job = std::make_shared<Job>();
+    job->work = std::move(work);
+    job->parent = t_currentJob;
+    job->pendingDependencies.store(0, std::memory_order_relaxed);
+    
+    if (job->parent) {
+        job->parent->unfinished.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    Enqueue(std::move(job));
+}
+
+void JobSystem::WakeWaiters() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_waitingThreads.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+        m_waitCondition.notify_all();
+    }
+}
+
+std::shared_ptr<Job> JobSystem::FindJob(int workerIndex) {
+    auto popBack = [this](WorkQueue& queue) -> std::shared_ptr<Job> {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) {
+            return nullptr;
+        }
+        auto job = std::move(queue.jobs.back());
+        queue.jobs.pop_back();
+        m_queuedJobs.fetch_sub(1);
+        return job;
+    };
+    
+    auto popFront = [this](WorkQueue& queue) -> std::shared_ptr<Job> {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) {
+            return nullptr;
+        }
+        auto job = std::move(queue.jobs.front());
+        queue.jobs.pop_front();
+        m_queuedJobs.fetch_sub(1);
+        return job;
+    };
+    
+    if (m_queuedJobs.load(std::memory_order_acquire) == 0) {
+        return nullptr;
+    }
+    
+    // Own work newest-first for cache locality, everything else oldest-first
+    if (workerIndex >= 0) {
+        if (auto job = popBack(*m_workerQueues[workerIndex])) {
+            return job;
+        }
+    }
+    
+    if (auto job = popFront(m_sharedQueue)) {
+        return job;
+    }
+    
+    size_t queueCount = m_workerQueues.size();
+    size_t start = workerIndex >= 0 ? static_cast<size_t>(workerIndex) + 1 : 0;
+    for (size_t i = 0; i < queueCount; ++i) {
+        size_t victim = (start + i) % queueCount;
+        if (static_cast<int>(victim) == workerIndex) {
+            continue;
+        }
+        if (auto job = popFront(*m_workerQueues[victim])) {
+            return job;
+        }
+    }
+    
+    return nullptr;
+}
+
+int JobSystem::CurrentWorkerIndex() const {
+    return t_jobSystem == this ? t_workerIndex : -1;
+}
+
+}
\ No newline at end of file
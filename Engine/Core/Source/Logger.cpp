@@ -1,83 +1,584 @@
 #include "Core/Logger.h"
+#include "Core/BinaryLog.h"
 #include <iostream>
 #include <chrono>
 #include <iomanip>
 #include <sstream>
+#include <vector>
+#include <algorithm>
+#include <charconv>
+#include <cctype>
 
 namespace Daisy {
 
+// Short messages are stored inline so queueing them does not allocate
+struct LogRecord {
+    static constexpr size_t InlineCapacity = 224;
+    
+    LogLevel level = LogLevel::Info;
+    LogChannel channel = LogChannel::General;
+    std::chrono::system_clock::time_point time;
+    uint32_t length = 0;
+    char text[InlineCapacity];
+    std::string overflow;
+    
+    void SetMessage(std::string_view message) {
+        length = static_cast<uint32_t>(message.size());
+        if (message.size() <= InlineCapacity) {
+            std::copy(message.begin(), message.end(), text);
+            overflow.clear();
+        } else {
+            overflow.assign(message);
+        }
+    }
+    
+    std::string_view GetMessage() const {
+        return length <= InlineCapacity ? std::string_view(text, length) : std::string_view(overflow);
+    }
+};
+
+// Bounded multi-producer queue (Vyukov): each cell carries a sequence number
+// that tells producers and the consumer whose turn it is. Consumers hold
+// Logger::m_mutex, so only one pops at a time.
+class LogQueue {
+public:
+    explicit LogQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        
+        m_mask = size - 1;
+        m_cells = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    
+    bool TryPush(LogRecord& record) {
+        size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = m_cells[position & m_mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            
+            if (difference == 0) {
+                if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.record = std::move(record);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = m_enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    
+    bool TryPop(LogRecord& record) {
+        Cell& cell = m_cells[m_dequeuePosition & m_mask];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (sequence != m_dequeuePosition + 1) {
+            return false;
+        }
+        
+        record = std::move(cell.record);
+        cell.sequence.store(m_dequeuePosition + m_mask + 1, std::memory_order_release);
+        m_dequeuePosition++;
+        return true;
+    }
+    
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        LogRecord record;
+    };
+    
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask = 0;
+    alignas(64) std::atomic<size_t> m_enqueuePosition{0};
+    alignas(64) size_t m_dequeuePosition = 0;
+};
+
+namespace {
+    constexpr size_t MaxBatchRecords = 256;
+    constexpr auto WriterIdleWait = std::chrono::milliseconds(5);
+    
+    // Longer messages are truncated
+    struct LogFormatBuffer {
+        static constexpr size_t Capacity = 2048;
+        
+        char data[Capacity];
+        size_t size = 0;
+    };
+    
+    thread_local LogFormatBuffer t_formatBuffer;
+    
+    void AppendLogText(std::string_view text) {
+        LogFormatBuffer& buffer = t_formatBuffer;
+        size_t count = std::min(text.size(), LogFormatBuffer::Capacity - buffer.size);
+        std::copy(text.data(), text.data() + count, buffer.data + buffer.size);
+        buffer.size += count;
+    }
+    
+    void AppendLogUnsigned(unsigned long long value, const LogFormatSpec& spec) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value, spec.type == 'x' ? 16 : 10);
+        AppendLogText(std::string_view(digits, result.ptr - digits));
+    }
+    
+    void AppendLogInteger(long long value, const LogFormatSpec& spec) {
+        if (spec.type == 'x') {
+            AppendLogUnsigned(static_cast<unsigned long long>(value), spec);
+            return;
+        }
+        
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        AppendLogText(std::string_view(digits, result.ptr - digits));
+    }
+    
+    void AppendLogFloat(double value, const LogFormatSpec& spec) {
+        // Without a spec this matches the ostream default the logger used before (%g, 6 digits)
+        std::chars_format format = std::chars_format::general;
+        if (spec.type == 'f') {
+            format = std::chars_format::fixed;
+        } else if (spec.type == 'e') {
+            format = std::chars_format::scientific;
+        }
+        int precision = spec.precision >= 0 ? spec.precision : 6;
+        
+        char digits[64];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value, format, precision);
+        if (result.ec != std::errc()) {
+            AppendLogText("<float>");
+            return;
+        }
+        AppendLogText(std::string_view(digits, result.ptr - digits));
+    }
+    
+    void AppendLogPointer(const void* value) {
+        AppendLogText("0x");
+        AppendLogUnsigned(reinterpret_cast<uintptr_t>(value), LogFormatSpec{-1, 'x'});
+    }
+    
+    void AppendLogArg(const LogArg& arg, const LogFormatSpec& spec) {
+        switch (arg.type) {
+            case LogArgType::Bool:     AppendLogText(arg.boolean ? "true" : "false"); break;
+            case LogArgType::Char:     AppendLogText(std::string_view(&arg.character, 1)); break;
+            case LogArgType::Integer:  AppendLogInteger(arg.integer, spec); break;
+            case LogArgType::Unsigned: AppendLogUnsigned(arg.unsignedInteger, spec); break;
+            case LogArgType::Float:    AppendLogFloat(arg.floating, spec); break;
+            case LogArgType::String:   AppendLogText(arg.GetText()); break;
+            case LogArgType::Pointer:  AppendLogPointer(arg.pointer); break;
+        }
+    }
+}
+
+std::string_view FormatLogMessage(std::string_view format, const LogArg* args, size_t count) {
+    LogFormatBuffer& buffer = t_formatBuffer;
+    buffer.size = 0;
+    
+    size_t argument = 0;
+    size_t literalStart = 0;
+    size_t i = 0;
+    while (i < format.size()) {
+        char c = format[i];
+        if (c != '{' && c != '}') {
+            ++i;
+            continue;
+        }
+        
+        AppendLogText(format.substr(literalStart, i - literalStart));
+        
+        // Escaped brace; the compile-time check already rejected stray ones
+        if (i + 1 < format.size() && format[i + 1] == c) {
+            AppendLogText(std::string_view(&format[i], 1));
+            i += 2;
+            literalStart = i;
+            continue;
+        }
+        
+        LogFormatSpec spec;
+        if (c == '{' && ParseLogPlaceholder(format, i, spec) && argument < count) {
+            AppendLogArg(args[argument], spec);
+            argument++;
+        } else {
+            ++i;
+        }
+        literalStart = i;
+    }
+    AppendLogText(format.substr(literalStart));
+    
+    return std::string_view(buffer.data, buffer.size);
+}
+
 Logger& Logger::GetInstance() {
     static Logger instance;
     return instance;
 }
 
-void Logger::Initialize(const std::string& logFile) {
-    std::lock_guard<std::mutex> lock(m_mutex);
+Logger::Logger() {
+    for (size_t i = 0; i < LogChannelCount; ++i) {
+        m_channelLevels[i].store(LogLevel::Info, std::memory_order_relaxed);
+        m_enabledLevels[i].store(LogLevel::Info, std::memory_order_relaxed);
+    }
+}
+
+Logger::~Logger() {
+    CloseBinaryLog();
+    Shutdown();
+}
+
+void Logger::Initialize(const std::string& logFile, const LoggerSettings& settings) {
+    Shutdown();
+    
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        
+        m_logFile = std::make_unique<std::ofstream>(logFile, std::ios::out | std::ios::app);
+        if (!m_logFile->is_open()) {
+            std::cerr << "Failed to open log file: " << logFile << std::endl;
+            m_logFile.reset();
+        }
+    }
     
-    m_logFile = std::make_unique<std::ofstream>(logFile, std::ios::out | std::ios::app);
-    if (!m_logFile->is_open()) {
-        std::cerr << "Failed to open log file: " << logFile << std::endl;
-        m_logFile.reset();
+    if (settings.async) {
+        m_queue = std::make_unique<LogQueue>(settings.queueCapacity);
+        m_overflowPolicy = settings.overflowPolicy;
+        m_stopping.store(false);
+        m_writerThread = std::thread(&Logger::WriterLoop, this);
+        m_async.store(true, std::memory_order_release);
     }
     
     Info("Logger initialized - Log file: {}", logFile);
 }
 
 void Logger::SetLogLevel(LogLevel level) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_logLevel = level;
+    std::lock_guard<std::mutex> lock(m_levelMutex);
+    for (auto& channelLevel : m_channelLevels) {
+        channelLevel.store(level, std::memory_order_relaxed);
+    }
+    UpdateEnabledLevels();
+}
+
+void Logger::SetChannelLevel(LogChannel channel, LogLevel level) {
+    if (channel >= LogChannel::Count) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_levelMutex);
+    m_channelLevels[static_cast<size_t>(channel)].store(level, std::memory_order_relaxed);
+    UpdateEnabledLevels();
+}
+
+bool Logger::OpenBinaryLog(const std::string& path, LogLevel level) {
+    CloseBinaryLog();
+    
+    if (!m_binarySink) {
+        m_binarySink = std::make_unique<BinaryLogSink>();
+    }
+    if (!m_binarySink->Open(path)) {
+        Error("Failed to open binary log: {}", path);
+        return false;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_levelMutex);
+        m_binaryLevel.store(level, std::memory_order_relaxed);
+        m_binaryEnabled.store(true, std::memory_order_release);
+        UpdateEnabledLevels();
+    }
+    
+    Info("Binary log opened: {}", path);
+    return true;
 }
 
-void Logger::Debug(const std::string& message) {
-    if (m_logLevel <= LogLevel::Debug) {
-        Log(LogLevel::Debug, message);
+void Logger::CloseBinaryLog() {
+    if (!m_binarySink) {
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_levelMutex);
+        m_binaryEnabled.store(false, std::memory_order_release);
+        UpdateEnabledLevels();
     }
+    m_binarySink->Close();
 }
 
-void Logger::Info(const std::string& message) {
-    if (m_logLevel <= LogLevel::Info) {
-        Log(LogLevel::Info, message);
+// Callers hold m_levelMutex, so concurrent level changes cannot interleave
+// and leave a channel's enabled level out of step with its text level
+void Logger::UpdateEnabledLevels() {
+    bool binaryEnabled = m_binaryEnabled.load(std::memory_order_relaxed);
+    LogLevel binaryLevel = m_binaryLevel.load(std::memory_order_relaxed);
+    
+    for (size_t i = 0; i < LogChannelCount; ++i) {
+        LogLevel level = m_channelLevels[i].load(std::memory_order_relaxed);
+        if (binaryEnabled) {
+            level = std::min(level, binaryLevel);
+        }
+        m_enabledLevels[i].store(level, std::memory_order_relaxed);
     }
 }
 
-void Logger::Warning(const std::string& message) {
-    if (m_logLevel <= LogLevel::Warning) {
-        Log(LogLevel::Warning, message);
+void Logger::LogMessage(LogChannel channel, LogLevel level, std::string_view message) {
+    if (!IsEnabled(channel, level)) {
+        return;
     }
+    
+    if (m_binaryEnabled.load(std::memory_order_relaxed) && level >= m_binaryLevel.load(std::memory_order_relaxed)) {
+        m_binarySink->WriteVerbatim(channel, level, message);
+    }
+    if (level >= GetChannelLevel(channel)) {
+        Log(channel, level, message);
+    }
+}
+
+void Logger::WriteBinary(LogChannel channel, LogLevel level, std::string_view format, const LogArg* args,
+                         size_t count) {
+    m_binarySink->Write(channel, level, format, args, count);
+}
+
+void Logger::Debug(std::string_view message) {
+    LogMessage(LogChannel::General, LogLevel::Debug, message);
+}
+
+void Logger::Info(std::string_view message) {
+    LogMessage(LogChannel::General, LogLevel::Info, message);
+}
+
+void Logger::Warning(std::string_view message) {
+    LogMessage(LogChannel::General, LogLevel::Warning, message);
+}
+
+void Logger::Error(std::string_view message) {
+    LogMessage(LogChannel::General, LogLevel::Error, message);
+}
+
+void Logger::Debug(LogChannel channel, std::string_view message) {
+    LogMessage(channel, LogLevel::Debug, message);
+}
+
+void Logger::Info(LogChannel channel, std::string_view message) {
+    LogMessage(channel, LogLevel::Info, message);
 }
 
-void Logger::Error(const std::string& message) {
-    if (m_logLevel <= LogLevel::Error) {
-        Log(LogLevel::Error, message);
+void Logger::Warning(LogChannel channel, std::string_view message) {
+    LogMessage(channel, LogLevel::Warning, message);
+}
+
+void Logger::Error(LogChannel channel, std::string_view message) {
+    LogMessage(channel, LogLevel::Error, message);
+}
+
+void Logger::Log(LogChannel channel, LogLevel level, std::string_view message) {
+    if (!m_async.load(std::memory_order_acquire)) {
+        WriteSync(channel, level, message);
+        return;
+    }
+    
+    LogRecord record;
+    record.level = level;
+    record.channel = channel;
+    record.time = std::chrono::system_clock::now();
+    record.SetMessage(message);
+    while (!m_queue->TryPush(record)) {
+        // Errors are never dropped
+        if (m_overflowPolicy == LogOverflowPolicy::Drop && level != LogLevel::Error) {
+            m_droppedRecords.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        
+        // The writer stopped while we waited for room
+        if (!m_async.load(std::memory_order_acquire)) {
+            WriteSync(record.channel, record.level, record.GetMessage());
+            return;
+        }
+        
+        m_writerCondition.notify_one();
+        std::this_thread::yield();
+    }
+    m_enqueuedRecords.fetch_add(1, std::memory_order_release);
+    
+    // Shutdown may have drained the queue between our m_async check and the
+    // push; then nobody else will write this record. Pairs with the fence in
+    // DrainQueue, so one side always sees the other.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!m_async.load(std::memory_order_relaxed)) {
+        DrainQueue();
+        return;
+    }
+    
+    // Errors must reach the file before a possible crash
+    if (level == LogLevel::Error) {
+        Flush();
     }
 }
 
-void Logger::Log(LogLevel level, const std::string& message) {
+void Logger::WriteSync(LogChannel channel, LogLevel level, std::string_view message) {
     std::lock_guard<std::mutex> lock(m_mutex);
     
-    std::string timestamp = GetTimestamp();
-    std::string levelStr = GetLogLevelString(level);
-    std::string fullMessage = "[" + timestamp + "] [" + levelStr + "] " + message;
+    std::string output;
+    AppendRecord(output, channel, level, std::chrono::system_clock::now(), message);
+    WriteOutput(output);
+}
+
+void Logger::Flush() {
+    if (!m_async.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::cout.flush();
+        if (m_logFile && m_logFile->is_open()) {
+            m_logFile->flush();
+        }
+        return;
+    }
+    
+    uint64_t target = m_enqueuedRecords.load(std::memory_order_acquire);
+    
+    std::unique_lock<std::mutex> lock(m_writerMutex);
+    if (m_flushTarget.load() < target) {
+        m_flushTarget.store(target);
+    }
+    m_writerCondition.notify_one();
+    m_flushCondition.wait(lock, [this, target] {
+        return m_writtenRecords.load(std::memory_order_acquire) >= target || !m_async.load();
+    });
+}
+
+void Logger::Shutdown() {
+    if (!m_writerThread.joinable()) {
+        return;
+    }
+    
+    // Later records go straight to the outputs; the queue itself stays alive
+    // until the next Initialize in case a producer is still mid-push
+    {
+        std::lock_guard<std::mutex> lock(m_writerMutex);
+        m_async.store(false);
+        m_stopping.store(true);
+    }
+    m_writerCondition.notify_one();
+    m_writerThread.join();
+    // A producer that saw m_async before it cleared can push after the writer's last pass
+    DrainQueue();
+    m_flushCondition.notify_all();
+}
+
+void Logger::DrainQueue() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    
+    size_t count = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::string output;
+        LogRecord record;
+        while (m_queue->TryPop(record)) {
+            AppendRecord(output, record.channel, record.level, record.time, record.GetMessage());
+            count++;
+        }
+        if (count > 0) {
+            WriteOutput(output);
+        }
+    }
+    
+    // The writer may still be waiting for these to stop
+    if (count > 0) {
+        std::lock_guard<std::mutex> lock(m_writerMutex);
+        m_writtenRecords.fetch_add(count, std::memory_order_release);
+        m_flushCondition.notify_all();
+    }
+}
+
+void Logger::WriterLoop() {
+    std::string output;
+    LogRecord record;
     
-    std::cout << fullMessage << std::endl;
+    for (;;) {
+        size_t count = 0;
+        output.clear();
+        {
+            // Formatting shares the timestamp cache with WriteSync, and popping
+            // must not overlap a DrainQueue
+            std::lock_guard<std::mutex> lock(m_mutex);
+            while (count < MaxBatchRecords && m_queue->TryPop(record)) {
+                AppendRecord(output, record.channel, record.level, record.time, record.GetMessage());
+                count++;
+            }
+            if (count > 0) {
+                WriteOutput(output);
+            }
+        }
+        
+        if (count > 0) {
+            
+            std::lock_guard<std::mutex> lock(m_writerMutex);
+            m_writtenRecords.fetch_add(count, std::memory_order_release);
+            m_flushCondition.notify_all();
+            continue;
+        }
+        
+        // Stop only once the queue is empty and every enqueued record is written
+        std::unique_lock<std::mutex> lock(m_writerMutex);
+        if (m_stopping.load() && m_writtenRecords.load() >= m_enqueuedRecords.load()) {
+            break;
+        }
+        m_writerCondition.wait_for(lock, WriterIdleWait, [this] {
+            return m_stopping.load() || m_flushTarget.load() > m_writtenRecords.load();
+        });
+    }
+}
+
+void Logger::AppendRecord(std::string& output, LogChannel channel, LogLevel level,
+                          std::chrono::system_clock::time_point time, std::string_view message) {
+    output += '[';
+    output += GetTimestamp(time);
+    output += "] [";
+    output += GetLogLevelString(level);
+    output += "] ";
+    if (channel != LogChannel::General) {
+        output += '[';
+        output += GetChannelName(channel);
+        output += "] ";
+    }
+    output += message;
+    output += '\n';
+}
+
+void Logger::WriteOutput(const std::string& output) {
+    std::cout << output;
+    std::cout.flush();
     
     if (m_logFile && m_logFile->is_open()) {
-        *m_logFile << fullMessage << std::endl;
+        *m_logFile << output;
         m_logFile->flush();
     }
 }
 
-std::string Logger::GetTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
+std::string Logger::GetTimestamp(std::chrono::system_clock::time_point time) {
+    auto seconds = std::chrono::time_point_cast<std::chrono::seconds>(time);
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(time - seconds).count();
+    
+    // localtime and put_time are slow; the date and time only change once a second
+    int64_t second = seconds.time_since_epoch().count();
+    if (second != m_cachedSecond) {
+        auto time_t = std::chrono::system_clock::to_time_t(time);
+        
+        std::stringstream ss;
+        ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
+        m_cachedTimestamp = ss.str();
+        m_cachedSecond = second;
+    }
     
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-    ss << '.' << std::setfill('0') << std::setw(3) << ms.count();
+    char millis[5];
+    millis[0] = '.';
+    millis[1] = static_cast<char>('0' + ms / 100);
+    millis[2] = static_cast<char>('0' + (ms / 10) % 10);
+    millis[3] = static_cast<char>('0' + ms % 10);
+    millis[4] = '\0';
     
-    return ss.str();
+    return m_cachedTimestamp + millis;
 }
 
 std::string Logger::GetLogLevelString(LogLevel level) {
@@ -90,4 +591,106 @@ std::string Logger::GetLogLevelString(LogLevel level) {
     }
 }
 
+
+const char* Logger::GetChannelName(LogChannel channel) {
+    switch (channel) {
+        case LogChannel::General:  return "General";
+        case LogChannel::Platform: return "Platform";
+        case LogChannel::Physics:  return "Physics";
+        case LogChannel::Render:   return "Render";
+        case LogChannel::Audio:    return "Audio";
+        case LogChannel::AI:       return "AI";
+        case LogChannel::Net:      return "Net";
+        case LogChannel::Streamer: return "Streamer";
+        case LogChannel::Script:   return "Script";
+        case LogChannel::Editor:   return "Editor";
+        default:                   return "Unknown";
+    }
+}
+
+namespace {
+    bool EqualsIgnoreCase(std::string_view a, std::string_view b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+            return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+        });
+    }
+    
+    std::string_view TrimSpaces(std::string_view text) {
+        while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) {
+            text.remove_prefix(1);
+        }
+        while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) {
+            text.remove_suffix(1);
+        }
+        return text;
+    }
+}
+
+bool Logger::ParseChannel(std::string_view name, LogChannel& channel) {
+    for (size_t i = 0; i < LogChannelCount; ++i) {
+        if (EqualsIgnoreCase(name, GetChannelName(static_cast<LogChannel>(i)))) {
+            channel = static_cast<LogChannel>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Logger::ParseLogLevel(std::string_view name, LogLevel& level) {
+    constexpr LogLevel levels[] = {LogLevel::Debug, LogLevel::Info, LogLevel::Warning, LogLevel::Error};
+    for (LogLevel candidate : levels) {
+        if (EqualsIgnoreCase(name, TrimSpaces(GetLogLevelString(candidate)))) {
+            level = candidate;
+            return true;
+        }
+    }
+    if (EqualsIgnoreCase(name, "Warning")) {
+        level = LogLevel::Warning;
+        return true;
+    }
+    return false;
+}
+
+bool Logger::ConfigureChannels(std::string_view spec) {
+    std::array<LogLevel, LogChannelCount> levels;
+    for (size_t i = 0; i < LogChannelCount; ++i) {
+        levels[i] = GetChannelLevel(static_cast<LogChannel>(i));
+    }
+    
+    while (!spec.empty()) {
+        size_t end = spec.find(',');
+        std::string_view entry = TrimSpaces(spec.substr(0, end));
+        spec = end == std::string_view::npos ? std::string_view() : spec.substr(end + 1);
+        if (entry.empty()) {
+            continue;
+        }
+        
+        LogLevel level;
+        size_t separator = entry.find('=');
+        if (separator == std::string_view::npos) {
+            if (!ParseLogLevel(entry, level)) {
+                Warning("Invalid log level '{}'", entry);
+                return false;
+            }
+            levels.fill(level);
+            continue;
+        }
+        
+        LogChannel channel;
+        std::string_view channelName = TrimSpaces(entry.substr(0, separator));
+        std::string_view levelName = TrimSpaces(entry.substr(separator + 1));
+        if (!ParseChannel(channelName, channel) || !ParseLogLevel(levelName, level)) {
+            Warning("Invalid log channel setting '{}'", entry);
+            return false;
+        }
+        levels[static_cast<size_t>(channel)] = level;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_levelMutex);
+    for (size_t i = 0; i < LogChannelCount; ++i) {
+        m_channelLevels[i].store(levels[i], std::memory_order_relaxed);
+    }
+    UpdateEnabledLevels();
+    return true;
+}
 }
\ No newline at end of file
@@ -1,5 +1,5 @@
 #include "Core/Math.h"
-#include <cstring>
+#include "Core/SimdMath.h"
 
 namespace Daisy {
 
@@ -25,7 +25,7 @@ Matrix4 Matrix4::Scale(const Vector3& scale) {
 
 Matrix4 Matrix4::Perspective(float fov, float aspect, float near, float far) {
     Matrix4 result;
-    std::memset(result.m, 0, sizeof(result.m));
+    result.m[15] = 0.0f;
     
     float tanHalfFov = std::tan(fov * 0.5f);
     
@@ -40,7 +40,6 @@ Matrix4 Matrix4::Perspective(float fov, float aspect, float near, float far) {
 
 Matrix4 Matrix4::Orthographic(float left, float right, float bottom, float top, float near, float far) {
     Matrix4 result;
-    std::memset(result.m, 0, sizeof(result.m));
     
     result.m[0] = 2.0f / (right - left);
     result.m[5] = 2.0f / (top - bottom);
@@ -55,26 +54,14 @@ Matrix4 Matrix4::Orthographic(float left, float right, float bottom, float top,
 
 Matrix4 Matrix4::operator*(const Matrix4& other) const {
     Matrix4 result;
-    std::memset(result.m, 0, sizeof(result.m));
-    
-    for (int i = 0; i < 4; ++i) {
-        for (int j = 0; j < 4; ++j) {
-            for (int k = 0; k < 4; ++k) {
-                result.m[i * 4 + j] += m[i * 4 + k] * other.m[k * 4 + j];
-            }
-        }
-    }
-    
+    Simd::MultiplyMatrix4(m, other.m, result.m);
     return result;
 }
 
 Vector4 Matrix4::operator*(const Vector4& vec) const {
-    return Vector4(
-        m[0] * vec.x + m[4] * vec.y + m[8]  * vec.z + m[12] * vec.w,
-        m[1] * vec.x + m[5] * vec.y + m[9]  * vec.z + m[13] * vec.w,
-        m[2] * vec.x + m[6] * vec.y + m[10] * vec.z + m[14] * vec.w,
-        m[3] * vec.x + m[7] * vec.y + m[11] * vec.z + m[15] * vec.w
-    );
+    Vector4 result;
+    Simd::TransformVector4(m, &vec.x, &result.x);
+    return result;
 }
 
 Quaternion Quaternion::FromAxisAngle(const Vector3& axis, float angle) {
@@ -127,20 +114,15 @@ Matrix4 Quaternion::ToMatrix() const {
 }
 
 Quaternion Quaternion::operator*(const Quaternion& other) const {
-    return Quaternion(
-        w * other.x + x * other.w + y * other.z - z * other.y,
-        w * other.y - x * other.z + y * other.w + z * other.x,
-        w * other.z + x * other.y - y * other.x + z * other.w,
-        w * other.w - x * other.x - y * other.y - z * other.z
-    );
+    Quaternion result;
+    Simd::MultiplyQuaternion(&x, &other.x, &result.x);
+    return result;
 }
 
 Quaternion Quaternion::Normalized() const {
-    float length = std::sqrt(x * x + y * y + z * z + w * w);
-    if (length > 0.0f) {
-        return Quaternion(x / length, y / length, z / length, w / length);
-    }
-    return Quaternion();
+    Quaternion result;
+    Simd::NormalizeQuaternion(&x, &result.x);
+    return result;
 }
 
 }
\ No newline at end of file
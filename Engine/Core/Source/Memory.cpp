@@ -1,51 +1,353 @@
 #include "Core/Memory.h"
 #include "Core/Logger.h"
 #include <iostream>
+#include <iomanip>
+#include <map>
+#include <tuple>
 
 namespace Daisy {
 
+namespace {
+    // Low bits of a record's stamp; the bits above count how often it was reused
+    constexpr uint64_t RecordFree = 0;      // Never used, or its allocation was freed
+    constexpr uint64_t RecordWriting = 1;   // Owner is filling it in
+    constexpr uint64_t RecordLive = 2;
+    constexpr uint64_t RecordStateMask = 3;
+    constexpr size_t RecordsPerChunk = 1024;
+    constexpr size_t ReportedCallSites = 20;
+    
+    thread_local MemoryTag t_currentTag = GeneralMemoryTag;
+    thread_local int64_t t_bytesUntilSample = -1;
+}
+
+// One sampled allocation. Reports read it like a seqlock: the stamp is checked
+// before and after, so a record freed and refilled meanwhile is skipped.
+struct MemorySampleRecord {
+    std::atomic<uint64_t> stamp{RecordFree};
+    std::atomic<size_t> weight{0};
+    std::atomic<const char*> file{nullptr};
+    std::atomic<int> line{0};
+    std::atomic<MemoryTag> tag{GeneralMemoryTag};
+};
+
+// Sampled allocations of one thread. Only the owning thread fills records, any
+// thread may mark one free. Chunks never move, so a record in a MemorySample
+// stays valid for as long as the tracker.
+struct MemoryThreadSamples {
+    std::mutex chunksMutex;     // Taken to add a chunk or to report, never per allocation
+    std::vector<std::unique_ptr<MemorySampleRecord[]>> chunks;
+    std::vector<MemorySampleRecord*> freeRecords;   // Owner only
+    std::atomic<bool> retired{false};
+};
+
+namespace {
+    // Marks the slab retired when its thread exits so another thread can take it over
+    struct ThreadSamplesHolder {
+        std::shared_ptr<MemoryThreadSamples> samples;
+        
+        ~ThreadSamplesHolder() {
+            if (samples) {
+                samples->retired.store(true, std::memory_order_release);
+            }
+        }
+    };
+    
+    thread_local ThreadSamplesHolder t_samples;
+    
+    // Owner only. Sweeps for records freed by any thread once the free list
+    // runs out, and grows when most records are still live.
+    MemorySampleRecord* AcquireRecord(MemoryThreadSamples& samples, size_t maxRecords) {
+        if (samples.freeRecords.empty()) {
+            size_t capacity = samples.chunks.size() * RecordsPerChunk;
+            for (auto& chunk : samples.chunks) {
+                for (size_t i = 0; i < RecordsPerChunk; ++i) {
+                    if ((chunk[i].stamp.load(std::memory_order_relaxed) & RecordStateMask) == RecordFree) {
+                        samples.freeRecords.push_back(&chunk[i]);
+                    }
+                }
+            }
+            
+            if (samples.freeRecords.size() * 4 <= capacity && capacity < maxRecords) {
+                auto chunk = std::make_unique<MemorySampleRecord[]>(RecordsPerChunk);
+                for (size_t i = RecordsPerChunk; i-- > 0;) {
+                    samples.freeRecords.push_back(&chunk[i]);
+                }
+                std::lock_guard<std::mutex> lock(samples.chunksMutex);
+                samples.chunks.push_back(std::move(chunk));
+            }
+            
+            if (samples.freeRecords.empty()) {
+                return nullptr;
+            }
+        }
+        
+        MemorySampleRecord* record = samples.freeRecords.back();
+        samples.freeRecords.pop_back();
+        return record;
+    }
+}
+
 MemoryTracker& MemoryTracker::GetInstance() {
     static MemoryTracker instance;
     return instance;
 }
 
-void MemoryTracker::RecordAllocation(void* ptr, size_t size, const char* file, int line) {
-    if (!ptr) return;
+MemoryTracker::MemoryTracker() {
+    m_tagNames[GeneralMemoryTag] = "General";
+}
+
+MemoryTracker::~MemoryTracker() = default;
+
+void MemoryTracker::Configure(const MemoryTrackerSettings& settings) {
+    m_sampleInterval.store(settings.sampleInterval, std::memory_order_relaxed);
+    m_maxThreadSamples.store(settings.maxTrackedAllocations, std::memory_order_relaxed);
+}
+
+MemoryThreadSamples& MemoryTracker::GetThreadSamples() {
+    if (!t_samples.samples) {
+        std::lock_guard<std::mutex> lock(m_threadSamplesMutex);
+        for (const auto& samples : m_threadSamples) {
+            // Records the exited thread left live stay in the reports
+            bool retired = true;
+            if (samples->retired.compare_exchange_strong(retired, false, std::memory_order_acquire)) {
+                t_samples.samples = samples;
+                break;
+            }
+        }
+        if (!t_samples.samples) {
+            t_samples.samples = std::make_shared<MemoryThreadSamples>();
+            m_threadSamples.push_back(t_samples.samples);
+        }
+    }
+    return *t_samples.samples;
+}
+
+MemoryTag MemoryTracker::RegisterTag(std::string_view name) {
+    std::lock_guard<std::mutex> lock(m_tagMutex);
+    
+    MemoryTag count = m_tagCount.load(std::memory_order_relaxed);
+    for (MemoryTag tag = 0; tag < count; ++tag) {
+        if (m_tagNames[tag] == name) {
+            return tag;
+        }
+    }
+    
+    if (count >= MaxTags) {
+        DAISY_WARNING("Memory tag limit reached, '{}' is accounted as General", name);
+        return GeneralMemoryTag;
+    }
+    
+    m_tagNames[count] = std::string(name);
+    m_tagCount.store(count + 1, std::memory_order_release);
+    return count;
+}
+
+MemoryTag MemoryTracker::GetCurrentTag() {
+    return t_currentTag;
+}
+
+void MemoryTracker::SetCurrentTag(MemoryTag tag) {
+    t_currentTag = tag;
+}
+
+bool MemoryTracker::ShouldSample(size_t size, size_t& weight) const {
+    size_t interval = m_sampleInterval.load(std::memory_order_relaxed);
+    if (interval <= 1) {
+        weight = size;
+        return true;
+    }
     
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_allocations[ptr] = {size, file, line};
-    m_totalAllocated.fetch_add(size);
-    m_activeAllocations.fetch_add(1);
+    // Sample the allocation that crosses each interval boundary of this
+    // thread's allocated bytes; it then stands for interval bytes
+    if (t_bytesUntilSample < 0) {
+        t_bytesUntilSample = static_cast<int64_t>(interval);
+    }
+    t_bytesUntilSample -= static_cast<int64_t>(size);
+    if (t_bytesUntilSample > 0) {
+        return false;
+    }
+    
+    t_bytesUntilSample = static_cast<int64_t>(interval);
+    weight = std::max(size, interval);
+    return true;
 }
 
-void MemoryTracker::RecordDeallocation(void* ptr) {
+void MemoryTracker::UpdatePeak(std::atomic<size_t>& peak, size_t value) {
+    size_t current = peak.load(std::memory_order_relaxed);
+    while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+MemorySample MemoryTracker::RecordAllocation(void* ptr, size_t size, const char* file, int line) {
+    return RecordAllocation(ptr, size, t_currentTag, file, line);
+}
+
+MemorySample MemoryTracker::RecordAllocation(void* ptr, size_t size, MemoryTag tag, const char* file, int line) {
+    if (!ptr) return {};
+    
+    size_t total = m_currentBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    UpdatePeak(m_peakBytes, total);
+    m_activeAllocations.fetch_add(1, std::memory_order_relaxed);
+    
+    size_t weight;
+    if (!ShouldSample(size, weight)) {
+        return {};
+    }
+    
+    MemorySampleRecord* record = AcquireRecord(GetThreadSamples(), m_maxThreadSamples.load(std::memory_order_relaxed));
+    if (!record) {
+        m_droppedSamples.fetch_add(1, std::memory_order_relaxed);
+        return {};
+    }
+    
+    if (tag >= MaxTags) {
+        tag = GeneralMemoryTag;
+    }
+    
+    uint64_t stamp = (record->stamp.load(std::memory_order_relaxed) & ~RecordStateMask) + (RecordStateMask + 1);
+    record->stamp.store(stamp | RecordWriting, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    record->weight.store(weight, std::memory_order_relaxed);
+    record->file.store(file, std::memory_order_relaxed);
+    record->line.store(line, std::memory_order_relaxed);
+    record->tag.store(tag, std::memory_order_relaxed);
+    record->stamp.store(stamp | RecordLive, std::memory_order_release);
+    
+    TagCounters& counters = m_tags[tag];
+    size_t tagBytes = counters.currentBytes.fetch_add(weight, std::memory_order_relaxed) + weight;
+    UpdatePeak(counters.peakBytes, tagBytes);
+    counters.liveAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    
+    return {record, weight, tag};
+}
+
+void MemoryTracker::RecordDeallocation(void* ptr, size_t size, const MemorySample& sample) {
     if (!ptr) return;
     
-    std::lock_guard<std::mutex> lock(m_mutex);
-    auto it = m_allocations.find(ptr);
-    if (it != m_allocations.end()) {
-        m_totalAllocated.fetch_sub(it->second.size);
-        m_activeAllocations.fetch_sub(1);
-        m_allocations.erase(it);
+    m_currentBytes.fetch_sub(size, std::memory_order_relaxed);
+    m_activeAllocations.fetch_sub(1, std::memory_order_relaxed);
+    
+    if (!sample.record) {
+        return;
     }
+    
+    // Only this free can change a live record, so no compare-exchange is needed
+    uint64_t stamp = sample.record->stamp.load(std::memory_order_relaxed);
+    sample.record->stamp.store((stamp & ~RecordStateMask) | RecordFree, std::memory_order_relaxed);
+    
+    TagCounters& counters = m_tags[sample.tag];
+    counters.currentBytes.fetch_sub(sample.weight, std::memory_order_relaxed);
+    counters.liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+}
+
+std::vector<MemoryTagStats> MemoryTracker::GetTagStats() const {
+    std::lock_guard<std::mutex> lock(m_tagMutex);
+    
+    std::vector<MemoryTagStats> stats;
+    MemoryTag count = m_tagCount.load(std::memory_order_acquire);
+    for (MemoryTag tag = 0; tag < count; ++tag) {
+        const TagCounters& counters = m_tags[tag];
+        MemoryTagStats entry;
+        entry.name = m_tagNames[tag];
+        entry.currentBytes = counters.currentBytes.load(std::memory_order_relaxed);
+        entry.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+        entry.liveAllocations = counters.liveAllocations.load(std::memory_order_relaxed);
+        entry.totalAllocations = counters.totalAllocations.load(std::memory_order_relaxed);
+        stats.push_back(std::move(entry));
+    }
+    return stats;
+}
+
+std::vector<MemoryCallSiteStats> MemoryTracker::GetLiveCallSites() const {
+    std::map<std::tuple<const char*, int, MemoryTag>, MemoryCallSiteStats> sites;
+    
+    std::vector<std::shared_ptr<MemoryThreadSamples>> threads;
+    {
+        std::lock_guard<std::mutex> lock(m_threadSamplesMutex);
+        threads = m_threadSamples;
+    }
+    
+    for (const auto& samples : threads) {
+        std::lock_guard<std::mutex> lock(samples->chunksMutex);
+        for (const auto& chunk : samples->chunks) {
+            for (size_t i = 0; i < RecordsPerChunk; ++i) {
+                const MemorySampleRecord& record = chunk[i];
+                uint64_t stamp = record.stamp.load(std::memory_order_acquire);
+                if ((stamp & RecordStateMask) != RecordLive) {
+                    continue;
+                }
+                
+                const char* file = record.file.load(std::memory_order_relaxed);
+                int line = record.line.load(std::memory_order_relaxed);
+                size_t weight = record.weight.load(std::memory_order_relaxed);
+                MemoryTag tag = record.tag.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (record.stamp.load(std::memory_order_relaxed) != stamp) {
+                    continue;
+                }
+                
+                MemoryCallSiteStats& site = sites[{file, line, tag}];
+                site.file = file;
+                site.line = line;
+                site.tag = tag;
+                site.liveAllocations++;
+                site.estimatedBytes += weight;
+            }
+        }
+    }
+    
+    std::vector<MemoryCallSiteStats> result;
+    result.reserve(sites.size());
+    for (auto& [key, site] : sites) {
+        result.push_back(site);
+    }
+    std::sort(result.begin(), result.end(), [](const MemoryCallSiteStats& a, const MemoryCallSiteStats& b) {
+        return a.estimatedBytes > b.estimatedBytes;
+    });
+    return result;
 }
 
 void MemoryTracker::PrintMemoryReport() const {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<MemoryTagStats> tags = GetTagStats();
+    std::vector<MemoryCallSiteStats> sites = GetLiveCallSites();
     
-    size_t totalActive = 0;
     std::cout << "\n=== Memory Report ===\n";
     std::cout << "Active Allocations: " << m_activeAllocations.load() << "\n";
-    std::cout << "Total Allocated: " << m_totalAllocated.load() << " bytes\n";
+    std::cout << "Total Allocated: " << m_currentBytes.load() << " bytes\n";
+    std::cout << "Peak Allocated: " << m_peakBytes.load() << " bytes\n";
+    
+    size_t interval = m_sampleInterval.load();
+    if (interval > 1) {
+        std::cout << "Sampling: one allocation per " << interval << " bytes, per-tag and call site figures are estimates\n";
+    }
+    if (m_droppedSamples.load() > 0) {
+        std::cout << "Samples dropped (per-thread limit reached): " << m_droppedSamples.load() << "\n";
+    }
     
-    if (!m_allocations.empty()) {
-        std::cout << "\nLeak Details:\n";
-        for (const auto& [ptr, info] : m_allocations) {
-            std::cout << "  " << ptr << " - " << info.size << " bytes at " 
-                     << info.file << ":" << info.line << "\n";
-            totalActive += info.size;
+    std::cout << "\nBy Tag:\n";
+    for (const auto& tag : tags) {
+        if (tag.totalAllocations == 0) {
+            continue;
+        }
+        std::cout << "  " << std::left << std::setw(20) << tag.name << std::right
+                  << std::setw(12) << tag.currentBytes << " bytes live, "
+                  << std::setw(12) << tag.peakBytes << " peak, "
+                  << tag.liveAllocations << "/" << tag.totalAllocations << " allocations live\n";
+    }
+    
+    if (!sites.empty()) {
+        std::cout << "\nLeak Details (by call site):\n";
+        size_t shown = std::min(sites.size(), ReportedCallSites);
+        for (size_t i = 0; i < shown; ++i) {
+            const auto& site = sites[i];
+            std::cout << "  " << site.estimatedBytes << " bytes in " << site.liveAllocations << " allocations at "
+                      << (site.file ? site.file : "?") << ":" << site.line
+                      << " [" << tags[std::min<size_t>(site.tag, tags.size() - 1)].name << "]\n";
+        }
+        if (sites.size() > shown) {
+            std::cout << "  ... " << sites.size() - shown << " more call sites\n";
         }
-        std::cout << "Total leaked: " << totalActive << " bytes\n";
     }
     std::cout << "=====================\n\n";
 }
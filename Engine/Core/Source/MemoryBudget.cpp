@@ -0,0 +1,134 @@
+#include "Core/MemoryBudget.h"
+#include "Core/Logger.h"
+#include <algorithm>
+#include <new>
+
+namespace Daisy {
+
+namespace {
+    // Listeners that allocate from the resource they are told about must not re-enter
+    thread_local bool t_notifying = false;
+}
+
+MemoryBudgetResource::MemoryBudgetResource(std::string name, std::pmr::memory_resource* upstream)
+    : m_name(std::move(name))
+    , m_upstream(upstream ? upstream : std::pmr::new_delete_resource()) {
+}
+
+void MemoryBudgetResource::SetBudget(const MemoryBudget& budget) {
+    m_softLimit.store(budget.softLimit, std::memory_order_relaxed);
+    m_hardLimit.store(budget.hardLimit, std::memory_order_relaxed);
+}
+
+MemoryBudget MemoryBudgetResource::GetBudget() const {
+    MemoryBudget budget;
+    budget.softLimit = m_softLimit.load(std::memory_order_relaxed);
+    budget.hardLimit = m_hardLimit.load(std::memory_order_relaxed);
+    return budget;
+}
+
+uint32_t MemoryBudgetResource::AddListener(MemoryBudgetCallback callback) {
+    std::lock_guard<std::mutex> lock(m_listenerMutex);
+    uint32_t id = m_nextListenerId++;
+    m_listeners.emplace_back(id, std::move(callback));
+    return id;
+}
+
+void MemoryBudgetResource::RemoveListener(uint32_t id) {
+    std::lock_guard<std::mutex> lock(m_listenerMutex);
+    m_listeners.erase(std::remove_if(m_listeners.begin(), m_listeners.end(),
+        [id](const auto& listener) { return listener.first == id; }), m_listeners.end());
+}
+
+bool MemoryBudgetResource::IsOverSoftLimit() const {
+    size_t softLimit = m_softLimit.load(std::memory_order_relaxed);
+    return softLimit != 0 && GetCurrentBytes() > softLimit;
+}
+
+MemoryBudgetStats MemoryBudgetResource::GetStats() const {
+    MemoryBudgetStats stats;
+    stats.name = m_name;
+    stats.currentBytes = GetCurrentBytes();
+    stats.peakBytes = GetPeakBytes();
+    stats.liveAllocations = m_liveAllocations.load(std::memory_order_relaxed);
+    stats.failedAllocations = m_failedAllocations.load(std::memory_order_relaxed);
+    stats.budget = GetBudget();
+    return stats;
+}
+
+void* MemoryBudgetResource::do_allocate(size_t bytes, size_t alignment) {
+    size_t hardLimit = m_hardLimit.load(std::memory_order_relaxed);
+    size_t before = m_currentBytes.fetch_add(bytes, std::memory_order_relaxed);
+    
+    if (hardLimit != 0 && before + bytes > hardLimit) {
+        m_currentBytes.fetch_sub(bytes, std::memory_order_relaxed);
+        
+        // Give listeners one chance to free memory synchronously
+        Notify(MemoryBudgetEvent::HardLimitReached);
+        before = m_currentBytes.fetch_add(bytes, std::memory_order_relaxed);
+        if (before + bytes > hardLimit) {
+            m_currentBytes.fetch_sub(bytes, std::memory_order_relaxed);
+            m_failedAllocations.fetch_add(1, std::memory_order_relaxed);
+            DAISY_ERROR("Memory budget '{}' exhausted: {} + {} bytes exceeds the hard limit of {}",
+                m_name, before, bytes, hardLimit);
+            throw std::bad_alloc();
+        }
+    }
+    
+    void* ptr;
+    try {
+        ptr = m_upstream->allocate(bytes, alignment);
+    } catch (...) {
+        m_currentBytes.fetch_sub(bytes, std::memory_order_relaxed);
+        m_failedAllocations.fetch_add(1, std::memory_order_relaxed);
+        throw;
+    }
+    m_liveAllocations.fetch_add(1, std::memory_order_relaxed);
+    
+    size_t after = before + bytes;
+    size_t peak = m_peakBytes.load(std::memory_order_relaxed);
+    while (after > peak && !m_peakBytes.compare_exchange_weak(peak, after, std::memory_order_relaxed)) {
+    }
+    
+    // Edge-triggered: only the allocation that crosses the limit reports it
+    size_t softLimit = m_softLimit.load(std::memory_order_relaxed);
+    if (softLimit != 0 && before <= softLimit && after > softLimit) {
+        DAISY_WARNING("Memory budget '{}' over its soft limit: {} of {} bytes", m_name, after, softLimit);
+        Notify(MemoryBudgetEvent::SoftLimitExceeded);
+    }
+    
+    return ptr;
+}
+
+void MemoryBudgetResource::do_deallocate(void* ptr, size_t bytes, size_t alignment) {
+    m_upstream->deallocate(ptr, bytes, alignment);
+    m_currentBytes.fetch_sub(bytes, std::memory_order_relaxed);
+    m_liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void MemoryBudgetResource::Notify(MemoryBudgetEvent event) {
+    if (t_notifying) {
+        return;
+    }
+    
+    std::vector<MemoryBudgetCallback> listeners;
+    {
+        std::lock_guard<std::mutex> lock(m_listenerMutex);
+        if (m_listeners.empty()) {
+            return;
+        }
+        for (const auto& listener : m_listeners) {
+            listeners.push_back(listener.second);
+        }
+    }
+    
+    struct NotifyScope {
+        NotifyScope() { t_notifying = true; }
+        ~NotifyScope() { t_notifying = false; }
+    } scope;
+    for (const auto& listener : listeners) {
+        listener(*this, event);
+    }
+}
+
+}
\ No newline at end of file
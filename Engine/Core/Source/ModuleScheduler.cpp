@@ -0,0 +1,233 @@
+#include "Core/ModuleScheduler.h"
+#include "Core/Logger.h"
+#include "Core/Profiler.h"
+#include <algorithm>
+
+namespace Daisy {
+
+void ModuleScheduler::Build(const std::vector<Module*>& modules) {
+    m_nodes.clear();
+    m_nodes.resize(modules.size());
+    
+    // Node index per ModuleTypeId
+    std::vector<size_t> indices;
+    for (size_t i = 0; i < modules.size(); ++i) {
+        ModuleTypeId typeId = modules[i]->GetTypeId();
+        if (typeId >= indices.size()) {
+            indices.resize(typeId + 1, modules.size());
+        }
+        indices[typeId] = i;
+        m_nodes[i].module = modules[i];
+    }
+    
+    // Adjacency matrix keeps edges unique; module counts are small
+    std::vector<std::vector<bool>> edges(modules.size(), std::vector<bool>(modules.size(), false));
+    auto addEdge = [&edges](size_t from, size_t to) {
+        if (from != to) {
+            edges[from][to] = true;
+        }
+    };
+    
+    size_t lastMainThread = modules.size();
+    for (size_t i = 0; i < modules.size(); ++i) {
+        Module* module = m_nodes[i].module;
+        ModuleThreading threading = module->GetThreading();
+        
+        m_nodes[i].mainThread = threading != ModuleThreading::Worker || m_jobSystem.GetWorkerCount() == 0;
+        
+        // Exclusive modules act as barriers in registration order
+        for (size_t j = 0; j < i; ++j) {
+            if (threading == ModuleThreading::Exclusive ||
+                m_nodes[j].module->GetThreading() == ModuleThreading::Exclusive) {
+                addEdge(j, i);
+            }
+        }
+        
+        // Main thread modules keep their registration order among themselves
+        if (threading != ModuleThreading::Worker) {
+            if (lastMainThread != modules.size()) {
+                addEdge(lastMainThread, i);
+            }
+            lastMainThread = i;
+        }
+        
+        for (const auto& dependency : module->GetDependencies()) {
+            if (dependency.module >= indices.size() || indices[dependency.module] == modules.size()) {
+                DAISY_WARNING("Module {} depends on a module that is not registered", module->GetName());
+                continue;
+            }
+            
+            size_t other = indices[dependency.module];
+            if (dependency.access == ModuleAccess::Read) {
+                addEdge(other, i);
+            } else {
+                addEdge(std::min(other, i), std::max(other, i));
+            }
+        }
+    }
+    
+    for (size_t from = 0; from < modules.size(); ++from) {
+        for (size_t to = 0; to < modules.size(); ++to) {
+            if (edges[from][to]) {
+                m_nodes[from].successors.push_back(to);
+                m_nodes[to].predecessorCount++;
+            }
+        }
+    }
+    
+    if (!SortNodes()) {
+        DAISY_ERROR("Module dependency cycle detected, falling back to serial module updates");
+        BuildSerialChain();
+        SortNodes();
+    }
+    
+    DAISY_INFO("Module schedule built: {} modules, critical path {}, {} worker threads",
+        m_nodes.size(), m_criticalPathLength, m_jobSystem.GetWorkerCount());
+}
+
+bool ModuleScheduler::SortNodes() {
+    // Kahn's algorithm; also yields the longest chain for diagnostics
+    std::vector<uint32_t> pending(m_nodes.size());
+    std::vector<size_t> depth(m_nodes.size(), 1);
+    std::vector<size_t> ready;
+    
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        pending[i] = m_nodes[i].predecessorCount;
+        if (pending[i] == 0) {
+            ready.push_back(i);
+        }
+    }
+    
+    size_t visited = 0;
+    m_criticalPathLength = 0;
+    while (!ready.empty()) {
+        size_t index = ready.back();
+        ready.pop_back();
+        visited++;
+        m_criticalPathLength = std::max(m_criticalPathLength, depth[index]);
+        
+        for (size_t successor : m_nodes[index].successors) {
+            depth[successor] = std::max(depth[successor], depth[index] + 1);
+            if (--pending[successor] == 0) {
+                ready.push_back(successor);
+            }
+        }
+    }
+    
+    return visited == m_nodes.size();
+}
+
+void ModuleScheduler::BuildSerialChain() {
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        m_nodes[i].successors.clear();
+        m_nodes[i].predecessorCount = i > 0 ? 1 : 0;
+        m_nodes[i].mainThread = true;
+        if (i + 1 < m_nodes.size()) {
+            m_nodes[i].successors.push_back(i + 1);
+        }
+    }
+}
+
+void ModuleScheduler::Execute(float deltaTime, ModuleTick ticks) {
+    if (m_nodes.empty()) {
+        return;
+    }
+    
+    std::unique_lock<std::mutex> lock(m_frameMutex);
+    
+    m_deltaTime = deltaTime;
+    m_ticks = ticks;
+    m_remainingNodes = m_nodes.size();
+    m_mainThreadReady.clear();
+    
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        m_nodes[i].pendingPredecessors = m_nodes[i].predecessorCount;
+    }
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        if (m_nodes[i].predecessorCount == 0) {
+            Dispatch(i);
+        }
+    }
+    
+    while (m_remainingNodes > 0) {
+        if (m_mainThreadReady.empty()) {
+            // Help with queued jobs, then sleep until a node completes
+            lock.unlock();
+            bool ranJob = m_jobSystem.RunPendingJob();
+            lock.lock();
+            
+            if (!ranJob && m_mainThreadReady.empty() && m_remainingNodes > 0) {
+                m_frameCondition.wait(lock);
+            }
+            continue;
+        }
+        
+        // Lowest index first so single-threaded runs keep registration order
+        auto next = std::min_element(m_mainThreadReady.begin(), m_mainThreadReady.end());
+        size_t index = *next;
+        m_mainThreadReady.erase(next);
+        
+        lock.unlock();
+        RunNode(index);
+        lock.lock();
+        
+        Complete(index);
+    }
+}
+
+void ModuleScheduler::Dispatch(size_t nodeIndex) {
+    // Modules outside this pass only forward readiness to their successors
+    if (!IsScheduled(nodeIndex)) {
+        Complete(nodeIndex);
+        return;
+    }
+    
+    if (m_nodes[nodeIndex].mainThread) {
+        m_mainThreadReady.push_back(nodeIndex);
+        m_frameCondition.notify_one();
+        return;
+    }
+    
+    m_jobSystem.Schedule([this, nodeIndex]() {
+        RunNode(nodeIndex);
+        
+        std::lock_guard<std::mutex> lock(m_frameMutex);
+        Complete(nodeIndex);
+    });
+}
+
+void ModuleScheduler::Complete(size_t nodeIndex) {
+    for (size_t successor : m_nodes[nodeIndex].successors) {
+        if (--m_nodes[successor].pendingPredecessors == 0) {
+            Dispatch(successor);
+        }
+    }
+    
+    if (--m_remainingNodes == 0) {
+        m_frameCondition.notify_one();
+    }
+}
+
+void ModuleScheduler::RunNode(size_t nodeIndex) {
+    Module* module = m_nodes[nodeIndex].module;
+    if (!module->IsInitialized()) {
+        return;
+    }
+    
+    DAISY_PROFILE_SCOPE(module->GetName().c_str());
+    DAISY_MEMORY_TAG_SCOPE(module->GetMemoryTag());
+    
+    ModuleTick moduleTicks = module->GetTick();
+    if (HasTick(m_ticks, ModuleTick::Fixed) && HasTick(moduleTicks, ModuleTick::Fixed)) {
+        module->FixedUpdate(m_deltaTime);
+    }
+    if (HasTick(m_ticks, ModuleTick::Variable) && HasTick(moduleTicks, ModuleTick::Variable)) {
+        module->Update(m_deltaTime);
+    }
+}
+
+bool ModuleScheduler::IsScheduled(size_t nodeIndex) const {
+    return (static_cast<uint8_t>(m_ticks) & static_cast<uint8_t>(m_nodes[nodeIndex].module->GetTick())) != 0;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,271 @@
+#include "Core/Profiler.h"
+#include "Core/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+
+namespace Daisy {
+
+struct ProfileEvent {
+    const char* name;
+    uint64_t startNs;
+    uint64_t endNs;
+};
+
+// Single producer (the owning thread), single consumer (EndFrame)
+struct ProfileThreadBuffer {
+    static constexpr uint64_t Capacity = 1 << 14;
+    
+    std::unique_ptr<ProfileEvent[]> events = std::make_unique<ProfileEvent[]>(Capacity);
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> tail{0};
+    std::atomic<bool> retired{false};
+    uint32_t threadId = 0;
+};
+
+namespace {
+    constexpr size_t MaxTraceEvents = 1 << 20;
+    
+    const std::chrono::steady_clock::time_point s_epoch = std::chrono::steady_clock::now();
+    
+    // Marks the buffer retired when its thread exits so EndFrame can drop it
+    struct ThreadBufferHolder {
+        std::shared_ptr<ProfileThreadBuffer> buffer;
+        
+        ~ThreadBufferHolder() {
+            if (buffer) {
+                buffer->retired.store(true, std::memory_order_release);
+            }
+        }
+    };
+    
+    thread_local ThreadBufferHolder t_buffer;
+    
+    void WriteJsonString(std::ofstream& file, const std::string& text) {
+        file << '"';
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                file << '\\' << c;
+            } else if (static_cast<unsigned char>(c) >= 0x20) {
+                file << c;
+            }
+        }
+        file << '"';
+    }
+}
+
+Profiler& Profiler::GetInstance() {
+    static Profiler instance;
+    return instance;
+}
+
+uint64_t Profiler::Now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - s_epoch).count());
+}
+
+void Profiler::Record(const char* name, uint64_t startNs, uint64_t endNs) {
+    ProfileThreadBuffer& buffer = GetThreadBuffer();
+    
+    uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    if (head - buffer.tail.load(std::memory_order_acquire) >= ProfileThreadBuffer::Capacity) {
+        m_droppedEvents.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    
+    buffer.events[head % ProfileThreadBuffer::Capacity] = ProfileEvent{name, startNs, endNs};
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+ProfileThreadBuffer& Profiler::GetThreadBuffer() {
+    if (!t_buffer.buffer) {
+        auto buffer = std::make_shared<ProfileThreadBuffer>();
+        
+        std::lock_guard<std::mutex> lock(m_buffersMutex);
+        buffer->threadId = m_nextThreadId++;
+        m_buffers.push_back(buffer);
+        t_buffer.buffer = std::move(buffer);
+    }
+    return *t_buffer.buffer;
+}
+
+void Profiler::EndFrame() {
+    std::vector<std::shared_ptr<ProfileThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(m_buffersMutex);
+        buffers = m_buffers;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    
+    for (auto& buffer : buffers) {
+        // Check before draining so events written just before the thread exited are kept
+        bool retired = buffer->retired.load(std::memory_order_acquire);
+        
+        uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            const ProfileEvent& event = buffer->events[tail % ProfileThreadBuffer::Capacity];
+            uint32_t zoneIndex = InternZone(event.name);
+            
+            Zone& zone = m_zones[zoneIndex];
+            zone.frameTotalNs += event.endNs - event.startNs;
+            zone.frameCalls++;
+            
+            if (m_tracing && m_traceEvents.size() < MaxTraceEvents) {
+                m_traceEvents.push_back(TraceEvent{zoneIndex, buffer->threadId, event.startNs, event.endNs});
+            }
+        }
+        buffer->tail.store(tail, std::memory_order_release);
+        
+        if (retired) {
+            std::lock_guard<std::mutex> buffersLock(m_buffersMutex);
+            m_buffers.erase(std::remove(m_buffers.begin(), m_buffers.end(), buffer), m_buffers.end());
+        }
+    }
+    
+    // Names are only promised valid until now, and a freed name's address can
+    // come back as another name, so pointers are looked up again next frame
+    m_zonesByPointer.clear();
+    
+    // Zones that did not run this frame keep their window untouched
+    for (auto& zone : m_zones) {
+        if (zone.frameCalls == 0) {
+            continue;
+        }
+        
+        zone.lastMs = zone.frameTotalNs / 1'000'000.0;
+        zone.lastCalls = zone.frameCalls;
+        if (zone.samples.size() < ProfileWindowFrames) {
+            zone.samples.push_back(static_cast<float>(zone.lastMs));
+        } else {
+            zone.samples[zone.nextSample] = static_cast<float>(zone.lastMs);
+        }
+        zone.nextSample = (zone.nextSample + 1) % ProfileWindowFrames;
+        
+        zone.frameTotalNs = 0;
+        zone.frameCalls = 0;
+    }
+}
+
+uint32_t Profiler::InternZone(const char* name) {
+    auto it = m_zonesByPointer.find(name);
+    if (it != m_zonesByPointer.end()) {
+        return it->second;
+    }
+    
+    // Different pointers to the same text share a zone
+    std::string zoneName(name);
+    auto [nameIt, inserted] = m_zonesByName.try_emplace(zoneName, static_cast<uint32_t>(m_zones.size()));
+    if (inserted) {
+        Zone zone;
+        zone.name = std::move(zoneName);
+        zone.samples.reserve(ProfileWindowFrames);
+        m_zones.push_back(std::move(zone));
+    }
+    
+    m_zonesByPointer.emplace(name, nameIt->second);
+    return nameIt->second;
+}
+
+bool Profiler::GetZoneStats(const std::string& name, ProfileZoneStats& stats) const {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    
+    auto it = m_zonesByName.find(name);
+    if (it == m_zonesByName.end() || m_zones[it->second].samples.empty()) {
+        return false;
+    }
+    
+    FillStats(m_zones[it->second], stats);
+    return true;
+}
+
+std::vector<ProfileZoneStats> Profiler::GetAllZoneStats() const {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    
+    std::vector<ProfileZoneStats> result;
+    for (const auto& zone : m_zones) {
+        if (!zone.samples.empty()) {
+            FillStats(zone, result.emplace_back());
+        }
+    }
+    
+    std::sort(result.begin(), result.end(), [](const ProfileZoneStats& a, const ProfileZoneStats& b) {
+        return a.averageMs > b.averageMs;
+    });
+    return result;
+}
+
+void Profiler::FillStats(const Zone& zone, ProfileZoneStats& stats) const {
+    std::vector<float> sorted = zone.samples;
+    std::sort(sorted.begin(), sorted.end());
+    
+    double total = 0.0;
+    for (float sample : sorted) {
+        total += sample;
+    }
+    
+    size_t p99Index = std::min(sorted.size() - 1, (sorted.size() * 99) / 100);
+    
+    stats.name = zone.name;
+    stats.lastMs = zone.lastMs;
+    stats.minMs = sorted.front();
+    stats.averageMs = total / sorted.size();
+    stats.p99Ms = sorted[p99Index];
+    stats.callsLastFrame = zone.lastCalls;
+}
+
+void Profiler::ResetStats() {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    
+    for (auto& zone : m_zones) {
+        zone.samples.clear();
+        zone.nextSample = 0;
+        zone.lastMs = 0.0;
+        zone.lastCalls = 0;
+    }
+}
+
+void Profiler::BeginTrace() {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    
+    m_traceEvents.clear();
+    m_tracing = true;
+}
+
+bool Profiler::EndTrace(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    
+    if (!m_tracing) {
+        DAISY_WARNING("Profiler trace was not started");
+        return false;
+    }
+    m_tracing = false;
+    
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+        DAISY_ERROR("Failed to open profiler trace file: {}", path);
+        return false;
+    }
+    
+    // Complete ("X") events, timestamps in microseconds
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (size_t i = 0; i < m_traceEvents.size(); ++i) {
+        const TraceEvent& event = m_traceEvents[i];
+        file << (i > 0 ? ",\n" : "\n") << "{\"name\":";
+        WriteJsonString(file, m_zones[event.zone].name);
+        file << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.threadId
+             << ",\"ts\":" << event.startNs / 1000.0
+             << ",\"dur\":" << (event.endNs - event.startNs) / 1000.0 << "}";
+    }
+    file << "\n]}\n";
+    
+    DAISY_INFO("Profiler trace written: {} ({} events)", path, m_traceEvents.size());
+    m_traceEvents.clear();
+    m_traceEvents.shrink_to_fit();
+    return true;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include "Core/SimdMath.h"
+
+namespace Daisy::Simd {
+
+void TransformPoints(const Matrix4& m, const Vector3* points, Vector3* out, size_t count) {
+#if defined(DAISY_SIMD_SSE41)
+    __m128 c0 = _mm_loadu_ps(m.m);
+    __m128 c1 = _mm_loadu_ps(m.m + 4);
+    __m128 c2 = _mm_loadu_ps(m.m + 8);
+    __m128 c3 = _mm_loadu_ps(m.m + 12);
+    for (size_t i = 0; i < count; ++i) {
+        __m128 r = _mm_add_ps(c3, _mm_mul_ps(c0, _mm_set1_ps(points[i].x)));
+        r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_set1_ps(points[i].y)));
+        r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(points[i].z)));
+        // Three floats only: a full store would clobber the next point before it is read
+        float* target = &out[i].x;
+        _mm_storel_pi(reinterpret_cast<__m64*>(target), r);
+        _mm_store_ss(target + 2, _mm_movehl_ps(r, r));
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        Vector3 p = points[i];
+        out[i] = Vector3(m.m[0] * p.x + m.m[4] * p.y + m.m[8]  * p.z + m.m[12],
+                         m.m[1] * p.x + m.m[5] * p.y + m.m[9]  * p.z + m.m[13],
+                         m.m[2] * p.x + m.m[6] * p.y + m.m[10] * p.z + m.m[14]);
+    }
+#endif
+}
+
+void TransformVectors(const Matrix4& m, const Vector4* vectors, Vector4* out, size_t count) {
+    size_t i = 0;
+#if defined(DAISY_SIMD_AVX2)
+    // Two vectors per register; each column is repeated in both halves
+    __m256 c0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m.m));
+    __m256 c1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m.m + 4));
+    __m256 c2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m.m + 8));
+    __m256 c3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m.m + 12));
+    for (; i + 2 <= count; i += 2) {
+        __m256 v = _mm256_loadu_ps(&vectors[i].x);
+        __m256 r = _mm256_mul_ps(c0, _mm256_permute_ps(v, 0x00));
+        r = _mm256_add_ps(r, _mm256_mul_ps(c1, _mm256_permute_ps(v, 0x55)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(c2, _mm256_permute_ps(v, 0xAA)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(c3, _mm256_permute_ps(v, 0xFF)));
+        _mm256_storeu_ps(&out[i].x, r);
+    }
+#endif
+    for (; i < count; ++i) {
+        TransformVector4(m.m, &vectors[i].x, &out[i].x);
+    }
+}
+
+void MultiplyMatrices(const Matrix4* a, const Matrix4* b, Matrix4* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        MultiplyMatrix4(a[i].m, b[i].m, out[i].m);
+    }
+}
+
+void MultiplyAdd(const Vector3* a, const Vector3* b, float scale, Vector3* out, size_t count) {
+    // Element-wise, so the arrays can be processed as flat floats
+    const float* fa = &a->x;
+    const float* fb = &b->x;
+    float* fo = &out->x;
+    size_t floatCount = count * 3;
+    size_t i = 0;
+#if defined(DAISY_SIMD_AVX2)
+    __m256 s8 = _mm256_set1_ps(scale);
+    for (; i + 8 <= floatCount; i += 8) {
+        __m256 r = _mm256_add_ps(_mm256_loadu_ps(fa + i), _mm256_mul_ps(_mm256_loadu_ps(fb + i), s8));
+        _mm256_storeu_ps(fo + i, r);
+    }
+#endif
+#if defined(DAISY_SIMD_SSE41)
+    __m128 s4 = _mm_set1_ps(scale);
+    for (; i + 4 <= floatCount; i += 4) {
+        __m128 r = _mm_add_ps(_mm_loadu_ps(fa + i), _mm_mul_ps(_mm_loadu_ps(fb + i), s4));
+        _mm_storeu_ps(fo + i, r);
+    }
+#endif
+    for (; i < floatCount; ++i) {
+        fo[i] = fa[i] + fb[i] * scale;
+    }
+}
+
+void NormalizeQuaternions(Quaternion* quaternions, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        NormalizeQuaternion(&quaternions[i].x, &quaternions[i].x);
+    }
+}
+
+void TransformPoints(const Matrix4& m, ConstVector3Stream points, Vector3Stream out, size_t count) {
+    size_t i = 0;
+#if defined(DAISY_SIMD_AVX2)
+    __m256 m0 = _mm256_set1_ps(m.m[0]), m1 = _mm256_set1_ps(m.m[1]), m2 = _mm256_set1_ps(m.m[2]);
+    __m256 m4 = _mm256_set1_ps(m.m[4]), m5 = _mm256_set1_ps(m.m[5]), m6 = _mm256_set1_ps(m.m[6]);
+    __m256 m8 = _mm256_set1_ps(m.m[8]), m9 = _mm256_set1_ps(m.m[9]), m10 = _mm256_set1_ps(m.m[10]);
+    __m256 m12 = _mm256_set1_ps(m.m[12]), m13 = _mm256_set1_ps(m.m[13]), m14 = _mm256_set1_ps(m.m[14]);
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(points.x + i);
+        __m256 y = _mm256_loadu_ps(points.y + i);
+        __m256 z = _mm256_loadu_ps(points.z + i);
+        __m256 rx = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m0, x), _mm256_mul_ps(m4, y)), _mm256_add_ps(_mm256_mul_ps(m8, z), m12));
+        __m256 ry = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m1, x), _mm256_mul_ps(m5, y)), _mm256_add_ps(_mm256_mul_ps(m9, z), m13));
+        __m256 rz = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m2, x), _mm256_mul_ps(m6, y)), _mm256_add_ps(_mm256_mul_ps(m10, z), m14));
+        _mm256_storeu_ps(out.x + i, rx);
+        _mm256_storeu_ps(out.y + i, ry);
+        _mm256_storeu_ps(out.z + i, rz);
+    }
+#endif
+#if defined(DAISY_SIMD_SSE41)
+    __m128 n0 = _mm_set1_ps(m.m[0]), n1 = _mm_set1_ps(m.m[1]), n2 = _mm_set1_ps(m.m[2]);
+    __m128 n4 = _mm_set1_ps(m.m[4]), n5 = _mm_set1_ps(m.m[5]), n6 = _mm_set1_ps(m.m[6]);
+    __m128 n8 = _mm_set1_ps(m.m[8]), n9 = _mm_set1_ps(m.m[9]), n10 = _mm_set1_ps(m.m[10]);
+    __m128 n12 = _mm_set1_ps(m.m[12]), n13 = _mm_set1_ps(m.m[13]), n14 = _mm_set1_ps(m.m[14]);
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(points.x + i);
+        __m128 y = _mm_loadu_ps(points.y + i);
+        __m128 z = _mm_loadu_ps(points.z + i);
+        __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(n0, x), _mm_mul_ps(n4, y)), _mm_add_ps(_mm_mul_ps(n8, z), n12));
+        __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(n1, x), _mm_mul_ps(n5, y)), _mm_add_ps(_mm_mul_ps(n9, z), n13));
+        __m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(n2, x), _mm_mul_ps(n6, y)), _mm_add_ps(_mm_mul_ps(n10, z), n14));
+        _mm_storeu_ps(out.x + i, rx);
+        _mm_storeu_ps(out.y + i, ry);
+        _mm_storeu_ps(out.z + i, rz);
+    }
+#endif
+    for (; i < count; ++i) {
+        float x = points.x[i], y = points.y[i], z = points.z[i];
+        out.x[i] = m.m[0] * x + m.m[4] * y + (m.m[8]  * z + m.m[12]);
+        out.y[i] = m.m[1] * x + m.m[5] * y + (m.m[9]  * z + m.m[13]);
+        out.z[i] = m.m[2] * x + m.m[6] * y + (m.m[10] * z + m.m[14]);
+    }
+}
+
+namespace {
+    template<bool SquareRoot>
+    void ComputeDistances(ConstVector3Stream points, const Vector3& origin, float* out, size_t count) {
+        size_t i = 0;
+#if defined(DAISY_SIMD_AVX2)
+        __m256 ox8 = _mm256_set1_ps(origin.x), oy8 = _mm256_set1_ps(origin.y), oz8 = _mm256_set1_ps(origin.z);
+        for (; i + 8 <= count; i += 8) {
+            __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(points.x + i), ox8);
+            __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(points.y + i), oy8);
+            __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(points.z + i), oz8);
+            __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+            _mm256_storeu_ps(out + i, SquareRoot ? _mm256_sqrt_ps(d) : d);
+        }
+#endif
+#if defined(DAISY_SIMD_SSE41)
+        __m128 ox4 = _mm_set1_ps(origin.x), oy4 = _mm_set1_ps(origin.y), oz4 = _mm_set1_ps(origin.z);
+        for (; i + 4 <= count; i += 4) {
+            __m128 dx = _mm_sub_ps(_mm_loadu_ps(points.x + i), ox4);
+            __m128 dy = _mm_sub_ps(_mm_loadu_ps(points.y + i), oy4);
+            __m128 dz = _mm_sub_ps(_mm_loadu_ps(points.z + i), oz4);
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+            _mm_storeu_ps(out + i, SquareRoot ? _mm_sqrt_ps(d) : d);
+        }
+#endif
+        for (; i < count; ++i) {
+            float dx = points.x[i] - origin.x;
+            float dy = points.y[i] - origin.y;
+            float dz = points.z[i] - origin.z;
+            float d = dx * dx + dy * dy + dz * dz;
+            out[i] = SquareRoot ? std::sqrt(d) : d;
+        }
+    }
+}
+
+void DistancesSquared(ConstVector3Stream points, const Vector3& origin, float* out, size_t count) {
+    ComputeDistances<false>(points, origin, out, count);
+}
+
+void Distances(ConstVector3Stream points, const Vector3& origin, float* out, size_t count) {
+    ComputeDistances<true>(points, origin, out, count);
+}
+
+void NormalizeQuaternions(QuaternionStream q, size_t count) {
+    size_t i = 0;
+#if defined(DAISY_SIMD_AVX2)
+    __m256 zero8 = _mm256_setzero_ps(), one8 = _mm256_set1_ps(1.0f);
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(q.x + i), y = _mm256_loadu_ps(q.y + i);
+        __m256 z = _mm256_loadu_ps(q.z + i), w = _mm256_loadu_ps(q.w + i);
+        __m256 lengthSquared = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)),
+                                             _mm256_add_ps(_mm256_mul_ps(z, z), _mm256_mul_ps(w, w)));
+        __m256 valid = _mm256_cmp_ps(lengthSquared, zero8, _CMP_GT_OQ);
+        // Zero lanes divide by one instead of zero and are then replaced
+        __m256 length = _mm256_blendv_ps(one8, _mm256_sqrt_ps(lengthSquared), valid);
+        _mm256_storeu_ps(q.x + i, _mm256_and_ps(_mm256_div_ps(x, length), valid));
+        _mm256_storeu_ps(q.y + i, _mm256_and_ps(_mm256_div_ps(y, length), valid));
+        _mm256_storeu_ps(q.z + i, _mm256_and_ps(_mm256_div_ps(z, length), valid));
+        _mm256_storeu_ps(q.w + i, _mm256_blendv_ps(one8, _mm256_div_ps(w, length), valid));
+    }
+#endif
+#if defined(DAISY_SIMD_SSE41)
+    __m128 zero4 = _mm_setzero_ps(), one4 = _mm_set1_ps(1.0f);
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(q.x + i), y = _mm_loadu_ps(q.y + i);
+        __m128 z = _mm_loadu_ps(q.z + i), w = _mm_loadu_ps(q.w + i);
+        __m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)),
+                                          _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w)));
+        __m128 valid = _mm_cmpgt_ps(lengthSquared, zero4);
+        __m128 length = _mm_blendv_ps(one4, _mm_sqrt_ps(lengthSquared), valid);
+        _mm_storeu_ps(q.x + i, _mm_and_ps(_mm_div_ps(x, length), valid));
+        _mm_storeu_ps(q.y + i, _mm_and_ps(_mm_div_ps(y, length), valid));
+        _mm_storeu_ps(q.z + i, _mm_and_ps(_mm_div_ps(z, length), valid));
+        _mm_storeu_ps(q.w + i, _mm_blendv_ps(one4, _mm_div_ps(w, length), valid));
+    }
+#endif
+    for (; i < count; ++i) {
+        float quaternion[4] = {q.x[i], q.y[i], q.z[i], q.w[i]};
+        NormalizeQuaternion(quaternion, quaternion);
+        q.x[i] = quaternion[0];
+        q.y[i] = quaternion[1];
+        q.z[i] = quaternion[2];
+        q.w[i] = quaternion[3];
+    }
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,322 @@
+#include "Core/VirtualMemory.h"
+#include "Core/Logger.h"
+#include <algorithm>
+#include <fstream>
+#include <string>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace Daisy {
+
+namespace {
+    constexpr size_t DefaultLargePageSize = 2 * 1024 * 1024;
+    
+    size_t AlignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+    
+#if !defined(_WIN32)
+    constexpr int MemoryPolicyBind = 2;     // MPOL_BIND from <linux/mempolicy.h>
+    
+    size_t ReadLargePageSize() {
+        std::ifstream pmdSize("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size");
+        size_t size = 0;
+        if (pmdSize >> size && size > 0) {
+            return size;
+        }
+        
+        std::ifstream meminfo("/proc/meminfo");
+        std::string key;
+        while (meminfo >> key) {
+            if (key == "Hugepagesize:" && meminfo >> size) {
+                return size * 1024;
+            }
+            meminfo.ignore(256, '\n');
+        }
+        return DefaultLargePageSize;
+    }
+    
+    uint32_t ReadNumaNodeCount() {
+        // "0", "0-1" or a list such as "0,2-3"; the highest node number is last
+        std::ifstream online("/sys/devices/system/node/online");
+        std::string nodes;
+        if (!(online >> nodes) || nodes.empty()) {
+            return 1;
+        }
+        size_t start = nodes.find_last_of(",-");
+        return static_cast<uint32_t>(std::stoul(nodes.substr(start == std::string::npos ? 0 : start + 1))) + 1;
+    }
+#endif
+}
+
+namespace VirtualMemory {
+
+size_t GetPageSize() {
+    static const size_t pageSize = [] {
+#if defined(_WIN32)
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return static_cast<size_t>(info.dwPageSize);
+#else
+        return static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+#endif
+    }();
+    return pageSize;
+}
+
+size_t GetLargePageSize() {
+    static const size_t largePageSize = [] {
+#if defined(_WIN32)
+        size_t size = GetLargePageMinimum();
+        return size > 0 ? size : DefaultLargePageSize;
+#else
+        return ReadLargePageSize();
+#endif
+    }();
+    return largePageSize;
+}
+
+uint32_t GetNumaNodeCount() {
+    static const uint32_t nodeCount = [] {
+#if defined(_WIN32)
+        ULONG highestNode = 0;
+        return GetNumaHighestNodeNumber(&highestNode) ? static_cast<uint32_t>(highestNode) + 1 : 1u;
+#else
+        return ReadNumaNodeCount();
+#endif
+    }();
+    return nodeCount;
+}
+
+}
+
+VirtualMemoryRegion::~VirtualMemoryRegion() {
+    Release();
+}
+
+bool VirtualMemoryRegion::Reserve(size_t size, const VirtualMemorySettings& settings) {
+    Release();
+    
+    size_t pageSize = VirtualMemory::GetPageSize();
+    size_t largePageSize = VirtualMemory::GetLargePageSize();
+    LargePageMode largePages = settings.largePages;
+    
+#if defined(_WIN32)
+    // Windows only hands out large pages committed in full at allocation time
+    if (largePages == LargePageMode::Explicit) {
+        DAISY_WARNING("Explicit large pages cannot be committed on demand on Windows, using regular pages");
+    }
+    largePages = LargePageMode::None;
+    size = AlignUp(size, pageSize);
+    
+    void* base = VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+    if (!base) {
+        DAISY_ERROR("Failed to reserve {} bytes of address space", size);
+        return false;
+    }
+    m_base = static_cast<std::byte*>(base);
+#else
+    size = AlignUp(size, largePages == LargePageMode::None ? pageSize : largePageSize);
+    
+    if (largePages == LargePageMode::Explicit) {
+        // Hugetlb mappings reserve their pool pages here, so commits cannot fail later
+        void* base = ::mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (base != MAP_FAILED) {
+            m_base = static_cast<std::byte*>(base);
+        } else {
+            DAISY_WARNING("Not enough free huge pages for {} bytes, using transparent huge pages; "
+                          "set a smaller reserveSize or budget to stay on explicit huge pages", size);
+            largePages = LargePageMode::Transparent;
+        }
+    }
+    
+    if (!m_base) {
+        // Over-reserve so the region can start on a large page boundary, then trim
+        size_t alignment = largePages == LargePageMode::None ? pageSize : largePageSize;
+        size_t mappedSize = size + alignment - pageSize;
+        void* mapped = ::mmap(nullptr, mappedSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (mapped == MAP_FAILED) {
+            DAISY_ERROR("Failed to reserve {} bytes of address space", size);
+            return false;
+        }
+        
+        std::byte* mappedBase = static_cast<std::byte*>(mapped);
+        std::byte* base = reinterpret_cast<std::byte*>(AlignUp(reinterpret_cast<uintptr_t>(mappedBase), alignment));
+        if (base > mappedBase) {
+            ::munmap(mappedBase, base - mappedBase);
+        }
+        if (base + size < mappedBase + mappedSize) {
+            ::munmap(base + size, (mappedBase + mappedSize) - (base + size));
+        }
+        m_base = base;
+        
+        if (largePages == LargePageMode::Transparent && ::madvise(m_base, size, MADV_HUGEPAGE) != 0) {
+            DAISY_WARNING("Transparent huge pages are unavailable for {} bytes, using regular pages", size);
+            largePages = LargePageMode::None;
+        }
+    }
+#endif
+
+    m_reservedSize = size;
+    m_largePages = largePages;
+    m_granule = largePages == LargePageMode::None ? pageSize : largePageSize;
+    m_committedSize = 0;
+    m_numaNode = -1;
+    
+    if (settings.numaNode >= 0) {
+#if defined(_WIN32)
+        // Applied per commit through VirtualAllocExNuma
+        if (static_cast<uint32_t>(settings.numaNode) < VirtualMemory::GetNumaNodeCount()) {
+            m_numaNode = settings.numaNode;
+        }
+#else
+        // Applies to every page faulted into the region from now on
+        if (settings.numaNode < 63) {
+            unsigned long nodeMask = 1ul << settings.numaNode;
+            if (::syscall(SYS_mbind, m_base, m_reservedSize, MemoryPolicyBind, &nodeMask, 64, 0) == 0) {
+                m_numaNode = settings.numaNode;
+            }
+        }
+#endif
+        if (m_numaNode < 0) {
+            DAISY_WARNING("Cannot bind memory to NUMA node {}, placement is left to the OS", settings.numaNode);
+        }
+    }
+    
+    return true;
+}
+
+void VirtualMemoryRegion::Release() {
+    if (!m_base) {
+        return;
+    }
+    
+#if defined(_WIN32)
+    VirtualFree(m_base, 0, MEM_RELEASE);
+#else
+    ::munmap(m_base, m_reservedSize);
+#endif
+
+    m_base = nullptr;
+    m_reservedSize = 0;
+    m_committedSize = 0;
+}
+
+bool VirtualMemoryRegion::Commit(size_t offset, size_t size) {
+    if (!m_base || offset + size > m_reservedSize) {
+        return false;
+    }
+    
+    std::byte* address = m_base + offset;
+#if defined(_WIN32)
+    void* committed = m_numaNode >= 0
+        ? VirtualAllocExNuma(GetCurrentProcess(), address, size, MEM_COMMIT, PAGE_READWRITE, static_cast<DWORD>(m_numaNode))
+        : VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE);
+    if (!committed) {
+        return false;
+    }
+#else
+    if (::mprotect(address, size, PROT_READ | PROT_WRITE) != 0) {
+        return false;
+    }
+#endif
+
+    m_committedSize += size;
+    return true;
+}
+
+void VirtualMemoryRegion::Decommit(size_t offset, size_t size) {
+    if (!m_base || offset + size > m_reservedSize) {
+        return;
+    }
+    
+    std::byte* address = m_base + offset;
+#if defined(_WIN32)
+    VirtualFree(address, size, MEM_DECOMMIT);
+#else
+    // Drops the physical pages; the range reads back as zeros if committed again
+    ::madvise(address, size, MADV_DONTNEED);
+    ::mprotect(address, size, PROT_NONE);
+#endif
+
+    m_committedSize -= size;
+}
+
+VirtualMemoryResource::VirtualMemoryResource(const VirtualMemorySettings& settings, size_t reserveSize,
+                                             size_t minAllocationSize, std::pmr::memory_resource* upstream)
+    : m_upstream(upstream ? upstream : std::pmr::new_delete_resource())
+    , m_minAllocationSize(minAllocationSize) {
+    if (!m_region.Reserve(reserveSize, settings)) {
+        DAISY_WARNING("Large arrays will be allocated from the heap");
+    }
+}
+
+size_t VirtualMemoryResource::GetReserveSize(const VirtualMemorySettings& settings, size_t hardLimit) {
+    if (settings.reserveSize > 0) {
+        return settings.reserveSize;
+    }
+    if (hardLimit == 0) {
+        return DefaultReserveSize;
+    }
+    return settings.largePages == LargePageMode::Explicit ? hardLimit : hardLimit * BudgetReserveFactor;
+}
+
+size_t VirtualMemoryResource::GetLiveBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_liveBytes;
+}
+
+void* VirtualMemoryResource::do_allocate(size_t bytes, size_t alignment) {
+    if (bytes < m_minAllocationSize || !m_region.IsReserved()) {
+        return m_upstream->allocate(bytes, alignment);
+    }
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    // Whole granules only, so freeing one allocation never touches a neighbour's pages
+    size_t granule = m_region.GetCommitGranule();
+    size_t size = AlignUp(bytes, granule);
+    size_t offset = AlignUp(m_top, std::max(granule, alignment));
+    
+    if (offset + size > m_region.GetReservedSize() || !m_region.Commit(offset, size)) {
+        if (!m_exhaustedLogged) {
+            DAISY_WARNING("Virtual memory region of {} bytes is exhausted, large arrays now come from the heap",
+                          m_region.GetReservedSize());
+            m_exhaustedLogged = true;
+        }
+        return m_upstream->allocate(bytes, alignment);
+    }
+    
+    m_top = offset + size;
+    m_liveBytes += size;
+    return m_region.GetBase() + offset;
+}
+
+void VirtualMemoryResource::do_deallocate(void* ptr, size_t bytes, size_t alignment) {
+    if (!m_region.Contains(ptr)) {
+        m_upstream->deallocate(ptr, bytes, alignment);
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    size_t offset = static_cast<size_t>(static_cast<std::byte*>(ptr) - m_region.GetBase());
+    size_t size = AlignUp(bytes, m_region.GetCommitGranule());
+    m_region.Decommit(offset, size);
+    m_liveBytes -= size;
+    
+    // Only the most recent allocation gives its address space back
+    if (offset + size == m_top) {
+        m_top = offset;
+    }
+}
+
+}
\ No newline at end of file
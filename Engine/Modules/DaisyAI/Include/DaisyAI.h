@@ -2,6 +2,8 @@
 
 #include "Core/Module.h"
 #include "Core/Math.h"
+#include "Core/SlotMap.h"
+#include "DaisyPhysics.h"
 #include <vector>
 #include <memory>
 #include <unordered_map>
@@ -18,11 +20,16 @@ enum class AIBehaviorType {
     Survival     // Basic needs, resource gathering
 };
 
+struct AIAgent;
+using AIAgentHandle = Handle<AIAgent>;
+
 struct AIAgent {
-    uint32_t id = 0;
+    AIAgentHandle id;
     std::string name;
     Vector3 position{0, 0, 0};
     Vector3 target{0, 0, 0};
+    // When set, position follows this body every update
+    RigidBodyHandle body;
     
     AIBehaviorType primaryBehavior = AIBehaviorType::Survival;
     std::vector<AIBehaviorType> secondaryBehaviors;
@@ -34,7 +41,7 @@ struct AIAgent {
     float curiosity = 0.5f;
     
     std::unordered_map<std::string, float> resources;
-    std::vector<uint32_t> relationships; // Other agent IDs
+    std::vector<AIAgentHandle> relationships; // Other agents
     std::queue<std::string> goals;
     
     bool isActive = true;
@@ -49,7 +56,7 @@ struct EconomicSystem {
 };
 
 struct SocialStructure {
-    std::unordered_map<uint32_t, std::vector<uint32_t>> factions;
+    std::unordered_map<uint32_t, std::vector<AIAgentHandle>> factions;
     std::unordered_map<uint32_t, std::string> territories;
     std::vector<std::string> laws;
     float overallStability = 1.0f;
@@ -57,7 +64,7 @@ struct SocialStructure {
 
 struct CombatSystem {
     struct CombatGroup {
-        std::vector<uint32_t> agentIds;
+        std::vector<AIAgentHandle> agentIds;
         Vector3 position;
         std::string target;
         float strength = 1.0f;
@@ -76,13 +83,21 @@ public:
     void Update(float deltaTime) override;
     void Shutdown() override;
     
-    uint32_t CreateAIAgent(const std::string& name, const Vector3& position);
-    void DestroyAIAgent(uint32_t agentId);
-    AIAgent* GetAIAgent(uint32_t agentId);
+    // Positions given to and kept by the AI are local to the engine's floating
+    // origin and are shifted whenever it rebases
+    
+    // Returns an invalid handle once the agent limit is reached
+    AIAgentHandle CreateAIAgent(const std::string& name, const Vector3& position);
+    void DestroyAIAgent(AIAgentHandle agentId);
+    // Valid until the next CreateAIAgent or DestroyAIAgent
+    AIAgent* GetAIAgent(AIAgentHandle agentId);
     
-    void SetAgentBehavior(uint32_t agentId, AIBehaviorType behavior);
-    void AddAgentGoal(uint32_t agentId, const std::string& goal);
-    void SetAgentPersonality(uint32_t agentId, float aggression, float intelligence, float cooperation);
+    void SetAgentBehavior(AIAgentHandle agentId, AIBehaviorType behavior);
+    void AddAgentGoal(AIAgentHandle agentId, const std::string& goal);
+    void SetAgentPersonality(AIAgentHandle agentId, float aggression, float intelligence, float cooperation);
+    // The agent takes its position from the body, read after DaisyPhysics has
+    // stepped; an invalid handle, or the body being destroyed, unbinds it
+    void SetAgentBody(AIAgentHandle agentId, RigidBodyHandle body);
     
     void EnableLearning(bool enable) { m_learningEnabled = enable; }
     void SetSimulationSpeed(float speed) { m_simulationSpeed = speed; }
@@ -95,6 +110,7 @@ public:
     void TriggerEvent(const std::string& eventType, const Vector3& position, float severity = 1.0f);
     
 private:
+    void SyncAgentBodies();
     void UpdateEconomicAI(float deltaTime);
     void UpdateSocialAI(float deltaTime);
     void UpdateCombatAI(float deltaTime);
@@ -109,13 +125,14 @@ private:
     void SpawnNewAgents();
     void RemoveInactiveAgents();
     
-    std::unordered_map<uint32_t, std::unique_ptr<AIAgent>> m_agents;
+    void OnOriginRebased(const DVector3& previous, const DVector3& current);
+    
+    SlotMap<AIAgent> m_agents;
     
     EconomicSystem m_economicSystem;
     SocialStructure m_socialStructure;
     CombatSystem m_combatSystem;
     
-    uint32_t m_nextAgentId = 1;
     uint32_t m_maxAgents = 10000;
     
     float m_simulationSpeed = 1.0f;
@@ -127,6 +144,8 @@ private:
     float m_explorationUpdateTimer = 0.0f;
     
     std::vector<std::pair<std::string, Vector3>> m_recentEvents;
+    
+    uint32_t m_rebaseListener = 0;
 };
 
 }
\ No newline at end of file
@@ -1,23 +1,34 @@
 #include "DaisyAI.h"
+#include "Core/Engine.h"
 #include "Core/Logger.h"
+#include "Core/SimdMath.h"
 
 namespace Daisy {
 
-DaisyAI::DaisyAI() : Module("DaisyAI") {
+DaisyAI::DaisyAI() : Module("DaisyAI"), m_agents(&GetMemoryResource()) {
+    SetThreading(ModuleThreading::Worker);
+    SetTick(ModuleTick::Fixed);
+    // Agents bound to rigid bodies read their positions after the physics step
+    ReadsModule<DaisyPhysics>();
 }
 
 bool DaisyAI::Initialize() {
-    DAISY_INFO("Initializing Daisy AI Engine");
+    DAISY_CHANNEL_INFO(AI, "Initializing Daisy AI Engine");
     
-    m_agents.reserve(m_maxAgents);
+    m_agents.Reserve(m_maxAgents);
     
     // Initialize economic system
     m_economicSystem.globalPrices["energy"] = 1.0f;
     m_economicSystem.globalPrices["materials"] = 2.0f;
     m_economicSystem.globalPrices["food"] = 0.5f;
     
+    if (Engine* engine = GetEngine()) {
+        m_rebaseListener = engine->GetFloatingOrigin().AddRebaseListener(
+            [this](const DVector3& previous, const DVector3& current) { OnOriginRebased(previous, current); });
+    }
+    
     m_initialized = true;
-    DAISY_INFO("Daisy AI Engine initialized successfully");
+    DAISY_CHANNEL_INFO(AI, "Daisy AI Engine initialized successfully");
     return true;
 }
 
@@ -26,11 +37,13 @@ void DaisyAI::Update(float deltaTime) {
     
     deltaTime *= m_simulationSpeed;
     
-    for (auto& [id, agent] : m_agents) {
-        if (agent->isActive) {
-            ProcessAgentBehavior(*agent, deltaTime);
-            ProcessAgentGoals(*agent);
-            UpdateAgentRelationships(*agent);
+    SyncAgentBodies();
+    
+    for (auto& agent : m_agents) {
+        if (agent.isActive) {
+            ProcessAgentBehavior(agent, deltaTime);
+            ProcessAgentGoals(agent);
+            UpdateAgentRelationships(agent);
         }
     }
     
@@ -54,22 +67,28 @@ void DaisyAI::Update(float deltaTime) {
 void DaisyAI::Shutdown() {
     if (!m_initialized) return;
     
-    DAISY_INFO("Shutting down Daisy AI Engine");
+    DAISY_CHANNEL_INFO(AI, "Shutting down Daisy AI Engine");
     
-    m_agents.clear();
+    if (Engine* engine = GetEngine()) {
+        engine->GetFloatingOrigin().RemoveRebaseListener(m_rebaseListener);
+    }
+    
+    m_agents.Clear();
     m_recentEvents.clear();
     
     m_initialized = false;
-    DAISY_INFO("Daisy AI Engine shut down successfully");
+    DAISY_CHANNEL_INFO(AI, "Daisy AI Engine shut down successfully");
 }
 
-uint32_t DaisyAI::CreateAIAgent(const std::string& name, const Vector3& position) {
-    if (m_agents.size() >= m_maxAgents) {
-        return 0;
+AIAgentHandle DaisyAI::CreateAIAgent(const std::string& name, const Vector3& position) {
+    if (m_agents.Size() >= m_maxAgents) {
+        return AIAgentHandle{};
     }
     
-    auto agent = std::make_unique<AIAgent>();
-    agent->id = m_nextAgentId++;
+    AIAgentHandle id = m_agents.Insert();
+    
+    AIAgent* agent = m_agents.Get(id);
+    agent->id = id;
     agent->name = name;
     agent->position = position;
     
@@ -77,36 +96,32 @@ uint32_t DaisyAI::CreateAIAgent(const std::string& name, const Vector3& position
     agent->resources["materials"] = 5.0f;
     agent->resources["food"] = 20.0f;
     
-    uint32_t id = agent->id;
-    m_agents[id] = std::move(agent);
-    
     return id;
 }
 
-void DaisyAI::DestroyAIAgent(uint32_t agentId) {
-    m_agents.erase(agentId);
+void DaisyAI::DestroyAIAgent(AIAgentHandle agentId) {
+    m_agents.Erase(agentId);
 }
 
-AIAgent* DaisyAI::GetAIAgent(uint32_t agentId) {
-    auto it = m_agents.find(agentId);
-    return it != m_agents.end() ? it->second.get() : nullptr;
+AIAgent* DaisyAI::GetAIAgent(AIAgentHandle agentId) {
+    return m_agents.Get(agentId);
 }
 
-void DaisyAI::SetAgentBehavior(uint32_t agentId, AIBehaviorType behavior) {
+void DaisyAI::SetAgentBehavior(AIAgentHandle agentId, AIBehaviorType behavior) {
     auto* agent = GetAIAgent(agentId);
     if (agent) {
         agent->primaryBehavior = behavior;
     }
 }
 
-void DaisyAI::AddAgentGoal(uint32_t agentId, const std::string& goal) {
+void DaisyAI::AddAgentGoal(AIAgentHandle agentId, const std::string& goal) {
     auto* agent = GetAIAgent(agentId);
     if (agent) {
         agent->goals.push(goal);
     }
 }
 
-void DaisyAI::SetAgentPersonality(uint32_t agentId, float aggression, float intelligence, float cooperation) {
+void DaisyAI::SetAgentPersonality(AIAgentHandle agentId, float aggression, float intelligence, float cooperation) {
     auto* agent = GetAIAgent(agentId);
     if (agent) {
         agent->aggression = Clamp(aggression, 0.0f, 1.0f);
@@ -115,6 +130,31 @@ void DaisyAI::SetAgentPersonality(uint32_t agentId, float aggression, float inte
     }
 }
 
+void DaisyAI::SetAgentBody(AIAgentHandle agentId, RigidBodyHandle body) {
+    auto* agent = GetAIAgent(agentId);
+    if (agent) {
+        agent->body = body;
+    }
+}
+
+void DaisyAI::SyncAgentBodies() {
+    Engine* engine = GetEngine();
+    DaisyPhysics* physics = engine ? engine->GetModule<DaisyPhysics>() : nullptr;
+    if (!physics) return;
+    
+    const FloatingOrigin& origin = engine->GetFloatingOrigin();
+    for (auto& agent : m_agents) {
+        if (!agent.body) {
+            continue;
+        }
+        if (auto body = physics->GetRigidBody(agent.body)) {
+            agent.position = origin.ToLocal(body->position);
+        } else {
+            agent.body = RigidBodyHandle{};
+        }
+    }
+}
+
 void DaisyAI::ProcessAgentBehavior(AIAgent& agent, float deltaTime) {
     switch (agent.primaryBehavior) {
         case AIBehaviorType::Economic:
@@ -198,12 +238,35 @@ void DaisyAI::TriggerEvent(const std::string& eventType, const Vector3& position
     m_recentEvents.emplace_back(eventType, position);
     
     // Notify nearby agents of the event
-    for (auto& [id, agent] : m_agents) {
-        float distance = (agent->position - position).Length();
-        if (distance < 100.0f * severity) {
+    std::span<const AIAgent> agents = m_agents.Values();
+    Vector3Array positions(GetFrameResource());
+    positions.Resize(agents.size());
+    for (size_t i = 0; i < agents.size(); ++i) {
+        positions.Set(i, agents[i].position);
+    }
+    
+    std::pmr::vector<float> distancesSquared(agents.size(), GetFrameResource());
+    Simd::DistancesSquared(positions.GetStream(), position, distancesSquared.data(), agents.size());
+    
+    float radius = std::max(100.0f * severity, 0.0f);
+    for (size_t i = 0; i < agents.size(); ++i) {
+        if (distancesSquared[i] < radius * radius) {
             // Agent reacts to event based on distance and severity
         }
     }
 }
 
+void DaisyAI::OnOriginRebased(const DVector3& previous, const DVector3& current) {
+    for (auto& agent : m_agents) {
+        agent.position = FloatingOrigin::Rebase(agent.position, previous, current);
+        agent.target = FloatingOrigin::Rebase(agent.target, previous, current);
+    }
+    for (auto& combat : m_combatSystem.activeCombats) {
+        combat.position = FloatingOrigin::Rebase(combat.position, previous, current);
+    }
+    for (auto& event : m_recentEvents) {
+        event.second = FloatingOrigin::Rebase(event.second, previous, current);
+    }
+}
+
 }
\ No newline at end of file
@@ -8,10 +8,10 @@ DaisyNet::DaisyNet() : Module("DaisyNet") {
 }
 
 bool DaisyNet::Initialize() {
-    DAISY_INFO("Initializing Daisy Network Engine");
+    DAISY_CHANNEL_INFO(Net, "Initializing Daisy Network Engine");
     
     m_initialized = true;
-    DAISY_INFO("Daisy Network Engine initialized successfully");
+    DAISY_CHANNEL_INFO(Net, "Daisy Network Engine initialized successfully");
     return true;
 }
 
@@ -25,18 +25,18 @@ void DaisyNet::Update(float deltaTime) {
 void DaisyNet::Shutdown() {
     if (!m_initialized) return;
     
-    DAISY_INFO("Shutting down Daisy Network Engine");
+    DAISY_CHANNEL_INFO(Net, "Shutting down Daisy Network Engine");
     
     if (m_connected) {
         Disconnect();
     }
     
     m_initialized = false;
-    DAISY_INFO("Daisy Network Engine shut down successfully");
+    DAISY_CHANNEL_INFO(Net, "Daisy Network Engine shut down successfully");
 }
 
 bool DaisyNet::StartServer(int port) {
-    DAISY_INFO("Starting server on port {}", port);
+    DAISY_CHANNEL_INFO(Net, "Starting server on port {}", port);
     
     m_networkMode = NetworkMode::Server;
     m_connected = true;
@@ -45,7 +45,7 @@ bool DaisyNet::StartServer(int port) {
 }
 
 bool DaisyNet::ConnectToServer(const std::string& address, int port) {
-    DAISY_INFO("Connecting to server at {}:{}", address, port);
+    DAISY_CHANNEL_INFO(Net, "Connecting to server at {}:{}", address, port);
     
     m_networkMode = NetworkMode::Client;
     m_connected = true;
@@ -54,7 +54,7 @@ bool DaisyNet::ConnectToServer(const std::string& address, int port) {
 }
 
 void DaisyNet::Disconnect() {
-    DAISY_INFO("Disconnecting from network");
+    DAISY_CHANNEL_INFO(Net, "Disconnecting from network");
     
     m_connected = false;
     m_connectedClients.clear();
@@ -99,14 +99,14 @@ void DaisyNet::ProcessOutgoingMessages() {
 
 void DaisyNet::HandleClientConnection(uint32_t clientId) {
     m_connectedClients.push_back(clientId);
-    DAISY_INFO("Client {} connected", clientId);
+    DAISY_CHANNEL_INFO(Net, "Client {} connected", clientId);
 }
 
 void DaisyNet::HandleClientDisconnection(uint32_t clientId) {
     auto it = std::find(m_connectedClients.begin(), m_connectedClients.end(), clientId);
     if (it != m_connectedClients.end()) {
         m_connectedClients.erase(it);
-        DAISY_INFO("Client {} disconnected", clientId);
+        DAISY_CHANNEL_INFO(Net, "Client {} disconnected", clientId);
     }
 }
 
@@ -0,0 +1,297 @@
+#pragma once
+
+#include "Core/Math.h"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory_resource>
+#include <vector>
+
+namespace Daisy {
+
+class JobSystem;
+
+// World-space box, in double like body positions so boxes far from the origin
+// keep their size
+struct Aabb {
+    DVector3 min;
+    DVector3 max;
+    
+    static Aabb FromCenter(const DVector3& center, double halfExtent) {
+        DVector3 extent(halfExtent, halfExtent, halfExtent);
+        return Aabb{center - extent, center + extent};
+    }
+    
+    // Touching boxes overlap
+    bool Overlaps(const Aabb& other) const {
+        return min.x <= other.max.x && other.min.x <= max.x &&
+               min.y <= other.max.y && other.min.y <= max.y &&
+               min.z <= other.max.z && other.min.z <= max.z;
+    }
+    
+    bool Contains(const Aabb& other) const {
+        return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+               other.max.x <= max.x && other.max.y <= max.y && other.max.z <= max.z;
+    }
+    
+    Aabb Union(const Aabb& other) const {
+        return Aabb{DVector3(std::min(min.x, other.min.x), std::min(min.y, other.min.y), std::min(min.z, other.min.z)),
+                    DVector3(std::max(max.x, other.max.x), std::max(max.y, other.max.y), std::max(max.z, other.max.z))};
+    }
+    
+    Aabb Expanded(double margin) const {
+        DVector3 extent(margin, margin, margin);
+        return Aabb{min - extent, max + extent};
+    }
+    
+    double SurfaceArea() const {
+        DVector3 size = max - min;
+        return 2.0 * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+    
+    double LargestExtent() const {
+        DVector3 size = max - min;
+        return std::max(size.x, std::max(size.y, size.z));
+    }
+};
+
+// Bounding volume hierarchy that stays balanced under insertion and removal.
+// Leaves store their box grown by a margin, so a proxy only moves in the tree
+// once it leaves that box. Nodes live in one array and refer to each other by
+// index.
+class DynamicAabbTree {
+public:
+    static constexpr uint32_t NullNode = std::numeric_limits<uint32_t>::max();
+    
+    explicit DynamicAabbTree(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    
+    // Room for one Insert, so a caller can do all its allocation up front
+    void ReserveInsert();
+    // Returns the leaf node, which stays valid until Remove
+    uint32_t Insert(const Aabb& bounds, uint32_t proxy, double margin);
+    void Remove(uint32_t leaf);
+    // Returns true if the leaf had to be reinserted
+    bool Move(uint32_t leaf, const Aabb& bounds, double margin);
+    void Clear();
+    
+    uint32_t GetProxy(uint32_t leaf) const { return m_nodes[leaf].proxy; }
+    const Aabb& GetFatBounds(uint32_t leaf) const { return m_nodes[leaf].bounds; }
+    int32_t GetHeight() const { return m_root == NullNode ? 0 : m_nodes[m_root].height; }
+    bool Empty() const { return m_root == NullNode; }
+    
+    // Calls callback(proxy) for every leaf whose fat box overlaps bounds. Safe
+    // to call from several threads while nothing modifies the tree.
+    template<typename Callback>
+    void Query(const Aabb& bounds, Callback&& callback) const {
+        if (m_root == NullNode) {
+            return;
+        }
+        
+        // Balancing keeps the height near 1.44 log2(n), so this depth is never reached
+        uint32_t stack[MaxQueryDepth];
+        size_t count = 0;
+        stack[count++] = m_root;
+        while (count > 0) {
+            const Node& node = m_nodes[stack[--count]];
+            if (!node.bounds.Overlaps(bounds)) {
+                continue;
+            }
+            if (node.IsLeaf()) {
+                callback(node.proxy);
+            } else if (count + 2 <= MaxQueryDepth) {
+                stack[count++] = node.child1;
+                stack[count++] = node.child2;
+            }
+        }
+    }
+    
+private:
+    static constexpr size_t MaxQueryDepth = 128;
+    
+    struct Node {
+        Aabb bounds;
+        uint32_t parent = NullNode;     // Next free node while on the free list
+        uint32_t child1 = NullNode;
+        uint32_t child2 = NullNode;
+        uint32_t proxy = NullNode;
+        int32_t height = 0;             // Leaves are 0, free nodes -1
+        
+        bool IsLeaf() const { return child1 == NullNode; }
+    };
+    
+    uint32_t AllocateNode();
+    void FreeNode(uint32_t node);
+    void InsertLeaf(uint32_t leaf);
+    void RemoveLeaf(uint32_t leaf);
+    void Refit(uint32_t node);
+    uint32_t Balance(uint32_t node);
+    
+    std::pmr::vector<Node> m_nodes;
+    uint32_t m_root = NullNode;
+    uint32_t m_freeList = NullNode;
+};
+
+struct BroadphasePair {
+    uint64_t userDataA;
+    uint64_t userDataB;
+};
+
+// Candidate pairs for the narrowphase. Small moving proxies are swept and
+// pruned along one axis: their min endpoints stay sorted between frames, so
+// the per-frame insertion sort only fixes what moved, and a coarse grid over
+// the other two axes keeps each sweep local. Static and large proxies would
+// stretch the sweep, so they live in a DynamicAabbTree that the swept proxies
+// query instead. Not thread-safe, though FindPairs can spread its own work
+// over a job system.
+class Broadphase {
+public:
+    using ProxyId = uint32_t;
+    static constexpr ProxyId InvalidProxy = std::numeric_limits<ProxyId>::max();
+    // Moving proxies wider than this go into the tree
+    static constexpr double DefaultLargeExtent = 64.0;
+    // How far a tree proxy can move before it is reinserted
+    static constexpr double TreeMargin = 0.5;
+    
+    explicit Broadphase(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    
+    // userData comes back in the pairs. If it throws, nothing changed.
+    ProxyId AddProxy(const Aabb& bounds, uint64_t userData, bool isStatic);
+    // Never allocates, so it is safe while unwinding a failed batch
+    void RemoveProxy(ProxyId proxy);
+    // Call when the box moves; a proxy changes structure when it becomes static or large
+    void UpdateProxy(ProxyId proxy, const Aabb& bounds, bool isStatic);
+    void Clear();
+    
+    // Replaces pairs with every overlapping pair except static against static,
+    // each reported once. With a job system that has workers, the sweep and
+    // tree queries run as jobs; the pairs and their order are the same either way.
+    void FindPairs(std::pmr::vector<BroadphasePair>& pairs, JobSystem* jobSystem = nullptr);
+    
+    void SetLargeExtent(double extent) { m_largeExtent = extent; }
+    double GetLargeExtent() const { return m_largeExtent; }
+    
+    size_t GetProxyCount() const { return m_proxyCount; }
+    size_t GetSweptProxyCount() const { return m_sweptCount; }
+    const DynamicAabbTree& GetTree() const { return m_tree; }
+    
+private:
+    enum class SweepState : uint8_t {
+        None,
+        Swept,
+        Leaving         // Endpoints still in the list until the next FindPairs
+    };
+    
+    struct Proxy {
+        Aabb bounds;
+        uint64_t userData = 0;
+        uint32_t treeLeaf = DynamicAabbTree::NullNode;
+        uint32_t nextFree = InvalidProxy;
+        SweepState sweep = SweepState::None;
+        bool listedLeaving = false;     // In m_leaving until the next CompactEndpoints
+        bool isStatic = false;
+        bool inUse = false;
+    };
+    
+    // Min endpoint on the sweep axis
+    struct Endpoint {
+        double value;
+        ProxyId proxy;
+        
+        bool operator<(const Endpoint& other) const {
+            return value < other.value || (value == other.value && proxy < other.proxy);
+        }
+    };
+    
+    // Grid cells per axis across the two axes that are not swept
+    static constexpr int MaxGridCells = 64;
+    // Swept boxes per FindPairs job
+    static constexpr size_t ParallelGrainSize = 2048;
+    // Passes over every swept box are cut into at most this many slices
+    static constexpr size_t MaxSlices = 64;
+    
+    // Cell layout of the current sweep
+    struct SweepGrid {
+        double minB = 0.0, minC = 0.0;
+        double scaleB = 0.0, scaleC = 0.0;
+        int cellsB = 1, cellsC = 1;
+        
+        // Written so NaN lands in cell 0 rather than in an undefined conversion
+        static int CellOf(double value, double rangeMin, double scale, int cells) {
+            double cell = (value - rangeMin) * scale;
+            return cell > 0.0 ? static_cast<int>(std::min(cell, static_cast<double>(cells - 1))) : 0;
+        }
+        int CellB(double value) const { return CellOf(value, minB, scaleB, cellsB); }
+        int CellC(double value) const { return CellOf(value, minC, scaleC, cellsC); }
+    };
+    
+    // Partial sums of one slice of a pass over the swept boxes
+    struct SliceTotals {
+        DVector3 sum, sumSquares;       // Centre offsets, for picking the sweep axis
+        double minB, maxB, minC, maxC;  // Range over the grid axes
+        double extentB, extentC;
+    };
+    
+    // Part of FindPairs run as one job: a range of cells or of endpoints
+    struct PairTask {
+        size_t begin;
+        size_t end;
+        bool queriesTree;
+    };
+    
+    // A swept box in endpoint order, copied out so the sweep reads memory in
+    // sequence; a is the sweep axis
+    struct SweepBox {
+        double minA, maxA;
+        double minB, maxB;
+        double minC, maxC;
+        uint64_t userData;
+    };
+    
+    bool BelongsInTree(const Aabb& bounds, bool isStatic) const {
+        return isStatic || bounds.LargestExtent() > m_largeExtent;
+    }
+    
+    void AddToSweep(ProxyId proxy);
+    void RemoveFromSweep(ProxyId proxy);
+    void CompactEndpoints();
+    // Slices depend only on count, so per-slice partial results combine the
+    // same way with any number of workers
+    static size_t GetSliceCount(size_t count);
+    static size_t GetSliceSize(size_t count);
+    // body(slice, begin, end) for each slice of [0, count), as jobs when there are workers
+    static void ForEachSlice(JobSystem* jobSystem, size_t count,
+                             const std::function<void(size_t, size_t, size_t)>& body);
+    void SortEndpoints(JobSystem* jobSystem);
+    void BuildSweepCells(JobSystem* jobSystem);
+    void SweepCells(size_t firstCell, size_t lastCell, std::pmr::vector<BroadphasePair>& pairs) const;
+    // Swept proxies at the given endpoint positions against the tree
+    void QueryTree(size_t firstEndpoint, size_t lastEndpoint, std::pmr::vector<BroadphasePair>& pairs) const;
+    // Large moving proxies against the rest of the tree
+    void QueryLargeProxies(std::pmr::vector<BroadphasePair>& pairs) const;
+    
+    std::pmr::vector<Proxy> m_proxies;
+    ProxyId m_freeProxy = InvalidProxy;
+    size_t m_proxyCount = 0;
+    
+    std::pmr::vector<Endpoint> m_endpoints;
+    std::pmr::vector<ProxyId> m_leaving;            // Proxies whose endpoints are waiting to go
+    std::pmr::vector<ProxyId> m_pendingFree;        // Removed while still in the endpoint list
+    std::pmr::vector<SweepBox> m_sweepBoxes;
+    std::pmr::vector<SweepBox> m_cellBoxes;         // Grouped by grid cell
+    std::pmr::vector<size_t> m_cellStarts;
+    std::pmr::vector<size_t> m_sliceCounts;         // Per slice and cell: box count, then write cursor
+    std::pmr::vector<SliceTotals> m_sliceTotals;
+    size_t m_cellCount = 0;
+    SweepGrid m_grid;
+    std::pmr::vector<PairTask> m_pairTasks;
+    std::pmr::vector<std::pmr::vector<BroadphasePair>> m_taskPairs;     // One list per task, reused
+    size_t m_sweptCount = 0;
+    size_t m_addedSinceSort = 0;
+    int m_sweepAxis = 0;
+    
+    DynamicAabbTree m_tree;
+    double m_largeExtent = DefaultLargeExtent;
+};
+
+}
\ No newline at end of file
@@ -2,31 +2,64 @@
 
 #include "Core/Module.h"
 #include "Core/Math.h"
+#include "Core/SlotMap.h"
+#include "Broadphase.h"
+#include "GravityTree.h"
 #include <vector>
+#include <functional>
 #include <memory>
+#include <optional>
+#include <span>
 #include <unordered_map>
 
 namespace Daisy {
 
-struct RigidBody {
-    Vector3 position{0, 0, 0};
-    Vector3 velocity{0, 0, 0};
-    Vector3 acceleration{0, 0, 0};
-    Vector3 force{0, 0, 0};
-    
+struct RigidBody;
+using RigidBodyHandle = Handle<RigidBody>;
+
+// Per-body state the step touches once, in the rotation pass. Position,
+// velocity, force, mass and flags are in DaisyPhysics' parallel arrays.
+struct RigidBodyProperties {
     Quaternion rotation;
     Vector3 angularVelocity{0, 0, 0};
     Vector3 torque{0, 0, 0};
     
-    float mass = 1.0f;
-    float invMass = 1.0f;
     float restitution = 0.5f;
     float friction = 0.5f;
+    float collisionRadius = 1.0f;   // Sphere shape radius, 1 for every other shape
     
+    RigidBodyHandle id;
+    Broadphase::ProxyId broadphaseProxy = Broadphase::InvalidProxy;
+};
+
+struct RigidBodyFlags {
     bool isStatic = false;
     bool useGravity = true;
+};
+
+// One body as references into the simulation arrays, so callers keep writing
+// body->velocity and the like. Valid until the next CreateRigidBody or
+// DestroyRigidBody.
+struct RigidBody {
+    DVector3& position;             // World space; only offsets between bodies drop to float
+    Vector3& velocity;
+    Vector3& force;
     
-    uint32_t id = 0;
+    Quaternion& rotation;
+    Vector3& angularVelocity;
+    Vector3& torque;
+    
+    float& mass;
+    float& invMass;
+    float& restitution;
+    float& friction;
+    
+    bool& isStatic;
+    bool& useGravity;
+    
+    float& collisionRadius;
+    
+    RigidBodyHandle id;
 };
 
 struct CollisionShape {
@@ -36,12 +69,17 @@ struct CollisionShape {
     CollisionShape(Type t) : type(t) {}
 };
 
-struct GravityWell {
-    Vector3 position{0, 0, 0};
-    float mass = 1.0f;
-    float radius = 100.0f;
-    bool isPlanet = false;
-    bool isStar = false;
+enum class GravitySolver {
+    Exact,          // Every body against every well
+    BarnesHut,      // Distant groups of wells pull as one mass, see GravityTree
+    Automatic       // Barnes-Hut from treeThreshold wells up, exact below
+};
+
+struct GravitySettings {
+    GravitySolver solver = GravitySolver::Automatic;
+    // Barnes-Hut accuracy: smaller opens more groups, 0 is exact
+    float openingAngle = 0.5f;
+    size_t treeThreshold = 512;     // GravityBenchmark has the tree ahead from about 400
 };
 
 class DaisyPhysics : public Module {
@@ -53,42 +91,102 @@ public:
     void Update(float deltaTime) override;
     void Shutdown() override;
     
-    uint32_t CreateRigidBody(const Vector3& position, float mass = 1.0f);
-    void DestroyRigidBody(uint32_t id);
-    RigidBody* GetRigidBody(uint32_t id);
+    RigidBodyHandle CreateRigidBody(const DVector3& position, float mass = 1.0f);
+    void DestroyRigidBody(RigidBodyHandle id);
+    // One body of the given mass per position, with its handle written to the
+    // same index of handles, which must be as long as positions. The arrays
+    // grow once for the whole batch; if anything throws, no body is created.
+    void CreateRigidBodies(std::span<const DVector3> positions, std::span<RigidBodyHandle> handles, float mass = 1.0f);
+    // Stale handles are skipped
+    void DestroyRigidBodies(std::span<const RigidBodyHandle> ids);
+    // Empty for a stale handle
+    std::optional<RigidBody> GetRigidBody(RigidBodyHandle id);
     
-    void SetCollisionShape(uint32_t bodyId, std::unique_ptr<CollisionShape> shape);
+    void SetCollisionShape(RigidBodyHandle bodyId, std::unique_ptr<CollisionShape> shape);
     
-    void AddGravityWell(const Vector3& position, float mass, float radius, bool isPlanet = false);
+    void AddGravityWell(const DVector3& position, float mass, float radius, bool isPlanet = false);
     void SetGlobalGravity(const Vector3& gravity) { m_globalGravity = gravity; }
+    void SetGravitySettings(const GravitySettings& settings) { m_gravitySettings = settings; }
+    const GravitySettings& GetGravitySettings() const { return m_gravitySettings; }
     
-    void ApplyForce(uint32_t bodyId, const Vector3& force);
-    void ApplyImpulse(uint32_t bodyId, const Vector3& impulse);
-    void ApplyTorque(uint32_t bodyId, const Vector3& torque);
+    void ApplyForce(RigidBodyHandle bodyId, const Vector3& force);
+    void ApplyImpulse(RigidBodyHandle bodyId, const Vector3& impulse);
+    void ApplyTorque(RigidBodyHandle bodyId, const Vector3& torque);
     
-    void SetAtmosphere(uint32_t bodyId, float density);
+    void SetAtmosphere(RigidBodyHandle bodyId, float density);
     void EnableFluidDynamics(bool enable) { m_fluidDynamicsEnabled = enable; }
     
     void SetLODDistance(float distance) { m_lodDistance = distance; }
     
 private:
-    void IntegrateRigidBodies(float deltaTime);
-    void ApplyGravity(float deltaTime);
+    // A broadphase pair as dense indices
+    struct Contact {
+        uint32_t bodyA;
+        uint32_t bodyB;
+    };
+    
+    // Bodies per job in the force and integration pass
+    static constexpr size_t BodyGrainSize = 4096;
+    // Contacts per job when solving islands
+    static constexpr size_t ContactGrainSize = 1024;
+    
+    // The engine's job system when it has workers, else null and the step runs on the caller
+    JobSystem* GetParallelJobSystem() const;
+    // body(begin, end) over [0, count), split into jobs of grainSize when worth it
+    void RunParallel(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& body);
+    
+    void ReserveBodies(size_t count);
+    // Room for count more bodies in every array, so the appends in AddBody cannot fail
+    void EnsureCapacity(size_t count);
+    // Drops array entries past count, after a batch that the slot map did not finish
+    void TruncateBodies(size_t count);
+    RigidBodyHandle AddBody(const DVector3& position, float mass);
+    void RemoveBody(RigidBodyHandle id);
+    // Ranges of dense indices; bodies are independent until collision
+    void IntegrateRigidBodies(float deltaTime, size_t begin, size_t end);
+    // Picks the gravity solver for this step and rebuilds the tree if the wells changed
+    void PrepareGravity();
+    void ApplyGravity(size_t begin, size_t end);
+    void ApplyAtmosphericDrag(size_t begin, size_t end);
     void CheckCollisions();
-    void ApplyAtmosphericDrag(RigidBody& body, float deltaTime);
+    // Groups m_contacts into islands that share no moving body, so islands
+    // can be solved at the same time with the same result as in sequence
+    void BuildIslands();
+    void SolveContacts(std::span<const Contact> contacts);
     void UpdateLOD();
     
-    std::vector<std::unique_ptr<RigidBody>> m_rigidBodies;
-    std::unordered_map<uint32_t, std::unique_ptr<CollisionShape>> m_collisionShapes;
-    std::vector<GravityWell> m_gravityWells;
+    // Allocated through the module's memory resource. The arrays below run
+    // parallel to the slot map's dense order, one entry per body, so each
+    // pass streams only the fields it uses.
+    SlotMap<RigidBodyProperties, RigidBody> m_rigidBodies;
+    std::pmr::vector<DVector3> m_positions;
+    std::pmr::vector<Vector3> m_velocities;
+    std::pmr::vector<Vector3> m_forces;
+    std::pmr::vector<float> m_masses;
+    std::pmr::vector<float> m_inverseMasses;
+    std::pmr::vector<float> m_dragDensities;    // Atmospheric density, 0 outside any atmosphere
+    std::pmr::vector<RigidBodyFlags> m_flags;
+    std::pmr::unordered_map<RigidBodyHandle, std::unique_ptr<CollisionShape>> m_collisionShapes;
+    std::pmr::vector<GravityWell> m_gravityWells;
+    GravityTree m_gravityTree;
+    bool m_gravityTreeDirty = true;
+    bool m_useGravityTree = false;      // Chosen per step by PrepareGravity
+    Broadphase m_broadphase;
+    std::pmr::vector<BroadphasePair> m_candidatePairs;     // Reused every step
+    std::pmr::vector<Contact> m_contacts;
+    // Island building scratch, reused every step
+    std::pmr::vector<uint32_t> m_islandParents;             // Union-find over dense indices
+    std::pmr::vector<uint32_t> m_islandIds;                 // Island of each root body
+    std::pmr::vector<uint32_t> m_contactIslands;
+    std::pmr::vector<size_t> m_islandStarts;
+    std::pmr::vector<Contact> m_islandContacts;             // m_contacts grouped by island
+    std::pmr::vector<size_t> m_solverChunks;                // Chunk boundaries in m_islandContacts
     
     Vector3 m_globalGravity{0, -9.81f, 0};
-    uint32_t m_nextBodyId = 1;
+    GravitySettings m_gravitySettings;
     
     float m_lodDistance = 1000.0f;
     bool m_fluidDynamicsEnabled = false;
-    
-    std::unordered_map<uint32_t, float> m_atmosphericDensity;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Broadphase.h"
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+namespace Daisy {
+
+constexpr double GravitationalConstant = 6.674e-11;
+
+struct GravityWell {
+    DVector3 position{0, 0, 0};
+    float mass = 1.0f;
+    float radius = 100.0f;
+    bool isPlanet = false;
+    bool isStar = false;
+};
+
+// Pull of one well on a body, zero outside the well's radius. Inside a tenth
+// of a planet's radius the pull falls off linearly instead of growing.
+inline Vector3 ComputeWellForce(const GravityWell& well, const DVector3& position, float mass) {
+    // Wells are far away, so the offset is taken in double before it becomes a direction
+    DVector3 offset = well.position - position;
+    double distanceSquared = offset.LengthSquared();
+    double radius = well.radius;
+    if (!(distanceSquared > 0.0 && distanceSquared < radius * radius)) {
+        return Vector3(0, 0, 0);
+    }
+    
+    double distance = std::sqrt(distanceSquared);
+    double gravitationalForce = GravitationalConstant * well.mass * mass / distanceSquared;
+    if (well.isPlanet && distance < radius * 0.1) {
+        gravitationalForce *= distance / (radius * 0.1);
+    }
+    return (offset / distance).ToVector3() * static_cast<float>(gravitationalForce);
+}
+
+// Barnes-Hut octrees over gravity wells. A group of wells that looks small
+// from the body, with every well in range and no planet core nearby, pulls
+// as one mass at its centre of mass; groups out of every well's range are
+// skipped. Build once the wells change; queries are safe from several
+// threads at once.
+class GravityTree {
+public:
+    explicit GravityTree(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    
+    void Build(std::span<const GravityWell> wells);
+    void Clear();
+    
+    // openingAngle is the largest size-over-distance ratio, roughly radians,
+    // at which a group still counts as one mass; 0 gives the exact sum
+    Vector3 ComputeForce(const DVector3& position, float mass, float openingAngle) const;
+    
+    bool Empty() const { return m_nodes.empty(); }
+    size_t GetNodeCount() const { return m_nodes.size(); }
+    
+private:
+    static constexpr uint32_t NullNode = std::numeric_limits<uint32_t>::max();
+    static constexpr size_t LeafSize = 8;
+    // Coincident wells stop splitting here; also bounds the query stack
+    static constexpr int MaxDepth = 32;
+    
+    struct Node {
+        Aabb bounds;                    // Tight around the wells below
+        DVector3 centerOfMass;
+        double mass = 0.0;
+        double minRadius = 0.0;         // Smallest well radius below
+        double maxRadius = 0.0;         // Largest well radius below
+        double coreRadius = 0.0;        // Largest planet softening radius below
+        uint32_t firstChild = NullNode; // Children are contiguous
+        uint32_t childCount = 0;
+        uint32_t firstWell = 0;         // Wells below are contiguous in m_wells
+        uint32_t wellCount = 0;
+    };
+    
+    void BuildNode(uint32_t nodeIndex, size_t first, size_t last, int depth);
+    void AccumulateForce(uint32_t root, const DVector3& position, float mass, double openingAngleSquared,
+                         Vector3& force) const;
+    
+    std::pmr::vector<Node> m_nodes;
+    std::pmr::vector<uint32_t> m_roots;         // One tree per band of well radii
+    std::pmr::vector<GravityWell> m_wells;     // Copy in tree order
+};
+
+}
\ No newline at end of file
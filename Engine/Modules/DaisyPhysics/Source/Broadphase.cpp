@@ -0,0 +1,720 @@
+#include "Broadphase.h"
+#include "Core/JobSystem.h"
+#include <cmath>
+
+namespace Daisy {
+
+namespace {
+    double AxisValue(const DVector3& v, int axis) {
+        return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+    }
+    
+    // Grows geometrically, so reserving ahead of every insert stays amortized O(1)
+    template<typename Vector>
+    void ReserveAtLeast(Vector& vector, size_t count) {
+        if (vector.capacity() < count) {
+            vector.reserve(std::max(count, vector.capacity() * 2));
+        }
+    }
+}
+
+DynamicAabbTree::DynamicAabbTree(std::pmr::memory_resource* resource)
+    : m_nodes(resource) {
+}
+
+void DynamicAabbTree::ReserveInsert() {
+    // A leaf and the parent that joins it to its sibling
+    ReserveAtLeast(m_nodes, m_nodes.size() + 2);
+}
+
+uint32_t DynamicAabbTree::Insert(const Aabb& bounds, uint32_t proxy, double margin) {
+    uint32_t leaf = AllocateNode();
+    Node& node = m_nodes[leaf];
+    node.bounds = bounds.Expanded(margin);
+    node.proxy = proxy;
+    node.height = 0;
+    InsertLeaf(leaf);
+    return leaf;
+}
+
+void DynamicAabbTree::Remove(uint32_t leaf) {
+    RemoveLeaf(leaf);
+    FreeNode(leaf);
+}
+
+bool DynamicAabbTree::Move(uint32_t leaf, const Aabb& bounds, double margin) {
+    if (m_nodes[leaf].bounds.Contains(bounds)) {
+        return false;
+    }
+    
+    RemoveLeaf(leaf);
+    m_nodes[leaf].bounds = bounds.Expanded(margin);
+    InsertLeaf(leaf);
+    return true;
+}
+
+void DynamicAabbTree::Clear() {
+    m_nodes.clear();
+    m_root = NullNode;
+    m_freeList = NullNode;
+}
+
+uint32_t DynamicAabbTree::AllocateNode() {
+    if (m_freeList == NullNode) {
+        m_nodes.emplace_back();
+        return static_cast<uint32_t>(m_nodes.size() - 1);
+    }
+    
+    uint32_t index = m_freeList;
+    m_freeList = m_nodes[index].parent;
+    m_nodes[index] = Node{};
+    return index;
+}
+
+void DynamicAabbTree::FreeNode(uint32_t node) {
+    m_nodes[node].parent = m_freeList;
+    m_nodes[node].height = -1;
+    m_freeList = node;
+}
+
+void DynamicAabbTree::InsertLeaf(uint32_t leaf) {
+    if (m_root == NullNode) {
+        m_root = leaf;
+        m_nodes[leaf].parent = NullNode;
+        return;
+    }
+    
+    // Descend towards the sibling that grows the total surface area least; a
+    // new parent costs its own area plus what every ancestor has to grow by
+    const Aabb leafBounds = m_nodes[leaf].bounds;
+    uint32_t index = m_root;
+    while (!m_nodes[index].IsLeaf()) {
+        const Node& node = m_nodes[index];
+        double area = node.bounds.SurfaceArea();
+        double combinedArea = node.bounds.Union(leafBounds).SurfaceArea();
+        double cost = 2.0 * combinedArea;
+        double inheritanceCost = 2.0 * (combinedArea - area);
+        
+        auto descendCost = [&](uint32_t child) {
+            const Node& childNode = m_nodes[child];
+            double grown = childNode.bounds.Union(leafBounds).SurfaceArea();
+            return (childNode.IsLeaf() ? grown : grown - childNode.bounds.SurfaceArea()) + inheritanceCost;
+        };
+        double cost1 = descendCost(node.child1);
+        double cost2 = descendCost(node.child2);
+        
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+    
+    uint32_t sibling = index;
+    uint32_t oldParent = m_nodes[sibling].parent;
+    uint32_t newParent = AllocateNode();
+    m_nodes[newParent].parent = oldParent;
+    m_nodes[newParent].bounds = leafBounds.Union(m_nodes[sibling].bounds);
+    m_nodes[newParent].height = m_nodes[sibling].height + 1;
+    m_nodes[newParent].child1 = sibling;
+    m_nodes[newParent].child2 = leaf;
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent = newParent;
+    
+    if (oldParent == NullNode) {
+        m_root = newParent;
+    } else if (m_nodes[oldParent].child1 == sibling) {
+        m_nodes[oldParent].child1 = newParent;
+    } else {
+        m_nodes[oldParent].child2 = newParent;
+    }
+    
+    for (index = m_nodes[leaf].parent; index != NullNode; index = m_nodes[index].parent) {
+        index = Balance(index);
+        Refit(index);
+    }
+}
+
+void DynamicAabbTree::RemoveLeaf(uint32_t leaf) {
+    if (leaf == m_root) {
+        m_root = NullNode;
+        return;
+    }
+    
+    uint32_t parent = m_nodes[leaf].parent;
+    uint32_t grandParent = m_nodes[parent].parent;
+    uint32_t sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+    
+    FreeNode(parent);
+    m_nodes[sibling].parent = grandParent;
+    if (grandParent == NullNode) {
+        m_root = sibling;
+        return;
+    }
+    
+    if (m_nodes[grandParent].child1 == parent) {
+        m_nodes[grandParent].child1 = sibling;
+    } else {
+        m_nodes[grandParent].child2 = sibling;
+    }
+    for (uint32_t index = grandParent; index != NullNode; index = m_nodes[index].parent) {
+        index = Balance(index);
+        Refit(index);
+    }
+}
+
+void DynamicAabbTree::Refit(uint32_t node) {
+    Node& parent = m_nodes[node];
+    const Node& child1 = m_nodes[parent.child1];
+    const Node& child2 = m_nodes[parent.child2];
+    parent.bounds = child1.bounds.Union(child2.bounds);
+    parent.height = 1 + std::max(child1.height, child2.height);
+}
+
+// One AVL rotation at a, lifting whichever child is more than one level
+// taller; returns the node now in a's place
+uint32_t DynamicAabbTree::Balance(uint32_t a) {
+    Node& nodeA = m_nodes[a];
+    if (nodeA.IsLeaf() || nodeA.height < 2) {
+        return a;
+    }
+    
+    uint32_t b = nodeA.child1;
+    uint32_t c = nodeA.child2;
+    int32_t balance = m_nodes[c].height - m_nodes[b].height;
+    if (balance >= -1 && balance <= 1) {
+        return a;
+    }
+    
+    // Lift the taller child into a's place, a becomes its first child and
+    // keeps the lifted node's taller grandchild's sibling
+    bool liftC = balance > 1;
+    uint32_t lifted = liftC ? c : b;
+    uint32_t kept = liftC ? b : c;
+    Node& nodeLifted = m_nodes[lifted];
+    uint32_t f = nodeLifted.child1;
+    uint32_t g = nodeLifted.child2;
+    
+    nodeLifted.child1 = a;
+    nodeLifted.parent = nodeA.parent;
+    nodeA.parent = lifted;
+    if (nodeLifted.parent == NullNode) {
+        m_root = lifted;
+    } else if (m_nodes[nodeLifted.parent].child1 == a) {
+        m_nodes[nodeLifted.parent].child1 = lifted;
+    } else {
+        m_nodes[nodeLifted.parent].child2 = lifted;
+    }
+    
+    // The taller grandchild stays under the lifted node, the shorter moves to a
+    uint32_t stays = m_nodes[f].height > m_nodes[g].height ? f : g;
+    uint32_t moves = stays == f ? g : f;
+    nodeLifted.child2 = stays;
+    if (liftC) {
+        nodeA.child2 = moves;
+    } else {
+        nodeA.child1 = moves;
+    }
+    m_nodes[moves].parent = a;
+    
+    nodeA.bounds = m_nodes[kept].bounds.Union(m_nodes[moves].bounds);
+    nodeA.height = 1 + std::max(m_nodes[kept].height, m_nodes[moves].height);
+    nodeLifted.bounds = nodeA.bounds.Union(m_nodes[stays].bounds);
+    nodeLifted.height = 1 + std::max(nodeA.height, m_nodes[stays].height);
+    return lifted;
+}
+
+Broadphase::Broadphase(std::pmr::memory_resource* resource)
+    : m_proxies(resource)
+    , m_endpoints(resource)
+    , m_leaving(resource)
+    , m_pendingFree(resource)
+    , m_sweepBoxes(resource)
+    , m_cellBoxes(resource)
+    , m_cellStarts(resource)
+    , m_sliceCounts(resource)
+    , m_sliceTotals(resource)
+    , m_pairTasks(resource)
+    , m_taskPairs(resource)
+    , m_tree(resource) {
+}
+
+Broadphase::ProxyId Broadphase::AddProxy(const Aabb& bounds, uint64_t userData, bool isStatic) {
+    // Everything that can throw happens before any state changes. The leaving
+    // and pending-free lists hold each proxy at most once, so with room for
+    // every proxy RemoveProxy never allocates.
+    const size_t proxyCapacity = m_proxies.size() + (m_freeProxy == InvalidProxy ? 1 : 0);
+    ReserveAtLeast(m_proxies, proxyCapacity);
+    ReserveAtLeast(m_leaving, proxyCapacity);
+    ReserveAtLeast(m_pendingFree, proxyCapacity);
+    if (BelongsInTree(bounds, isStatic)) {
+        m_tree.ReserveInsert();
+    } else {
+        ReserveAtLeast(m_endpoints, m_endpoints.size() + 1);
+    }
+    
+    ProxyId id;
+    if (m_freeProxy != InvalidProxy) {
+        id = m_freeProxy;
+        m_freeProxy = m_proxies[id].nextFree;
+        m_proxies[id] = Proxy{};
+    } else {
+        id = static_cast<ProxyId>(m_proxies.size());
+        m_proxies.emplace_back();
+    }
+    
+    Proxy& proxy = m_proxies[id];
+    proxy.bounds = bounds;
+    proxy.userData = userData;
+    proxy.isStatic = isStatic;
+    proxy.inUse = true;
+    ++m_proxyCount;
+    
+    if (BelongsInTree(bounds, isStatic)) {
+        proxy.treeLeaf = m_tree.Insert(bounds, id, TreeMargin);
+    } else {
+        AddToSweep(id);
+    }
+    return id;
+}
+
+void Broadphase::RemoveProxy(ProxyId id) {
+    if (id >= m_proxies.size() || !m_proxies[id].inUse) {
+        return;
+    }
+    
+    Proxy& proxy = m_proxies[id];
+    proxy.inUse = false;
+    --m_proxyCount;
+    if (proxy.treeLeaf != DynamicAabbTree::NullNode) {
+        m_tree.Remove(proxy.treeLeaf);
+        proxy.treeLeaf = DynamicAabbTree::NullNode;
+    }
+    
+    // The ID cannot be reused while its endpoints are still in the list
+    if (proxy.sweep != SweepState::None) {
+        RemoveFromSweep(id);
+        m_pendingFree.push_back(id);
+        return;
+    }
+    proxy.nextFree = m_freeProxy;
+    m_freeProxy = id;
+}
+
+void Broadphase::UpdateProxy(ProxyId id, const Aabb& bounds, bool isStatic) {
+    if (id >= m_proxies.size() || !m_proxies[id].inUse) {
+        return;
+    }
+    
+    Proxy& proxy = m_proxies[id];
+    proxy.bounds = bounds;
+    proxy.isStatic = isStatic;
+    
+    // Swept endpoints pick up the new bounds in FindPairs
+    bool inTree = proxy.treeLeaf != DynamicAabbTree::NullNode;
+    if (BelongsInTree(bounds, isStatic)) {
+        if (inTree) {
+            m_tree.Move(proxy.treeLeaf, bounds, TreeMargin);
+        } else {
+            RemoveFromSweep(id);
+            proxy.treeLeaf = m_tree.Insert(bounds, id, TreeMargin);
+        }
+    } else if (inTree) {
+        m_tree.Remove(proxy.treeLeaf);
+        proxy.treeLeaf = DynamicAabbTree::NullNode;
+        AddToSweep(id);
+    }
+}
+
+void Broadphase::Clear() {
+    m_proxies.clear();
+    m_freeProxy = InvalidProxy;
+    m_proxyCount = 0;
+    m_endpoints.clear();
+    m_leaving.clear();
+    m_pendingFree.clear();
+    m_sweepBoxes.clear();
+    m_sweptCount = 0;
+    m_addedSinceSort = 0;
+    m_tree.Clear();
+}
+
+void Broadphase::AddToSweep(ProxyId id) {
+    Proxy& proxy = m_proxies[id];
+    if (proxy.sweep == SweepState::Swept) {
+        return;
+    }
+    
+    // A proxy that left since the last FindPairs still has its endpoints
+    if (proxy.sweep == SweepState::None) {
+        m_endpoints.push_back(Endpoint{AxisValue(proxy.bounds.min, m_sweepAxis), id});
+        ++m_addedSinceSort;
+    }
+    proxy.sweep = SweepState::Swept;
+    ++m_sweptCount;
+}
+
+void Broadphase::RemoveFromSweep(ProxyId id) {
+    Proxy& proxy = m_proxies[id];
+    if (proxy.sweep != SweepState::Swept) {
+        return;
+    }
+    
+    proxy.sweep = SweepState::Leaving;
+    // A proxy that came back and left again before CompactEndpoints is already listed
+    if (!proxy.listedLeaving) {
+        proxy.listedLeaving = true;
+        m_leaving.push_back(id);
+    }
+    --m_sweptCount;
+}
+
+void Broadphase::CompactEndpoints() {
+    if (m_leaving.empty()) {
+        return;
+    }
+    
+    std::erase_if(m_endpoints, [this](const Endpoint& endpoint) {
+        return m_proxies[endpoint.proxy].sweep == SweepState::Leaving;
+    });
+    for (ProxyId id : m_leaving) {
+        m_proxies[id].listedLeaving = false;
+        if (m_proxies[id].sweep == SweepState::Leaving) {
+            m_proxies[id].sweep = SweepState::None;
+        }
+    }
+    m_leaving.clear();
+    
+    for (ProxyId id : m_pendingFree) {
+        m_proxies[id].nextFree = m_freeProxy;
+        m_freeProxy = id;
+    }
+    m_pendingFree.clear();
+}
+
+size_t Broadphase::GetSliceCount(size_t count) {
+    return (count + GetSliceSize(count) - 1) / GetSliceSize(count);
+}
+
+size_t Broadphase::GetSliceSize(size_t count) {
+    return std::max(ParallelGrainSize, (count + MaxSlices - 1) / MaxSlices);
+}
+
+void Broadphase::ForEachSlice(JobSystem* jobSystem, size_t count,
+                              const std::function<void(size_t, size_t, size_t)>& body) {
+    const size_t sliceSize = GetSliceSize(count);
+    const size_t sliceCount = GetSliceCount(count);
+    auto runSlices = [&](size_t first, size_t last) {
+        for (size_t slice = first; slice < last; ++slice) {
+            body(slice, slice * sliceSize, std::min(count, (slice + 1) * sliceSize));
+        }
+    };
+    
+    if (!jobSystem || jobSystem->GetWorkerCount() == 0 || sliceCount < 2) {
+        runSlices(0, sliceCount);
+        return;
+    }
+    jobSystem->Wait(jobSystem->ParallelFor(0, sliceCount, 1, runSlices));
+}
+
+void Broadphase::SortEndpoints(JobSystem* jobSystem) {
+    if (m_endpoints.empty()) {
+        return;
+    }
+    
+    // Sweep along the axis the centres spread over most. Offsets from the
+    // first centre keep the variance precise far from the world origin.
+    const Aabb& first = m_proxies[m_endpoints[0].proxy].bounds;
+    const DVector3 reference = (first.min + first.max) * 0.5;
+    m_sliceTotals.resize(GetSliceCount(m_endpoints.size()));
+    ForEachSlice(jobSystem, m_endpoints.size(), [&](size_t slice, size_t begin, size_t end) {
+        SliceTotals& totals = m_sliceTotals[slice];
+        totals.sum = totals.sumSquares = DVector3();
+        for (size_t i = begin; i < end; ++i) {
+            const Aabb& bounds = m_proxies[m_endpoints[i].proxy].bounds;
+            DVector3 offset = (bounds.min + bounds.max) * 0.5 - reference;
+            totals.sum = totals.sum + offset;
+            totals.sumSquares = totals.sumSquares + DVector3(offset.x * offset.x, offset.y * offset.y, offset.z * offset.z);
+        }
+    });
+    DVector3 sum, sumSquares;
+    for (const SliceTotals& totals : m_sliceTotals) {
+        sum = sum + totals.sum;
+        sumSquares = sumSquares + totals.sumSquares;
+    }
+    double count = static_cast<double>(m_sweptCount);
+    DVector3 mean = sum / count;
+    double variance[3] = {
+        sumSquares.x / count - mean.x * mean.x,
+        sumSquares.y / count - mean.y * mean.y,
+        sumSquares.z / count - mean.z * mean.z
+    };
+    int bestAxis = static_cast<int>(std::max_element(variance, variance + 3) - variance);
+    // Only switch for a clear win, since switching costs a full sort
+    bool axisChanged = variance[bestAxis] > 2.0 * variance[m_sweepAxis];
+    if (axisChanged) {
+        m_sweepAxis = bestAxis;
+    }
+    
+    ForEachSlice(jobSystem, m_endpoints.size(), [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            double value = AxisValue(m_proxies[m_endpoints[i].proxy].bounds.min, m_sweepAxis);
+            // A NaN would break the ordering the sort relies on
+            m_endpoints[i].value = std::isnan(value) ? 0.0 : value;
+        }
+    });
+    
+    if (axisChanged || m_addedSinceSort > m_endpoints.size() / 8) {
+        std::sort(m_endpoints.begin(), m_endpoints.end());
+    } else {
+        // Bodies move little between steps, so the list is nearly sorted
+        // and insertion sort is close to linear
+        for (size_t i = 1; i < m_endpoints.size(); ++i) {
+            Endpoint endpoint = m_endpoints[i];
+            size_t j = i;
+            for (; j > 0 && endpoint < m_endpoints[j - 1]; --j) {
+                m_endpoints[j] = m_endpoints[j - 1];
+            }
+            m_endpoints[j] = endpoint;
+        }
+    }
+    m_addedSinceSort = 0;
+}
+
+void Broadphase::BuildSweepCells(JobSystem* jobSystem) {
+    m_cellCount = 0;
+    if (m_endpoints.empty()) {
+        return;
+    }
+    
+    // Box copies and their range on the two grid axes, gathered per slice and
+    // combined in slice order
+    const size_t boxCount = m_endpoints.size();
+    const size_t sliceCount = GetSliceCount(boxCount);
+    const int axisB = (m_sweepAxis + 1) % 3;
+    const int axisC = (m_sweepAxis + 2) % 3;
+    m_sweepBoxes.resize(boxCount);
+    m_sliceTotals.resize(sliceCount);
+    ForEachSlice(jobSystem, boxCount, [&](size_t slice, size_t begin, size_t end) {
+        SliceTotals& totals = m_sliceTotals[slice];
+        totals.minB = totals.minC = std::numeric_limits<double>::max();
+        totals.maxB = totals.maxC = std::numeric_limits<double>::lowest();
+        totals.extentB = totals.extentC = 0.0;
+        for (size_t i = begin; i < end; ++i) {
+            const Proxy& proxy = m_proxies[m_endpoints[i].proxy];
+            SweepBox& box = m_sweepBoxes[i];
+            box = SweepBox{
+                AxisValue(proxy.bounds.min, m_sweepAxis), AxisValue(proxy.bounds.max, m_sweepAxis),
+                AxisValue(proxy.bounds.min, axisB), AxisValue(proxy.bounds.max, axisB),
+                AxisValue(proxy.bounds.min, axisC), AxisValue(proxy.bounds.max, axisC),
+                proxy.userData
+            };
+            totals.minB = std::min(totals.minB, box.minB);
+            totals.maxB = std::max(totals.maxB, box.maxB);
+            totals.minC = std::min(totals.minC, box.minC);
+            totals.maxC = std::max(totals.maxC, box.maxC);
+            totals.extentB += box.maxB - box.minB;
+            totals.extentC += box.maxC - box.minC;
+        }
+    });
+    double rangeMinB = std::numeric_limits<double>::max(), rangeMaxB = std::numeric_limits<double>::lowest();
+    double rangeMinC = rangeMinB, rangeMaxC = rangeMaxB;
+    double extentB = 0.0, extentC = 0.0;
+    for (const SliceTotals& totals : m_sliceTotals) {
+        rangeMinB = std::min(rangeMinB, totals.minB);
+        rangeMaxB = std::max(rangeMaxB, totals.maxB);
+        rangeMinC = std::min(rangeMinC, totals.minC);
+        rangeMaxC = std::max(rangeMaxC, totals.maxC);
+        extentB += totals.extentB;
+        extentC += totals.extentC;
+    }
+    
+    // Sweeping one axis alone tests every box against a slab through the whole
+    // world, which grows faster than linearly once bodies fill a volume. A
+    // coarse grid over the other two axes cuts the slab into columns: cells a
+    // few boxes wide keep copies low, and there are never more cells than boxes.
+    double count = static_cast<double>(boxCount);
+    int maxCells = std::clamp(static_cast<int>(std::sqrt(count)), 1, MaxGridCells);
+    auto cellsAlong = [&](double rangeMin, double rangeMax, double extentSum) {
+        double cellSize = 4.0 * extentSum / count;
+        double cells = cellSize > 0.0 ? (rangeMax - rangeMin) / cellSize : 1.0;
+        return cells >= 1.0 ? static_cast<int>(std::min(cells, static_cast<double>(maxCells))) : 1;
+    };
+    SweepGrid& grid = m_grid;
+    grid.minB = rangeMinB;
+    grid.minC = rangeMinC;
+    grid.cellsB = cellsAlong(rangeMinB, rangeMaxB, extentB);
+    grid.cellsC = cellsAlong(rangeMinC, rangeMaxC, extentC);
+    grid.scaleB = grid.cellsB / std::max(rangeMaxB - rangeMinB, 1e-300);
+    grid.scaleC = grid.cellsC / std::max(rangeMaxC - rangeMinC, 1e-300);
+    
+    // Counting sort into cells, with a count per slice and cell so the slices
+    // can scatter at the same time. Boxes are visited in endpoint order, so
+    // every cell comes out sorted on the sweep axis too.
+    m_cellCount = static_cast<size_t>(grid.cellsB) * static_cast<size_t>(grid.cellsC);
+    m_sliceCounts.resize(sliceCount * m_cellCount);
+    auto forEachCell = [&](const SweepBox& box, auto&& visit) {
+        int b0 = grid.CellB(box.minB), b1 = grid.CellB(box.maxB);
+        int c0 = grid.CellC(box.minC), c1 = grid.CellC(box.maxC);
+        for (int b = b0; b <= b1; ++b) {
+            for (int c = c0; c <= c1; ++c) {
+                visit(static_cast<size_t>(b) * grid.cellsC + c);
+            }
+        }
+    };
+    ForEachSlice(jobSystem, boxCount, [&](size_t slice, size_t begin, size_t end) {
+        size_t* counts = m_sliceCounts.data() + slice * m_cellCount;
+        std::fill(counts, counts + m_cellCount, 0);
+        for (size_t i = begin; i < end; ++i) {
+            forEachCell(m_sweepBoxes[i], [&](size_t cell) { ++counts[cell]; });
+        }
+    });
+    
+    // Each count becomes where its slice starts writing in its cell
+    m_cellStarts.resize(m_cellCount + 1);
+    size_t offset = 0;
+    for (size_t cell = 0; cell < m_cellCount; ++cell) {
+        m_cellStarts[cell] = offset;
+        for (size_t slice = 0; slice < sliceCount; ++slice) {
+            size_t& cursor = m_sliceCounts[slice * m_cellCount + cell];
+            size_t sliceCellCount = cursor;
+            cursor = offset;
+            offset += sliceCellCount;
+        }
+    }
+    m_cellStarts[m_cellCount] = offset;
+    
+    m_cellBoxes.resize(offset);
+    ForEachSlice(jobSystem, boxCount, [&](size_t slice, size_t begin, size_t end) {
+        size_t* cursors = m_sliceCounts.data() + slice * m_cellCount;
+        for (size_t i = begin; i < end; ++i) {
+            const SweepBox& box = m_sweepBoxes[i];
+            forEachCell(box, [&](size_t cell) { m_cellBoxes[cursors[cell]++] = box; });
+        }
+    });
+}
+
+void Broadphase::SweepCells(size_t firstCell, size_t lastCell, std::pmr::vector<BroadphasePair>& pairs) const {
+    // Within a cell, the boxes that can overlap box i on the sweep axis are
+    // exactly those after it whose min is within its max. A pair that shares
+    // several cells is reported only from the cell holding the corner of its
+    // overlap.
+    const SweepGrid& grid = m_grid;
+    for (size_t cell = firstCell; cell < lastCell; ++cell) {
+        const int cellB = static_cast<int>(cell / grid.cellsC);
+        const int cellC = static_cast<int>(cell % grid.cellsC);
+        const size_t end = m_cellStarts[cell + 1];
+        for (size_t i = m_cellStarts[cell]; i < end; ++i) {
+            const SweepBox& box = m_cellBoxes[i];
+            for (size_t j = i + 1; j < end && m_cellBoxes[j].minA <= box.maxA; ++j) {
+                const SweepBox& other = m_cellBoxes[j];
+                if (other.minB > box.maxB || box.minB > other.maxB || other.minC > box.maxC || box.minC > other.maxC) {
+                    continue;
+                }
+                if (grid.CellB(std::max(box.minB, other.minB)) == cellB &&
+                    grid.CellC(std::max(box.minC, other.minC)) == cellC) {
+                    pairs.push_back(BroadphasePair{box.userData, other.userData});
+                }
+            }
+        }
+    }
+}
+
+void Broadphase::QueryTree(size_t firstEndpoint, size_t lastEndpoint, std::pmr::vector<BroadphasePair>& pairs) const {
+    if (m_tree.Empty()) {
+        return;
+    }
+    
+    // The tree holds fat boxes, so candidates are checked against the tight ones
+    for (size_t i = firstEndpoint; i < lastEndpoint; ++i) {
+        const Proxy& proxy = m_proxies[m_endpoints[i].proxy];
+        m_tree.Query(proxy.bounds, [&](uint32_t other) {
+            const Proxy& otherProxy = m_proxies[other];
+            if (otherProxy.bounds.Overlaps(proxy.bounds)) {
+                pairs.push_back(BroadphasePair{proxy.userData, otherProxy.userData});
+            }
+        });
+    }
+}
+
+void Broadphase::QueryLargeProxies(std::pmr::vector<BroadphasePair>& pairs) const {
+    if (m_tree.Empty()) {
+        return;
+    }
+    
+    // Two large moving proxies pair up from the lower ID only; static proxies never query
+    for (ProxyId id = 0; id < m_proxies.size(); ++id) {
+        const Proxy& proxy = m_proxies[id];
+        if (!proxy.inUse || proxy.isStatic || proxy.treeLeaf == DynamicAabbTree::NullNode) {
+            continue;
+        }
+        m_tree.Query(proxy.bounds, [&](uint32_t other) {
+            const Proxy& otherProxy = m_proxies[other];
+            if (other == id || (!otherProxy.isStatic && other < id)) {
+                return;
+            }
+            if (otherProxy.bounds.Overlaps(proxy.bounds)) {
+                pairs.push_back(BroadphasePair{proxy.userData, otherProxy.userData});
+            }
+        });
+    }
+}
+
+void Broadphase::FindPairs(std::pmr::vector<BroadphasePair>& pairs, JobSystem* jobSystem) {
+    pairs.clear();
+    CompactEndpoints();
+    SortEndpoints(jobSystem);
+    BuildSweepCells(jobSystem);
+    
+    if (!jobSystem || jobSystem->GetWorkerCount() == 0 || m_endpoints.size() < 2 * ParallelGrainSize) {
+        SweepCells(0, m_cellCount, pairs);
+        QueryTree(0, m_endpoints.size(), pairs);
+        QueryLargeProxies(pairs);
+        return;
+    }
+    
+    // Cell ranges holding about ParallelGrainSize boxes each, then endpoint
+    // ranges of that size for the tree queries. Every task fills its own list
+    // and the lists are joined in task order, so the pairs come out exactly as
+    // the serial path reports them, whatever the worker count.
+    m_pairTasks.clear();
+    for (size_t cell = 0; cell < m_cellCount;) {
+        size_t first = cell;
+        while (cell < m_cellCount && m_cellStarts[cell] - m_cellStarts[first] < ParallelGrainSize) {
+            ++cell;
+        }
+        m_pairTasks.push_back(PairTask{first, cell, false});
+    }
+    if (!m_tree.Empty()) {
+        for (size_t first = 0; first < m_endpoints.size(); first += ParallelGrainSize) {
+            m_pairTasks.push_back(PairTask{first, std::min(m_endpoints.size(), first + ParallelGrainSize), true});
+        }
+    }
+    
+    if (m_taskPairs.size() < m_pairTasks.size()) {
+        m_taskPairs.resize(m_pairTasks.size());
+    }
+    jobSystem->Wait(jobSystem->ParallelFor(0, m_pairTasks.size(), 1, [this](size_t begin, size_t end) {
+        for (size_t task = begin; task < end; ++task) {
+            const PairTask& range = m_pairTasks[task];
+            std::pmr::vector<BroadphasePair>& taskPairs = m_taskPairs[task];
+            taskPairs.clear();
+            if (range.queriesTree) {
+                QueryTree(range.begin, range.end, taskPairs);
+            } else {
+                SweepCells(range.begin, range.end, taskPairs);
+            }
+        }
+    }));
+    
+    size_t total = 0;
+    for (size_t task = 0; task < m_pairTasks.size(); ++task) {
+        total += m_taskPairs[task].size();
+    }
+    pairs.reserve(total);
+    for (size_t task = 0; task < m_pairTasks.size(); ++task) {
+        pairs.insert(pairs.end(), m_taskPairs[task].begin(), m_taskPairs[task].end());
+    }
+    QueryLargeProxies(pairs);
+}
+
+}
\ No newline at end of file
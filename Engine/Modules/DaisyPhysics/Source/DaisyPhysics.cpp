@@ -1,29 +1,63 @@
 #include "DaisyPhysics.h"
 #include "Core/Logger.h"
+#include "Core/FastMath.h"
+#include "Core/JobSystem.h"
 #include <algorithm>
 #include <chrono>
+#include <limits>
+#include <numeric>
 
 namespace Daisy {
 
-DaisyPhysics::DaisyPhysics() : Module("DaisyPhysics") {
+DaisyPhysics::DaisyPhysics()
+    : Module("DaisyPhysics")
+    , m_rigidBodies(&GetMemoryResource())
+    , m_positions(&GetMemoryResource())
+    , m_velocities(&GetMemoryResource())
+    , m_forces(&GetMemoryResource())
+    , m_masses(&GetMemoryResource())
+    , m_inverseMasses(&GetMemoryResource())
+    , m_dragDensities(&GetMemoryResource())
+    , m_flags(&GetMemoryResource())
+    , m_collisionShapes(&GetMemoryResource())
+    , m_gravityWells(&GetMemoryResource())
+    , m_gravityTree(&GetMemoryResource())
+    , m_broadphase(&GetMemoryResource())
+    , m_candidatePairs(&GetMemoryResource())
+    , m_contacts(&GetMemoryResource())
+    , m_islandParents(&GetMemoryResource())
+    , m_islandIds(&GetMemoryResource())
+    , m_contactIslands(&GetMemoryResource())
+    , m_islandStarts(&GetMemoryResource())
+    , m_islandContacts(&GetMemoryResource())
+    , m_solverChunks(&GetMemoryResource()) {
+    SetThreading(ModuleThreading::Worker);
+    SetTick(ModuleTick::Fixed);
+    // The body arrays are scanned every step; keep them on huge pages
+    UseVirtualMemory(VirtualMemorySettings{});
 }
 
 bool DaisyPhysics::Initialize() {
-    DAISY_INFO("Initializing Daisy Physics Engine");
+    DAISY_CHANNEL_INFO(Physics, "Initializing Daisy Physics Engine");
     
-    m_rigidBodies.reserve(10000);
+    ReserveBodies(10000);
     m_gravityWells.reserve(1000);
     
     m_initialized = true;
-    DAISY_INFO("Daisy Physics Engine initialized successfully");
+    DAISY_CHANNEL_INFO(Physics, "Daisy Physics Engine initialized successfully");
     return true;
 }
 
 void DaisyPhysics::Update(float deltaTime) {
     if (!m_initialized) return;
     
-    ApplyGravity(deltaTime);
-    IntegrateRigidBodies(deltaTime);
+    PrepareGravity();
+    // Forces and integration touch only their own body, so they share one pass
+    RunParallel(m_rigidBodies.Size(), BodyGrainSize, [this, deltaTime](size_t begin, size_t end) {
+        ApplyGravity(begin, end);
+        ApplyAtmosphericDrag(begin, end);
+        IntegrateRigidBodies(deltaTime, begin, end);
+    });
     CheckCollisions();
     UpdateLOD();
 }
@@ -31,57 +65,117 @@ void DaisyPhysics::Update(float deltaTime) {
 void DaisyPhysics::Shutdown() {
     if (!m_initialized) return;
     
-    DAISY_INFO("Shutting down Daisy Physics Engine");
+    DAISY_CHANNEL_INFO(Physics, "Shutting down Daisy Physics Engine");
     
-    m_rigidBodies.clear();
+    m_rigidBodies.Clear();
+    m_positions.clear();
+    m_velocities.clear();
+    m_forces.clear();
+    m_masses.clear();
+    m_inverseMasses.clear();
+    m_dragDensities.clear();
+    m_flags.clear();
+    m_broadphase.Clear();
+    m_candidatePairs.clear();
+    m_contacts.clear();
     m_collisionShapes.clear();
     m_gravityWells.clear();
-    m_atmosphericDensity.clear();
+    m_gravityTree.Clear();
+    m_gravityTreeDirty = true;
     
     m_initialized = false;
-    DAISY_INFO("Daisy Physics Engine shut down successfully");
+    DAISY_CHANNEL_INFO(Physics, "Daisy Physics Engine shut down successfully");
 }
 
-uint32_t DaisyPhysics::CreateRigidBody(const Vector3& position, float mass) {
-    auto body = std::make_unique<RigidBody>();
-    body->id = m_nextBodyId++;
-    body->position = position;
-    body->mass = mass;
-    body->invMass = mass > 0.0f ? 1.0f / mass : 0.0f;
+RigidBodyHandle DaisyPhysics::CreateRigidBody(const DVector3& position, float mass) {
+    EnsureCapacity(1);
+    return AddBody(position, mass);
+}
+
+void DaisyPhysics::DestroyRigidBody(RigidBodyHandle id) {
+    RemoveBody(id);
+}
+
+void DaisyPhysics::CreateRigidBodies(std::span<const DVector3> positions, std::span<RigidBodyHandle> handles, float mass) {
+    if (handles.size() < positions.size()) {
+        DAISY_CHANNEL_ERROR(Physics, "CreateRigidBodies needs {} handles, got {}", positions.size(), handles.size());
+        return;
+    }
     
-    uint32_t id = body->id;
-    m_rigidBodies.push_back(std::move(body));
+    // Fill the arrays a field at a time rather than a body at a time. They
+    // cannot fail once grown; the slot map and broadphase can, and are unwound.
+    const size_t first = m_rigidBodies.Size();
+    const size_t last = first + positions.size();
+    EnsureCapacity(positions.size());
+    m_positions.insert(m_positions.end(), positions.begin(), positions.end());
+    m_velocities.resize(last);
+    m_forces.resize(last);
+    m_masses.resize(last, mass);
+    m_inverseMasses.resize(last, mass > 0.0f ? 1.0f / mass : 0.0f);
+    m_dragDensities.resize(last, 0.0f);
+    m_flags.resize(last);
     
-    return id;
+    size_t inserted = 0;
+    size_t proxied = 0;
+    try {
+        for (; inserted < positions.size(); ++inserted) {
+            handles[inserted] = m_rigidBodies.Insert();
+        }
+        
+        std::span<RigidBodyProperties> properties = m_rigidBodies.Values();
+        for (; proxied < positions.size(); ++proxied) {
+            RigidBodyProperties& body = properties[first + proxied];
+            body.id = handles[proxied];
+            body.broadphaseProxy = m_broadphase.AddProxy(Aabb::FromCenter(positions[proxied], body.collisionRadius),
+                                                         handles[proxied].ToBits(), false);
+        }
+    } catch (...) {
+        // Nothing of the batch stays. The newest bodies are last in dense
+        // order, so erasing them newest first moves no other body.
+        std::span<RigidBodyProperties> properties = m_rigidBodies.Values();
+        while (proxied > 0) {
+            --proxied;
+            m_broadphase.RemoveProxy(properties[first + proxied].broadphaseProxy);
+        }
+        while (inserted > 0) {
+            m_rigidBodies.Erase(handles[--inserted]);
+        }
+        TruncateBodies(first);
+        throw;
+    }
 }
 
-void DaisyPhysics::DestroyRigidBody(uint32_t id) {
-    auto it = std::remove_if(m_rigidBodies.begin(), m_rigidBodies.end(),
-        [id](const std::unique_ptr<RigidBody>& body) {
-            return body->id == id;
-        });
-    
-    if (it != m_rigidBodies.end()) {
-        m_rigidBodies.erase(it, m_rigidBodies.end());
-        m_collisionShapes.erase(id);
-        m_atmosphericDensity.erase(id);
+void DaisyPhysics::DestroyRigidBodies(std::span<const RigidBodyHandle> ids) {
+    for (RigidBodyHandle id : ids) {
+        RemoveBody(id);
     }
 }
 
-RigidBody* DaisyPhysics::GetRigidBody(uint32_t id) {
-    auto it = std::find_if(m_rigidBodies.begin(), m_rigidBodies.end(),
-        [id](const std::unique_ptr<RigidBody>& body) {
-            return body->id == id;
-        });
+std::optional<RigidBody> DaisyPhysics::GetRigidBody(RigidBodyHandle id) {
+    uint32_t dense = m_rigidBodies.GetDenseIndex(id);
+    if (dense == RigidBodyHandle::InvalidIndex) {
+        return std::nullopt;
+    }
     
-    return it != m_rigidBodies.end() ? it->get() : nullptr;
+    RigidBodyProperties& properties = m_rigidBodies.Values()[dense];
+    return RigidBody{
+        m_positions[dense], m_velocities[dense], m_forces[dense],
+        properties.rotation, properties.angularVelocity, properties.torque,
+        m_masses[dense], m_inverseMasses[dense], properties.restitution, properties.friction,
+        m_flags[dense].isStatic, m_flags[dense].useGravity,
+        properties.collisionRadius,
+        id
+    };
 }
 
-void DaisyPhysics::SetCollisionShape(uint32_t bodyId, std::unique_ptr<CollisionShape> shape) {
+void DaisyPhysics::SetCollisionShape(RigidBodyHandle bodyId, std::unique_ptr<CollisionShape> shape) {
+    if (RigidBodyProperties* properties = m_rigidBodies.Get(bodyId)) {
+        properties->collisionRadius = shape && shape->type == CollisionShape::Sphere ? shape->dimensions.x : 1.0f;
+    }
     m_collisionShapes[bodyId] = std::move(shape);
 }
 
-void DaisyPhysics::AddGravityWell(const Vector3& position, float mass, float radius, bool isPlanet) {
+void DaisyPhysics::AddGravityWell(const DVector3& position, float mass, float radius, bool isPlanet) {
     GravityWell well;
     well.position = position;
     well.mass = mass;
@@ -90,153 +184,360 @@ void DaisyPhysics::AddGravityWell(const Vector3& position, float mass, float rad
     well.isStar = mass > 1e30f;
     
     m_gravityWells.push_back(well);
+    m_gravityTreeDirty = true;
 }
 
-void DaisyPhysics::ApplyForce(uint32_t bodyId, const Vector3& force) {
-    auto* body = GetRigidBody(bodyId);
-    if (body && !body->isStatic) {
-        body->force = body->force + force;
+void DaisyPhysics::ApplyForce(RigidBodyHandle bodyId, const Vector3& force) {
+    uint32_t dense = m_rigidBodies.GetDenseIndex(bodyId);
+    if (dense != RigidBodyHandle::InvalidIndex && !m_flags[dense].isStatic) {
+        m_forces[dense] = m_forces[dense] + force;
     }
 }
 
-void DaisyPhysics::ApplyImpulse(uint32_t bodyId, const Vector3& impulse) {
-    auto* body = GetRigidBody(bodyId);
-    if (body && !body->isStatic) {
-        body->velocity = body->velocity + impulse * body->invMass;
+void DaisyPhysics::ApplyImpulse(RigidBodyHandle bodyId, const Vector3& impulse) {
+    uint32_t dense = m_rigidBodies.GetDenseIndex(bodyId);
+    if (dense != RigidBodyHandle::InvalidIndex && !m_flags[dense].isStatic) {
+        m_velocities[dense] = m_velocities[dense] + impulse * m_inverseMasses[dense];
     }
 }
 
-void DaisyPhysics::ApplyTorque(uint32_t bodyId, const Vector3& torque) {
-    auto* body = GetRigidBody(bodyId);
-    if (body && !body->isStatic) {
-        body->torque = body->torque + torque;
+void DaisyPhysics::ApplyTorque(RigidBodyHandle bodyId, const Vector3& torque) {
+    uint32_t dense = m_rigidBodies.GetDenseIndex(bodyId);
+    if (dense != RigidBodyHandle::InvalidIndex && !m_flags[dense].isStatic) {
+        RigidBodyProperties& properties = m_rigidBodies.Values()[dense];
+        properties.torque = properties.torque + torque;
     }
 }
 
-void DaisyPhysics::SetAtmosphere(uint32_t bodyId, float density) {
-    m_atmosphericDensity[bodyId] = density;
+void DaisyPhysics::SetAtmosphere(RigidBodyHandle bodyId, float density) {
+    uint32_t dense = m_rigidBodies.GetDenseIndex(bodyId);
+    if (dense != RigidBodyHandle::InvalidIndex) {
+        m_dragDensities[dense] = density;
+    }
 }
 
-void DaisyPhysics::IntegrateRigidBodies(float deltaTime) {
-    for (auto& body : m_rigidBodies) {
-        if (body->isStatic) continue;
-        
-        body->acceleration = body->force * body->invMass;
-        body->velocity = body->velocity + body->acceleration * deltaTime;
-        body->position = body->position + body->velocity * deltaTime;
-        
-        if (m_atmosphericDensity.find(body->id) != m_atmosphericDensity.end()) {
-            ApplyAtmosphericDrag(*body, deltaTime);
-        }
+void DaisyPhysics::ReserveBodies(size_t count) {
+    m_rigidBodies.Reserve(count);
+    m_positions.reserve(count);
+    m_velocities.reserve(count);
+    m_forces.reserve(count);
+    m_masses.reserve(count);
+    m_inverseMasses.reserve(count);
+    m_dragDensities.reserve(count);
+    m_flags.reserve(count);
+}
+
+void DaisyPhysics::EnsureCapacity(size_t count) {
+    // Grow every array before touching any, so a failed allocation leaves
+    // them all the same length
+    size_t size = m_rigidBodies.Size();
+    if (size + count > m_positions.capacity()) {
+        ReserveBodies(std::max(size + count, size * 2));
+    }
+}
+
+void DaisyPhysics::TruncateBodies(size_t count) {
+    m_positions.resize(count);
+    m_velocities.resize(count);
+    m_forces.resize(count);
+    m_masses.resize(count);
+    m_inverseMasses.resize(count);
+    m_dragDensities.resize(count);
+    m_flags.resize(count);
+}
+
+RigidBodyHandle DaisyPhysics::AddBody(const DVector3& position, float mass) {
+    RigidBodyHandle id = m_rigidBodies.Insert();
+    RigidBodyProperties* properties = m_rigidBodies.Get(id);
+    properties->id = id;
+    
+    m_positions.push_back(position);
+    m_velocities.emplace_back();
+    m_forces.emplace_back();
+    m_masses.push_back(mass);
+    m_inverseMasses.push_back(mass > 0.0f ? 1.0f / mass : 0.0f);
+    m_dragDensities.push_back(0.0f);
+    m_flags.emplace_back();
+    
+    properties->broadphaseProxy =
+        m_broadphase.AddProxy(Aabb::FromCenter(position, properties->collisionRadius), id.ToBits(), false);
+    return id;
+}
+
+void DaisyPhysics::RemoveBody(RigidBodyHandle id) {
+    uint32_t dense = m_rigidBodies.GetDenseIndex(id);
+    if (dense == RigidBodyHandle::InvalidIndex) return;
+    
+    m_broadphase.RemoveProxy(m_rigidBodies.Values()[dense].broadphaseProxy);
+    
+    // Same move-last-into-the-hole as the slot map's Erase, so the arrays stay aligned with it
+    auto eraseAt = [dense](auto& values) {
+        values[dense] = values.back();
+        values.pop_back();
+    };
+    eraseAt(m_positions);
+    eraseAt(m_velocities);
+    eraseAt(m_forces);
+    eraseAt(m_masses);
+    eraseAt(m_inverseMasses);
+    eraseAt(m_dragDensities);
+    eraseAt(m_flags);
+    m_rigidBodies.Erase(id);
+    if (!m_collisionShapes.empty()) {
+        m_collisionShapes.erase(id);
+    }
+}
+
+void DaisyPhysics::IntegrateRigidBodies(float deltaTime, size_t begin, size_t end) {
+    DVector3* positions = m_positions.data();
+    Vector3* velocities = m_velocities.data();
+    Vector3* forces = m_forces.data();
+    const float* inverseMasses = m_inverseMasses.data();
+    const RigidBodyFlags* flags = m_flags.data();
+    
+    // Static bodies keep their velocity but do not move; selecting a zero
+    // step instead of branching keeps the loop free of control flow
+    for (size_t i = begin; i < end; ++i) {
+        float step = flags[i].isStatic ? 0.0f : deltaTime;
+        velocities[i] = velocities[i] + forces[i] * (inverseMasses[i] * step);
+        positions[i] = positions[i] + DVector3(velocities[i] * step);
+        forces[i] = Vector3(0, 0, 0);
+    }
+    
+    std::span<RigidBodyProperties> properties = m_rigidBodies.Values();
+    for (size_t i = begin; i < end; ++i) {
+        if (flags[i].isStatic) continue;
+        RigidBodyProperties& body = properties[i];
         
-        Vector3 angularAcceleration = body->torque * body->invMass;
-        body->angularVelocity = body->angularVelocity + angularAcceleration * deltaTime;
+        Vector3 angularAcceleration = body.torque * inverseMasses[i];
+        body.angularVelocity = body.angularVelocity + angularAcceleration * deltaTime;
         
-        if (body->angularVelocity.LengthSquared() > 0) {
-            float angle = body->angularVelocity.Length() * deltaTime;
-            Vector3 axis = body->angularVelocity.Normalized();
-            Quaternion deltaRotation = Quaternion::FromAxisAngle(axis, angle);
-            body->rotation = (deltaRotation * body->rotation).Normalized();
+        float angularSpeedSquared = body.angularVelocity.LengthSquared();
+        if (angularSpeedSquared > 0) {
+            // Renormalized every step, so the fast tier's error never accumulates
+            float inverseSpeed = FastMath::InverseSqrt(angularSpeedSquared);
+            float angle = angularSpeedSquared * inverseSpeed * deltaTime;
+            Vector3 axis = body.angularVelocity * inverseSpeed;
+            float sin, cos;
+            FastMath::SinCos(angle * 0.5f, sin, cos);
+            Quaternion deltaRotation(axis.x * sin, axis.y * sin, axis.z * sin, cos);
+            body.rotation = FastMath::Normalize(deltaRotation * body.rotation);
         }
         
-        body->force = Vector3(0, 0, 0);
-        body->torque = Vector3(0, 0, 0);
+        body.torque = Vector3(0, 0, 0);
     }
 }
 
-void DaisyPhysics::ApplyGravity(float deltaTime) {
-    for (auto& body : m_rigidBodies) {
-        if (body->isStatic || !body->useGravity) continue;
-        
-        if (m_globalGravity.LengthSquared() > 0) {
-            Vector3 globalForce = m_globalGravity * body->mass;
-            body->force = body->force + globalForce;
+void DaisyPhysics::ApplyGravity(size_t begin, size_t end) {
+    const DVector3* positions = m_positions.data();
+    Vector3* forces = m_forces.data();
+    const float* masses = m_masses.data();
+    const RigidBodyFlags* flags = m_flags.data();
+    
+    if (m_globalGravity.LengthSquared() > 0) {
+        for (size_t i = begin; i < end; ++i) {
+            float weight = flags[i].useGravity && !flags[i].isStatic ? masses[i] : 0.0f;
+            forces[i] = forces[i] + m_globalGravity * weight;
         }
-        
-        for (const auto& well : m_gravityWells) {
-            Vector3 direction = well.position - body->position;
-            float distance = direction.Length();
-            
-            if (distance > 0 && distance < well.radius) {
-                direction = direction.Normalized();
-                
-                float gravitationalForce = (6.674e-11f * well.mass * body->mass) / (distance * distance);
-                
-                if (well.isPlanet && distance < well.radius * 0.1f) {
-                    gravitationalForce *= (distance / (well.radius * 0.1f));
-                }
-                
-                Vector3 force = direction * gravitationalForce;
-                body->force = body->force + force;
-            }
+    }
+    
+    if (m_useGravityTree) {
+        const float openingAngle = m_gravitySettings.openingAngle;
+        for (size_t i = begin; i < end; ++i) {
+            if (flags[i].isStatic || !flags[i].useGravity) continue;
+            forces[i] = forces[i] + m_gravityTree.ComputeForce(positions[i], masses[i], openingAngle);
+        }
+        return;
+    }
+    
+    for (const auto& well : m_gravityWells) {
+        for (size_t i = begin; i < end; ++i) {
+            if (flags[i].isStatic || !flags[i].useGravity) continue;
+            forces[i] = forces[i] + ComputeWellForce(well, positions[i], masses[i]);
         }
     }
 }
 
+void DaisyPhysics::PrepareGravity() {
+    switch (m_gravitySettings.solver) {
+        case GravitySolver::Exact:
+            m_useGravityTree = false;
+            break;
+        case GravitySolver::BarnesHut:
+            m_useGravityTree = !m_gravityWells.empty();
+            break;
+        case GravitySolver::Automatic:
+            m_useGravityTree = m_gravityWells.size() >= m_gravitySettings.treeThreshold;
+            break;
+    }
+    
+    // Wells only change through AddGravityWell, so the tree is rebuilt then rather than every step
+    if (m_useGravityTree && m_gravityTreeDirty) {
+        m_gravityTree.Build(m_gravityWells);
+        m_gravityTreeDirty = false;
+    }
+}
+
 void DaisyPhysics::CheckCollisions() {
-    for (size_t i = 0; i < m_rigidBodies.size(); ++i) {
-        for (size_t j = i + 1; j < m_rigidBodies.size(); ++j) {
-            auto& bodyA = m_rigidBodies[i];
-            auto& bodyB = m_rigidBodies[j];
-            
-            if (bodyA->isStatic && bodyB->isStatic) continue;
+    // The broadphase is not thread-safe, so proxies are updated here and
+    // FindPairs spreads its own work
+    std::span<RigidBodyProperties> properties = m_rigidBodies.Values();
+    for (size_t i = 0; i < properties.size(); ++i) {
+        m_broadphase.UpdateProxy(properties[i].broadphaseProxy,
+                                 Aabb::FromCenter(m_positions[i], properties[i].collisionRadius), m_flags[i].isStatic);
+    }
+    JobSystem* jobSystem = GetParallelJobSystem();
+    m_broadphase.FindPairs(m_candidatePairs, jobSystem);
+    
+    m_contacts.clear();
+    for (const BroadphasePair& pair : m_candidatePairs) {
+        uint32_t a = m_rigidBodies.GetDenseIndex(RigidBodyHandle::FromBits(pair.userDataA));
+        uint32_t b = m_rigidBodies.GetDenseIndex(RigidBodyHandle::FromBits(pair.userDataB));
+        if (a != RigidBodyHandle::InvalidIndex && b != RigidBodyHandle::InvalidIndex) {
+            m_contacts.push_back(Contact{a, b});
+        }
+    }
+    
+    if (!jobSystem || m_contacts.size() < 2 * ContactGrainSize) {
+        SolveContacts(m_contacts);
+        return;
+    }
+    
+    BuildIslands();
+    RunParallel(m_solverChunks.size() - 1, 1, [this](size_t begin, size_t end) {
+        for (size_t chunk = begin; chunk < end; ++chunk) {
+            std::span<const Contact> contacts(m_islandContacts);
+            SolveContacts(contacts.subspan(m_solverChunks[chunk], m_solverChunks[chunk + 1] - m_solverChunks[chunk]));
+        }
+    });
+}
+
+void DaisyPhysics::BuildIslands() {
+    constexpr uint32_t NoIsland = std::numeric_limits<uint32_t>::max();
+    const size_t bodyCount = m_rigidBodies.Size();
+    m_islandParents.resize(bodyCount);
+    std::iota(m_islandParents.begin(), m_islandParents.end(), 0u);
+    auto findRoot = [parents = m_islandParents.data()](uint32_t body) {
+        while (parents[body] != body) {
+            parents[body] = parents[parents[body]];
+            body = parents[body];
+        }
+        return body;
+    };
+    
+    // Static bodies are only read while solving, so they do not join islands.
+    // The lower index always becomes the root, so the islands depend on
+    // nothing but the contacts.
+    for (const Contact& contact : m_contacts) {
+        if (m_flags[contact.bodyA].isStatic || m_flags[contact.bodyB].isStatic) continue;
+        uint32_t rootA = findRoot(contact.bodyA);
+        uint32_t rootB = findRoot(contact.bodyB);
+        if (rootA != rootB) {
+            m_islandParents[std::max(rootA, rootB)] = std::min(rootA, rootB);
+        }
+    }
+    
+    // Islands are numbered by first contact, and a counting sort groups the
+    // contacts by island while keeping their order within each
+    m_islandIds.assign(bodyCount, NoIsland);
+    m_contactIslands.resize(m_contacts.size());
+    m_islandStarts.assign(1, 0);
+    uint32_t islandCount = 0;
+    for (size_t i = 0; i < m_contacts.size(); ++i) {
+        const Contact& contact = m_contacts[i];
+        uint32_t& island = m_islandIds[findRoot(m_flags[contact.bodyA].isStatic ? contact.bodyB : contact.bodyA)];
+        if (island == NoIsland) {
+            island = islandCount++;
+            m_islandStarts.push_back(0);
+        }
+        m_contactIslands[i] = island;
+        ++m_islandStarts[island + 1];
+    }
+    for (uint32_t island = 0; island < islandCount; ++island) {
+        m_islandStarts[island + 1] += m_islandStarts[island];
+    }
+    m_islandContacts.resize(m_contacts.size());
+    for (size_t i = 0; i < m_contacts.size(); ++i) {
+        m_islandContacts[m_islandStarts[m_contactIslands[i]]++] = m_contacts[i];
+    }
+    
+    // Each start has now advanced to its island's end. Whole islands are
+    // packed into chunks of at least ContactGrainSize contacts.
+    m_solverChunks.assign(1, 0);
+    for (uint32_t island = 0; island < islandCount; ++island) {
+        size_t islandEnd = m_islandStarts[island];
+        if (islandEnd - m_solverChunks.back() >= ContactGrainSize || island + 1 == islandCount) {
+            m_solverChunks.push_back(islandEnd);
+        }
+    }
+}
+
+void DaisyPhysics::SolveContacts(std::span<const Contact> contacts) {
+    std::span<const RigidBodyProperties> properties = m_rigidBodies.Values();
+    for (const Contact& contact : contacts) {
+        const uint32_t a = contact.bodyA;
+        const uint32_t b = contact.bodyB;
+        bool staticA = m_flags[a].isStatic;
+        bool staticB = m_flags[b].isStatic;
+        
+        Vector3 direction = (m_positions[b] - m_positions[a]).ToVector3();
+        float distanceSquared = direction.LengthSquared();
+        
+        float radiusSum = properties[a].collisionRadius + properties[b].collisionRadius;
+        if (distanceSquared < radiusSum * radiusSum && distanceSquared > 0) {
+            // One inverse square root gives both the distance and the normal
+            float inverseDistance = FastMath::InverseSqrt(distanceSquared);
+            float distance = distanceSquared * inverseDistance;
+            Vector3 normal = direction * inverseDistance;
+            float overlap = radiusSum - distance;
             
-            Vector3 direction = bodyB->position - bodyA->position;
-            float distance = direction.Length();
+            Vector3 separation = normal * (overlap * 0.5f);
+            if (!staticA) m_positions[a] = m_positions[a] - separation;
+            if (!staticB) m_positions[b] = m_positions[b] + separation;
             
-            float radiusA = 1.0f;
-            float radiusB = 1.0f;
+            Vector3 relativeVelocity = m_velocities[b] - m_velocities[a];
+            float velocityAlongNormal = relativeVelocity.Dot(normal);
             
-            auto shapeA = m_collisionShapes.find(bodyA->id);
-            auto shapeB = m_collisionShapes.find(bodyB->id);
+            if (velocityAlongNormal > 0) continue;
             
-            if (shapeA != m_collisionShapes.end() && shapeA->second->type == CollisionShape::Sphere) {
-                radiusA = shapeA->second->dimensions.x;
-            }
-            if (shapeB != m_collisionShapes.end() && shapeB->second->type == CollisionShape::Sphere) {
-                radiusB = shapeB->second->dimensions.x;
-            }
+            float e = std::min(properties[a].restitution, properties[b].restitution);
+            float j = -(1 + e) * velocityAlongNormal;
+            j /= m_inverseMasses[a] + m_inverseMasses[b];
             
-            if (distance < radiusA + radiusB && distance > 0) {
-                Vector3 normal = direction.Normalized();
-                float overlap = (radiusA + radiusB) - distance;
-                
-                Vector3 separation = normal * (overlap * 0.5f);
-                if (!bodyA->isStatic) bodyA->position = bodyA->position - separation;
-                if (!bodyB->isStatic) bodyB->position = bodyB->position + separation;
-                
-                Vector3 relativeVelocity = bodyB->velocity - bodyA->velocity;
-                float velocityAlongNormal = relativeVelocity.Dot(normal);
-                
-                if (velocityAlongNormal > 0) continue;
-                
-                float e = std::min(bodyA->restitution, bodyB->restitution);
-                float j = -(1 + e) * velocityAlongNormal;
-                j /= bodyA->invMass + bodyB->invMass;
-                
-                Vector3 impulse = normal * j;
-                if (!bodyA->isStatic) bodyA->velocity = bodyA->velocity - impulse * bodyA->invMass;
-                if (!bodyB->isStatic) bodyB->velocity = bodyB->velocity + impulse * bodyB->invMass;
-            }
+            Vector3 impulse = normal * j;
+            if (!staticA) m_velocities[a] = m_velocities[a] - impulse * m_inverseMasses[a];
+            if (!staticB) m_velocities[b] = m_velocities[b] + impulse * m_inverseMasses[b];
         }
     }
 }
 
-void DaisyPhysics::ApplyAtmosphericDrag(RigidBody& body, float deltaTime) {
-    float density = m_atmosphericDensity[body.id];
-    float dragCoefficient = 0.47f;
-    float area = 1.0f;
-    
-    Vector3 velocity = body.velocity;
-    float speed = velocity.Length();
+void DaisyPhysics::ApplyAtmosphericDrag(size_t begin, size_t end) {
+    constexpr float dragCoefficient = 0.47f;
+    constexpr float area = 1.0f;
     
-    if (speed > 0) {
-        Vector3 dragDirection = velocity.Normalized() * -1.0f;
-        float dragMagnitude = 0.5f * density * speed * speed * dragCoefficient * area;
+    // 0.5 * density * speed^2 * Cd * A against the velocity, which is the
+    // velocity scaled by -0.5 * density * Cd * A * speed
+    for (size_t i = begin; i < end; ++i) {
+        float density = m_dragDensities[i];
+        if (density <= 0.0f || m_flags[i].isStatic) continue;
         
-        Vector3 dragForce = dragDirection * dragMagnitude;
-        body.force = body.force + dragForce;
+        float speed = FastMath::Sqrt(m_velocities[i].LengthSquared());
+        m_forces[i] = m_forces[i] - m_velocities[i] * (0.5f * density * dragCoefficient * area * speed);
+    }
+}
+
+JobSystem* DaisyPhysics::GetParallelJobSystem() const {
+    JobSystem* jobSystem = GetJobSystem();
+    return jobSystem && jobSystem->GetWorkerCount() > 0 ? jobSystem : nullptr;
+}
+
+void DaisyPhysics::RunParallel(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& body) {
+    JobSystem* jobSystem = GetParallelJobSystem();
+    if (!jobSystem || count <= grainSize) {
+        body(0, count);
+        return;
     }
+    jobSystem->Wait(jobSystem->ParallelFor(0, count, grainSize, body));
 }
 
 void DaisyPhysics::UpdateLOD() {
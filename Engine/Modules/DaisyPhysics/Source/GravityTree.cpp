@@ -0,0 +1,178 @@
+#include "GravityTree.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Daisy {
+
+namespace {
+    // Squared distances from a point to the nearest and farthest points of a box
+    double NearestDistanceSquared(const Aabb& bounds, const DVector3& point) {
+        double dx = std::max({bounds.min.x - point.x, 0.0, point.x - bounds.max.x});
+        double dy = std::max({bounds.min.y - point.y, 0.0, point.y - bounds.max.y});
+        double dz = std::max({bounds.min.z - point.z, 0.0, point.z - bounds.max.z});
+        return dx * dx + dy * dy + dz * dz;
+    }
+    
+    double FarthestDistanceSquared(const Aabb& bounds, const DVector3& point) {
+        double dx = std::max(std::abs(point.x - bounds.min.x), std::abs(point.x - bounds.max.x));
+        double dy = std::max(std::abs(point.y - bounds.min.y), std::abs(point.y - bounds.max.y));
+        double dz = std::max(std::abs(point.z - bounds.min.z), std::abs(point.z - bounds.max.z));
+        return dx * dx + dy * dy + dz * dz;
+    }
+}
+
+GravityTree::GravityTree(std::pmr::memory_resource* resource)
+    : m_nodes(resource)
+    , m_roots(resource)
+    , m_wells(resource) {
+}
+
+void GravityTree::Build(std::span<const GravityWell> wells) {
+    m_nodes.clear();
+    m_roots.clear();
+    m_wells.clear();
+    // A well without a positive radius never pulls anything
+    for (const GravityWell& well : wells) {
+        if (well.radius > 0.0f) {
+            m_wells.push_back(well);
+        }
+    }
+    
+    // A group mixing small and large radii is rarely all in range, so it
+    // would almost always be opened. Each band of radii within a factor of
+    // four gets its own tree instead.
+    auto bandOf = [](const GravityWell& well) { return std::ilogb(well.radius) / 2; };
+    std::stable_sort(m_wells.begin(), m_wells.end(),
+                     [&bandOf](const GravityWell& a, const GravityWell& b) { return bandOf(a) < bandOf(b); });
+    for (size_t first = 0; first < m_wells.size();) {
+        size_t last = first + 1;
+        while (last < m_wells.size() && bandOf(m_wells[last]) == bandOf(m_wells[first])) {
+            ++last;
+        }
+        uint32_t root = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+        m_roots.push_back(root);
+        BuildNode(root, first, last, 0);
+        first = last;
+    }
+}
+
+void GravityTree::Clear() {
+    m_nodes.clear();
+    m_roots.clear();
+    m_wells.clear();
+}
+
+void GravityTree::BuildNode(uint32_t nodeIndex, size_t first, size_t last, int depth) {
+    Node node;
+    node.firstWell = static_cast<uint32_t>(first);
+    node.wellCount = static_cast<uint32_t>(last - first);
+    node.bounds = Aabb{m_wells[first].position, m_wells[first].position};
+    node.minRadius = m_wells[first].radius;
+    DVector3 weightedPosition;
+    for (size_t i = first; i < last; ++i) {
+        const GravityWell& well = m_wells[i];
+        node.bounds = node.bounds.Union(Aabb{well.position, well.position});
+        node.mass += well.mass;
+        weightedPosition = weightedPosition + well.position * well.mass;
+        node.minRadius = std::min(node.minRadius, static_cast<double>(well.radius));
+        node.maxRadius = std::max(node.maxRadius, static_cast<double>(well.radius));
+        if (well.isPlanet) {
+            node.coreRadius = std::max(node.coreRadius, well.radius * 0.1);
+        }
+    }
+    node.centerOfMass = node.mass > 0.0 ? weightedPosition / node.mass : (node.bounds.min + node.bounds.max) * 0.5;
+    
+    if (last - first <= LeafSize || depth >= MaxDepth || !(node.bounds.LargestExtent() > 0.0)) {
+        m_nodes[nodeIndex] = node;
+        return;
+    }
+    
+    // Split at the middle of the bounds, but only across axes at least half
+    // as long as the longest, so a flat disk of wells becomes a quadtree
+    // instead of halving a thickness that never decides the opening test.
+    // The bounds are tight, so the longest axis always splits and every level
+    // makes progress.
+    const DVector3 center = (node.bounds.min + node.bounds.max) * 0.5;
+    const DVector3 size = node.bounds.max - node.bounds.min;
+    const double splitExtent = node.bounds.LargestExtent() * 0.5;
+    const bool splitX = size.x >= splitExtent, splitY = size.y >= splitExtent, splitZ = size.z >= splitExtent;
+    auto octantOf = [&](const GravityWell& well) {
+        return (splitX && well.position.x >= center.x ? 1 : 0) | (splitY && well.position.y >= center.y ? 2 : 0) |
+               (splitZ && well.position.z >= center.z ? 4 : 0);
+    };
+    std::stable_sort(m_wells.begin() + first, m_wells.begin() + last,
+                     [&octantOf](const GravityWell& a, const GravityWell& b) { return octantOf(a) < octantOf(b); });
+    
+    size_t childStarts[9];
+    size_t childCount = 0;
+    for (size_t i = first; i < last; ++i) {
+        if (i == first || octantOf(m_wells[i]) != octantOf(m_wells[i - 1])) {
+            childStarts[childCount++] = i;
+        }
+    }
+    childStarts[childCount] = last;
+    
+    node.firstChild = static_cast<uint32_t>(m_nodes.size());
+    node.childCount = static_cast<uint32_t>(childCount);
+    m_nodes[nodeIndex] = node;
+    m_nodes.resize(m_nodes.size() + childCount);
+    for (size_t child = 0; child < childCount; ++child) {
+        BuildNode(node.firstChild + static_cast<uint32_t>(child), childStarts[child], childStarts[child + 1], depth + 1);
+    }
+}
+
+void GravityTree::AccumulateForce(uint32_t root, const DVector3& position, float mass, double openingAngleSquared,
+                                  Vector3& force) const {
+    // Each level pops one node and pushes at most eight
+    uint32_t stack[MaxDepth * 7 + 8];
+    size_t count = 0;
+    stack[count++] = root;
+    while (count > 0) {
+        const Node& node = m_nodes[stack[--count]];
+        double nearestSquared = NearestDistanceSquared(node.bounds, position);
+        if (nearestSquared >= node.maxRadius * node.maxRadius) {
+            continue;
+        }
+        
+        if (node.childCount == 0) {
+            for (uint32_t i = node.firstWell; i < node.firstWell + node.wellCount; ++i) {
+                force = force + ComputeWellForce(m_wells[i], position, mass);
+            }
+            continue;
+        }
+        
+        // One mass only stands in for the group when no well in it would be
+        // out of range or inside a planet core on its own
+        DVector3 offset = node.centerOfMass - position;
+        double distanceSquared = offset.LengthSquared();
+        double size = node.bounds.LargestExtent();
+        if (size * size < openingAngleSquared * distanceSquared &&
+            FarthestDistanceSquared(node.bounds, position) < node.minRadius * node.minRadius &&
+            nearestSquared >= node.coreRadius * node.coreRadius) {
+            double distance = std::sqrt(distanceSquared);
+            double gravitationalForce = GravitationalConstant * node.mass * mass / distanceSquared;
+            force = force + (offset / distance).ToVector3() * static_cast<float>(gravitationalForce);
+            continue;
+        }
+        
+        for (uint32_t child = 0; child < node.childCount; ++child) {
+            stack[count++] = node.firstChild + child;
+        }
+    }
+}
+
+Vector3 GravityTree::ComputeForce(const DVector3& position, float mass, float openingAngle) const {
+    Vector3 force(0, 0, 0);
+    if (m_nodes.empty()) {
+        return force;
+    }
+    
+    const double openingAngleSquared = static_cast<double>(openingAngle) * openingAngle;
+    for (uint32_t root : m_roots) {
+        AccumulateForce(root, position, mass, openingAngleSquared, force);
+    }
+    return force;
+}
+
+}
\ No newline at end of file
@@ -2,10 +2,12 @@
 
 #include "Core/Module.h"
 #include "Core/Math.h"
+#include "Core/SlotMap.h"
 #include "DaisyPlatform.h"
 #include <vulkan/vulkan.h>
 #include <vector>
 #include <memory>
+#include <memory_resource>
 #include <unordered_map>
 
 struct Vector2 {
@@ -16,6 +18,16 @@ struct Vector2 {
 
 namespace Daisy {
 
+struct Mesh;
+struct Material;
+struct Texture;
+struct RenderObject;
+
+using MeshHandle = Handle<Mesh>;
+using MaterialHandle = Handle<Material>;
+using TextureHandle = Handle<Texture>;
+using RenderObjectHandle = Handle<RenderObject>;
+
 struct Vertex {
     Vector3 position;
     Vector3 normal;
@@ -23,10 +35,24 @@ struct Vertex {
     Vector4 color{1, 1, 1, 1};
 };
 
+// Allocator-aware, so a mesh created in a memory resource keeps its geometry there too
 struct Mesh {
-    std::vector<Vertex> vertices;
-    std::vector<uint32_t> indices;
-    uint32_t id = 0;
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+    
+    Mesh() = default;
+    explicit Mesh(const allocator_type& allocator) : vertices(allocator), indices(allocator) {}
+    Mesh(const Mesh& other, const allocator_type& allocator)
+        : vertices(other.vertices, allocator), indices(other.indices, allocator), id(other.id) {}
+    Mesh(Mesh&& other, const allocator_type& allocator)
+        : vertices(std::move(other.vertices), allocator), indices(std::move(other.indices), allocator), id(other.id) {}
+    Mesh(const Mesh&) = default;
+    Mesh(Mesh&&) = default;
+    Mesh& operator=(const Mesh&) = default;
+    Mesh& operator=(Mesh&&) = default;
+    
+    std::pmr::vector<Vertex> vertices;
+    std::pmr::vector<uint32_t> indices;
+    MeshHandle id;
 };
 
 struct Material {
@@ -34,22 +60,34 @@ struct Material {
     float metallic = 0.0f;
     float roughness = 0.5f;
     float emission = 0.0f;
-    uint32_t albedoTexture = 0;
-    uint32_t normalTexture = 0;
-    uint32_t materialTexture = 0;
+    TextureHandle albedoTexture;
+    TextureHandle normalTexture;
+    TextureHandle materialTexture;
+};
+
+struct Texture {
+    VkImage image = VK_NULL_HANDLE;
+    int width = 0;
+    int height = 0;
+    int channels = 0;
 };
 
 struct RenderObject {
-    uint32_t meshId = 0;
-    uint32_t materialId = 0;
-    Matrix4 transform;
+    MeshHandle meshId;
+    MaterialHandle materialId;
+    DVector3 position;          // World-space origin of the object
+    Matrix4 transform;          // Rotation, scale and any offset, relative to position
+    Matrix4 renderTransform;    // transform moved to be relative to the camera; rebuilt every frame
     bool visible = true;
     float lodDistance = 0.0f;
 };
 
+// Rendering is camera-relative: object positions have the camera position
+// subtracted in double precision, so the GPU only sees small float offsets
+// and the view matrix never contains a large translation
 struct Camera {
-    Vector3 position{0, 0, 0};
-    Vector3 target{0, 0, -1};
+    DVector3 position{0, 0, 0};
+    DVector3 target{0, 0, -1};
     Vector3 up{0, 1, 0};
     float fov = 45.0f;
     float nearPlane = 0.1f;
@@ -59,7 +97,7 @@ struct Camera {
 
 struct Light {
     enum Type { Directional, Point, Spot } type;
-    Vector3 position{0, 0, 0};
+    DVector3 position{0, 0, 0};
     Vector3 direction{0, -1, 0};
     Vector4 color{1, 1, 1, 1};
     float intensity = 1.0f;
@@ -78,7 +116,7 @@ struct ProceduralSettings {
 
 class DaisyRender : public Module {
 public:
-    DaisyRender() : Module("DaisyRender") {}
+    DaisyRender();
     virtual ~DaisyRender() = default;
     
     bool Initialize() override;
@@ -91,15 +129,16 @@ public:
     bool InitializeVulkan();
     void ShutdownVulkan();
     
-    uint32_t CreateMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
-    uint32_t CreateMaterial(const Material& material);
-    uint32_t CreateTexture(const void* data, int width, int height, int channels);
-    uint32_t CreateRenderObject(uint32_t meshId, uint32_t materialId, const Matrix4& transform);
+    MeshHandle CreateMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
+    MaterialHandle CreateMaterial(const Material& material);
+    TextureHandle CreateTexture(const void* data, int width, int height, int channels);
+    RenderObjectHandle CreateRenderObject(MeshHandle meshId, MaterialHandle materialId,
+                                          const DVector3& position, const Matrix4& transform = Matrix4());
     
-    void DestroyMesh(uint32_t id);
-    void DestroyMaterial(uint32_t id);
-    void DestroyTexture(uint32_t id);
-    void DestroyRenderObject(uint32_t id);
+    void DestroyMesh(MeshHandle id);
+    void DestroyMaterial(MaterialHandle id);
+    void DestroyTexture(TextureHandle id);
+    void DestroyRenderObject(RenderObjectHandle id);
     
     void SetCamera(const Camera& camera) { m_camera = camera; }
     Camera& GetCamera() { return m_camera; }
@@ -121,11 +160,12 @@ public:
     
     void EnableInfiniteWorld(bool enable) { m_infiniteWorldEnabled = enable; }
     void SetWorldScale(double scale) { m_worldScale = scale; }
-    void SetObserverPosition(const Vector3& position) { m_observerPosition = position; }
+    void SetObserverPosition(const DVector3& position) { m_observerPosition = position; }
     
-    uint32_t GenerateProceduralPlanet(const Vector3& position, float radius);
-    uint32_t GenerateProceduralCity(const Vector3& position, float size);
-    uint32_t GenerateProceduralShip(const Vector3& position, float size);
+    // Meshes are built around their own origin and placed at position
+    RenderObjectHandle GenerateProceduralPlanet(const DVector3& position, float radius);
+    RenderObjectHandle GenerateProceduralCity(const DVector3& position, float size);
+    RenderObjectHandle GenerateProceduralShip(const DVector3& position, float size);
     
 private:
     bool CreateVulkanInstance();
@@ -137,6 +177,7 @@ private:
     
     Window* m_window = nullptr;
     
+    void UpdateRenderTransforms();
     void UpdateLOD();
     void UpdateCulling();
     void RenderFrame();
@@ -156,19 +197,14 @@ private:
     std::vector<VkFramebuffer> m_swapchainFramebuffers;
     std::vector<VkCommandBuffer> m_commandBuffers;
     
-    std::unordered_map<uint32_t, std::unique_ptr<Mesh>> m_meshes;
-    std::unordered_map<uint32_t, Material> m_materials;
-    std::unordered_map<uint32_t, VkImage> m_textures;
-    std::unordered_map<uint32_t, RenderObject> m_renderObjects;
+    SlotMap<Mesh> m_meshes;
+    SlotMap<Material> m_materials;
+    SlotMap<Texture> m_textures;
+    SlotMap<RenderObject> m_renderObjects;
     
     std::vector<Light> m_lights;
     Camera m_camera;
     
-    uint32_t m_nextMeshId = 1;
-    uint32_t m_nextMaterialId = 1;
-    uint32_t m_nextTextureId = 1;
-    uint32_t m_nextObjectId = 1;
-    
     Vector4 m_clearColor{0.1f, 0.1f, 0.2f, 1.0f};
     
     bool m_lodEnabled = true;
@@ -178,7 +214,7 @@ private:
     
     bool m_infiniteWorldEnabled = true;
     double m_worldScale = 1e12;
-    Vector3 m_observerPosition{0, 0, 0};
+    DVector3 m_observerPosition{0, 0, 0};
     
     ProceduralSettings m_proceduralSettings;
     
@@ -1,31 +1,45 @@
 #include "DaisyRender.h"
 #include "Core/Logger.h"
+#include "Core/SimdMath.h"
 #include <algorithm>
 #include <cstring>
 
 namespace Daisy {
 
+DaisyRender::DaisyRender()
+    : Module("DaisyRender")
+    , m_meshes(&GetMemoryResource())
+    , m_materials(&GetMemoryResource())
+    , m_textures(&GetMemoryResource())
+    , m_renderObjects(&GetMemoryResource()) {
+    SetThreading(ModuleThreading::MainThread);
+    // Draws into a window owned by DaisyPlatform, after it has pumped events
+    ReadsModule<DaisyPlatform>();
+    // Render object and mesh arrays are walked every frame; keep them on huge pages
+    UseVirtualMemory(VirtualMemorySettings{});
+}
 
 bool DaisyRender::Initialize() {
-    DAISY_INFO("Initializing Daisy Render Engine");
+    DAISY_CHANNEL_INFO(Render, "Initializing Daisy Render Engine");
     
     if (!InitializeVulkan()) {
-        DAISY_ERROR("Failed to initialize Vulkan");
+        DAISY_CHANNEL_ERROR(Render, "Failed to initialize Vulkan");
         return false;
     }
     
-    m_meshes.reserve(10000);
-    m_renderObjects.reserve(100000);
+    m_meshes.Reserve(10000);
+    m_renderObjects.Reserve(100000);
     m_lights.reserve(1000);
     
     m_initialized = true;
-    DAISY_INFO("Daisy Render Engine initialized successfully");
+    DAISY_CHANNEL_INFO(Render, "Daisy Render Engine initialized successfully");
     return true;
 }
 
 void DaisyRender::Update(float deltaTime) {
     if (!m_initialized) return;
     
+    UpdateRenderTransforms();
     UpdateLOD();
     UpdateCulling();
     GenerateProceduralContent();
@@ -35,49 +49,49 @@ void DaisyRender::Update(float deltaTime) {
 void DaisyRender::Shutdown() {
     if (!m_initialized) return;
     
-    DAISY_INFO("Shutting down Daisy Render Engine");
+    DAISY_CHANNEL_INFO(Render, "Shutting down Daisy Render Engine");
     
     ShutdownVulkan();
     
-    m_meshes.clear();
-    m_materials.clear();
-    m_textures.clear();
-    m_renderObjects.clear();
+    m_meshes.Clear();
+    m_materials.Clear();
+    m_textures.Clear();
+    m_renderObjects.Clear();
     m_lights.clear();
     
     m_initialized = false;
-    DAISY_INFO("Daisy Render Engine shut down successfully");
+    DAISY_CHANNEL_INFO(Render, "Daisy Render Engine shut down successfully");
 }
 
 bool DaisyRender::InitializeVulkan() {
-    DAISY_INFO("Initializing Vulkan");
+    DAISY_CHANNEL_INFO(Render, "Initializing Vulkan");
     
     if (!CreateVulkanInstance()) {
-        DAISY_ERROR("Failed to create Vulkan instance");
+        DAISY_CHANNEL_ERROR(Render, "Failed to create Vulkan instance");
         return false;
     }
     
     if (!CreateDevice()) {
-        DAISY_ERROR("Failed to create Vulkan device");
+        DAISY_CHANNEL_ERROR(Render, "Failed to create Vulkan device");
         return false;
     }
     
     if (!CreateSwapchain()) {
-        DAISY_ERROR("Failed to create swapchain");
+        DAISY_CHANNEL_ERROR(Render, "Failed to create swapchain");
         return false;
     }
     
     if (!CreateRenderPass()) {
-        DAISY_ERROR("Failed to create render pass");
+        DAISY_CHANNEL_ERROR(Render, "Failed to create render pass");
         return false;
     }
     
     if (!CreateCommandBuffers()) {
-        DAISY_ERROR("Failed to create command buffers");
+        DAISY_CHANNEL_ERROR(Render, "Failed to create command buffers");
         return false;
     }
     
-    DAISY_INFO("Vulkan initialized successfully");
+    DAISY_CHANNEL_INFO(Render, "Vulkan initialized successfully");
     return true;
 }
 
@@ -112,63 +126,62 @@ void DaisyRender::ShutdownVulkan() {
         vkDestroyInstance(m_instance, nullptr);
     }
     
-    DAISY_INFO("Vulkan shut down successfully");
+    DAISY_CHANNEL_INFO(Render, "Vulkan shut down successfully");
 }
 
-uint32_t DaisyRender::CreateMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices) {
-    auto mesh = std::make_unique<Mesh>();
-    mesh->id = m_nextMeshId++;
-    mesh->vertices = vertices;
-    mesh->indices = indices;
+MeshHandle DaisyRender::CreateMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices) {
+    // Constructed with the module's memory resource, which the geometry inherits
+    MeshHandle id = m_meshes.Insert();
     
-    uint32_t id = mesh->id;
-    m_meshes[id] = std::move(mesh);
+    Mesh* mesh = m_meshes.Get(id);
+    mesh->id = id;
+    mesh->vertices.assign(vertices.begin(), vertices.end());
+    mesh->indices.assign(indices.begin(), indices.end());
     
     return id;
 }
 
-uint32_t DaisyRender::CreateMaterial(const Material& material) {
-    uint32_t id = m_nextMaterialId++;
-    m_materials[id] = material;
-    return id;
+MaterialHandle DaisyRender::CreateMaterial(const Material& material) {
+    return m_materials.Insert(material);
 }
 
-uint32_t DaisyRender::CreateTexture(const void* data, int width, int height, int channels) {
-    uint32_t id = m_nextTextureId++;
+TextureHandle DaisyRender::CreateTexture(const void* data, int width, int height, int channels) {
+    Texture texture;
+    texture.width = width;
+    texture.height = height;
+    texture.channels = channels;
     // Vulkan texture creation would be implemented here
-    return id;
+    return m_textures.Insert(texture);
 }
 
-uint32_t DaisyRender::CreateRenderObject(uint32_t meshId, uint32_t materialId, const Matrix4& transform) {
-    uint32_t id = m_nextObjectId++;
-    
+RenderObjectHandle DaisyRender::CreateRenderObject(MeshHandle meshId, MaterialHandle materialId,
+                                                   const DVector3& position, const Matrix4& transform) {
     RenderObject obj;
     obj.meshId = meshId;
     obj.materialId = materialId;
+    obj.position = position;
     obj.transform = transform;
     
-    m_renderObjects[id] = obj;
-    return id;
+    return m_renderObjects.Insert(obj);
 }
 
-void DaisyRender::DestroyMesh(uint32_t id) {
-    m_meshes.erase(id);
+void DaisyRender::DestroyMesh(MeshHandle id) {
+    m_meshes.Erase(id);
 }
 
-void DaisyRender::DestroyMaterial(uint32_t id) {
-    m_materials.erase(id);
+void DaisyRender::DestroyMaterial(MaterialHandle id) {
+    m_materials.Erase(id);
 }
 
-void DaisyRender::DestroyTexture(uint32_t id) {
-    auto it = m_textures.find(id);
-    if (it != m_textures.end()) {
+void DaisyRender::DestroyTexture(TextureHandle id) {
+    if (m_textures.Contains(id)) {
         // Destroy Vulkan texture here
-        m_textures.erase(it);
+        m_textures.Erase(id);
     }
 }
 
-void DaisyRender::DestroyRenderObject(uint32_t id) {
-    m_renderObjects.erase(id);
+void DaisyRender::DestroyRenderObject(RenderObjectHandle id) {
+    m_renderObjects.Erase(id);
 }
 
 void DaisyRender::AddLight(const Light& light) {
@@ -211,7 +224,7 @@ void DaisyRender::SetLODDistances(float low, float medium, float high) {
     m_lodDistanceHigh = high;
 }
 
-uint32_t DaisyRender::GenerateProceduralPlanet(const Vector3& position, float radius) {
+RenderObjectHandle DaisyRender::GenerateProceduralPlanet(const DVector3& position, float radius) {
     std::vector<Vertex> vertices;
     std::vector<uint32_t> indices;
     
@@ -234,20 +247,19 @@ uint32_t DaisyRender::GenerateProceduralPlanet(const Vector3& position, float ra
     for (auto& vertex : vertices) {
         vertex.position = vertex.position.Normalized() * radius;
         // Add terrain height based on noise
-        vertex.position = vertex.position + position;
     }
     
-    uint32_t meshId = CreateMesh(vertices, indices);
+    MeshHandle meshId = CreateMesh(vertices, indices);
     
     Material planetMaterial;
     planetMaterial.albedo = Vector4(0.6f, 0.4f, 0.2f, 1.0f);
     planetMaterial.roughness = 0.8f;
-    uint32_t materialId = CreateMaterial(planetMaterial);
+    MaterialHandle materialId = CreateMaterial(planetMaterial);
     
-    return CreateRenderObject(meshId, materialId, Matrix4());
+    return CreateRenderObject(meshId, materialId, position);
 }
 
-uint32_t DaisyRender::GenerateProceduralCity(const Vector3& position, float size) {
+RenderObjectHandle DaisyRender::GenerateProceduralCity(const DVector3& position, float size) {
     std::vector<Vertex> vertices;
     std::vector<uint32_t> indices;
     
@@ -258,7 +270,7 @@ uint32_t DaisyRender::GenerateProceduralCity(const Vector3& position, float size
         for (int z = 0; z < gridSize; ++z) {
             if ((x + z) % 2 == 0 && m_proceduralSettings.buildingDensity > 0.5f) {
                 // Generate building at this position
-                Vector3 buildingPos = position + Vector3(x * 10.0f, 0, z * 10.0f);
+                Vector3 buildingPos(x * 10.0f, 0, z * 10.0f);
                 float height = 5.0f + (rand() % 20);
                 
                 // Add building vertices (simplified box)
@@ -267,18 +279,18 @@ uint32_t DaisyRender::GenerateProceduralCity(const Vector3& position, float size
         }
     }
     
-    uint32_t meshId = CreateMesh(vertices, indices);
+    MeshHandle meshId = CreateMesh(vertices, indices);
     
     Material cityMaterial;
     cityMaterial.albedo = Vector4(0.7f, 0.7f, 0.8f, 1.0f);
     cityMaterial.metallic = 0.3f;
     cityMaterial.roughness = 0.6f;
-    uint32_t materialId = CreateMaterial(cityMaterial);
+    MaterialHandle materialId = CreateMaterial(cityMaterial);
     
-    return CreateRenderObject(meshId, materialId, Matrix4());
+    return CreateRenderObject(meshId, materialId, position);
 }
 
-uint32_t DaisyRender::GenerateProceduralShip(const Vector3& position, float size) {
+RenderObjectHandle DaisyRender::GenerateProceduralShip(const DVector3& position, float size) {
     std::vector<Vertex> vertices;
     std::vector<uint32_t> indices;
     
@@ -298,7 +310,7 @@ uint32_t DaisyRender::GenerateProceduralShip(const Vector3& position, float size
             pos.y = radius * std::sin(angle);
             pos.z = -length * 0.5f + length * t;
             
-            vertices.push_back({pos + position, pos.Normalized(), {t, static_cast<float>(j)/segments}});
+            vertices.push_back({pos, pos.Normalized(), {t, static_cast<float>(j)/segments}});
         }
     }
     
@@ -320,15 +332,15 @@ uint32_t DaisyRender::GenerateProceduralShip(const Vector3& position, float size
         }
     }
     
-    uint32_t meshId = CreateMesh(vertices, indices);
+    MeshHandle meshId = CreateMesh(vertices, indices);
     
     Material shipMaterial;
     shipMaterial.albedo = Vector4(0.8f, 0.8f, 0.9f, 1.0f);
     shipMaterial.metallic = 0.8f;
     shipMaterial.roughness = 0.2f;
-    uint32_t materialId = CreateMaterial(shipMaterial);
+    MaterialHandle materialId = CreateMaterial(shipMaterial);
     
-    return CreateRenderObject(meshId, materialId, Matrix4());
+    return CreateRenderObject(meshId, materialId, position);
 }
 
 bool DaisyRender::CreateVulkanInstance() {
@@ -371,20 +383,38 @@ void DaisyRender::RecreateSwapchain() {
     // Swapchain recreation implementation would be here
 }
 
+void DaisyRender::UpdateRenderTransforms() {
+    for (auto& obj : m_renderObjects) {
+        // Subtract in double first; the difference is small wherever precision matters
+        Vector3 offset = (obj.position - m_camera.position).ToVector3();
+        obj.renderTransform = obj.transform;
+        obj.renderTransform.m[12] += offset.x;
+        obj.renderTransform.m[13] += offset.y;
+        obj.renderTransform.m[14] += offset.z;
+    }
+}
+
 void DaisyRender::UpdateLOD() {
     if (!m_lodEnabled) return;
     
-    for (auto& [id, obj] : m_renderObjects) {
-        Vector3 objPosition = Vector3(obj.transform.m[12], obj.transform.m[13], obj.transform.m[14]);
-        float distance = (objPosition - m_camera.position).Length();
-        obj.lodDistance = distance;
+    std::span<RenderObject> objects = m_renderObjects.Values();
+    
+    // Gather camera-relative translations so every distance is computed in one batch
+    Vector3Array positions(GetFrameResource());
+    positions.Resize(objects.size());
+    for (size_t i = 0; i < objects.size(); ++i) {
+        const Matrix4& transform = objects[i].renderTransform;
+        positions.Set(i, Vector3(transform.m[12], transform.m[13], transform.m[14]));
+    }
+    
+    std::pmr::vector<float> distances(objects.size(), GetFrameResource());
+    Simd::Distances(positions.GetStream(), Vector3(0, 0, 0), distances.data(), objects.size());
+    
+    for (size_t i = 0; i < objects.size(); ++i) {
+        objects[i].lodDistance = distances[i];
         
         // Adjust rendering detail based on distance
-        if (distance > m_lodDistanceHigh) {
-            obj.visible = false;
-        } else {
-            obj.visible = true;
-        }
+        objects[i].visible = distances[i] <= m_lodDistanceHigh;
     }
 }
 
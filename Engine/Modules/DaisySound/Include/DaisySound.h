@@ -2,6 +2,7 @@
 
 #include "Core/Module.h"
 #include "Core/Math.h"
+#include "Core/SlotMap.h"
 #include <vector>
 #include <memory>
 #include <unordered_map>
@@ -9,6 +10,15 @@
 
 namespace Daisy {
 
+struct SoundClip {
+    std::vector<uint8_t> data;
+};
+
+using SoundHandle = Handle<SoundClip>;
+
+struct AudioSource;
+using AudioSourceHandle = Handle<AudioSource>;
+
 struct AudioSource {
     Vector3 position{0, 0, 0};
     Vector3 velocity{0, 0, 0};
@@ -18,7 +28,7 @@ struct AudioSource {
     bool looping = false;
     bool playing = false;
     bool is3D = true;
-    uint32_t soundId = 0;
+    SoundHandle soundId;
 };
 
 struct AudioListener {
@@ -44,17 +54,20 @@ public:
     void Update(float deltaTime) override;
     void Shutdown() override;
     
-    uint32_t LoadSound(const std::string& filepath);
-    void UnloadSound(uint32_t soundId);
+    SoundHandle LoadSound(const std::string& filepath);
+    void UnloadSound(SoundHandle soundId);
     
-    uint32_t CreateAudioSource();
-    void DestroyAudioSource(uint32_t sourceId);
-    AudioSource* GetAudioSource(uint32_t sourceId);
+    AudioSourceHandle CreateAudioSource();
+    void DestroyAudioSource(AudioSourceHandle sourceId);
+    // Valid until the next CreateAudioSource or DestroyAudioSource
+    AudioSource* GetAudioSource(AudioSourceHandle sourceId);
     
-    void PlaySound(uint32_t sourceId, uint32_t soundId);
-    void StopSound(uint32_t sourceId);
-    void PauseSound(uint32_t sourceId);
+    void PlaySound(AudioSourceHandle sourceId, SoundHandle soundId);
+    void StopSound(AudioSourceHandle sourceId);
+    void PauseSound(AudioSourceHandle sourceId);
     
+    // Listener and source positions are local to the engine's floating origin
+    // and are shifted whenever it rebases
     void SetListener(const AudioListener& listener) { m_listener = listener; }
     AudioListener& GetListener() { return m_listener; }
     
@@ -68,20 +81,20 @@ private:
     void UpdateSpatialAudio();
     void UpdateDopplerEffect();
     void ProcessVoiceChat();
-    float CalculateAttenuation(const Vector3& sourcePos, const Vector3& listenerPos, float range);
+    float CalculateAttenuation(float distance, float range);
+    void OnOriginRebased(const DVector3& previous, const DVector3& current);
     
-    std::unordered_map<uint32_t, std::vector<uint8_t>> m_sounds;
-    std::unordered_map<uint32_t, std::unique_ptr<AudioSource>> m_audioSources;
+    SlotMap<SoundClip> m_sounds;
+    SlotMap<AudioSource> m_audioSources;
     
     AudioListener m_listener;
     EnvironmentSettings m_environment;
     
-    uint32_t m_nextSoundId = 1;
-    uint32_t m_nextSourceId = 1;
-    
     float m_masterVolume = 1.0f;
     bool m_dopplerEnabled = true;
     bool m_voiceChatEnabled = false;
+    
+    uint32_t m_rebaseListener = 0;
 };
 
 }
\ No newline at end of file
@@ -1,20 +1,31 @@
 #include "DaisySound.h"
+#include "Core/Engine.h"
 #include "Core/Logger.h"
+#include "Core/SimdMath.h"
 #include <algorithm>
 
 namespace Daisy {
 
-DaisySound::DaisySound() : Module("DaisySound") {
+DaisySound::DaisySound()
+    : Module("DaisySound")
+    , m_sounds(&GetMemoryResource())
+    , m_audioSources(&GetMemoryResource()) {
+    SetThreading(ModuleThreading::Worker);
 }
 
 bool DaisySound::Initialize() {
-    DAISY_INFO("Initializing Daisy Sound Engine");
+    DAISY_CHANNEL_INFO(Audio, "Initializing Daisy Sound Engine");
     
-    m_sounds.reserve(1000);
-    m_audioSources.reserve(1000);
+    m_sounds.Reserve(1000);
+    m_audioSources.Reserve(1000);
+    
+    if (Engine* engine = GetEngine()) {
+        m_rebaseListener = engine->GetFloatingOrigin().AddRebaseListener(
+            [this](const DVector3& previous, const DVector3& current) { OnOriginRebased(previous, current); });
+    }
     
     m_initialized = true;
-    DAISY_INFO("Daisy Sound Engine initialized successfully");
+    DAISY_CHANNEL_INFO(Audio, "Daisy Sound Engine initialized successfully");
     return true;
 }
 
@@ -33,66 +44,63 @@ void DaisySound::Update(float deltaTime) {
 void DaisySound::Shutdown() {
     if (!m_initialized) return;
     
-    DAISY_INFO("Shutting down Daisy Sound Engine");
+    DAISY_CHANNEL_INFO(Audio, "Shutting down Daisy Sound Engine");
     
-    for (auto& [id, source] : m_audioSources) {
-        if (source->playing) {
-            StopSound(id);
+    if (Engine* engine = GetEngine()) {
+        engine->GetFloatingOrigin().RemoveRebaseListener(m_rebaseListener);
+    }
+    
+    for (size_t i = 0; i < m_audioSources.Size(); ++i) {
+        if (m_audioSources.Values()[i].playing) {
+            StopSound(m_audioSources.GetHandle(i));
         }
     }
     
-    m_sounds.clear();
-    m_audioSources.clear();
+    m_sounds.Clear();
+    m_audioSources.Clear();
     
     m_initialized = false;
-    DAISY_INFO("Daisy Sound Engine shut down successfully");
+    DAISY_CHANNEL_INFO(Audio, "Daisy Sound Engine shut down successfully");
 }
 
-uint32_t DaisySound::LoadSound(const std::string& filepath) {
-    uint32_t id = m_nextSoundId++;
-    
+SoundHandle DaisySound::LoadSound(const std::string& filepath) {
     // Sound loading implementation would be here
-    std::vector<uint8_t> soundData;
-    m_sounds[id] = std::move(soundData);
-    
-    return id;
+    SoundClip clip;
+    return m_sounds.Insert(std::move(clip));
 }
 
-void DaisySound::UnloadSound(uint32_t soundId) {
-    m_sounds.erase(soundId);
+void DaisySound::UnloadSound(SoundHandle soundId) {
+    m_sounds.Erase(soundId);
 }
 
-uint32_t DaisySound::CreateAudioSource() {
-    uint32_t id = m_nextSourceId++;
-    m_audioSources[id] = std::make_unique<AudioSource>();
-    return id;
+AudioSourceHandle DaisySound::CreateAudioSource() {
+    return m_audioSources.Insert();
 }
 
-void DaisySound::DestroyAudioSource(uint32_t sourceId) {
-    auto it = m_audioSources.find(sourceId);
-    if (it != m_audioSources.end()) {
-        if (it->second->playing) {
+void DaisySound::DestroyAudioSource(AudioSourceHandle sourceId) {
+    auto* source = GetAudioSource(sourceId);
+    if (source) {
+        if (source->playing) {
             StopSound(sourceId);
         }
-        m_audioSources.erase(it);
+        m_audioSources.Erase(sourceId);
     }
 }
 
-AudioSource* DaisySound::GetAudioSource(uint32_t sourceId) {
-    auto it = m_audioSources.find(sourceId);
-    return it != m_audioSources.end() ? it->second.get() : nullptr;
+AudioSource* DaisySound::GetAudioSource(AudioSourceHandle sourceId) {
+    return m_audioSources.Get(sourceId);
 }
 
-void DaisySound::PlaySound(uint32_t sourceId, uint32_t soundId) {
+void DaisySound::PlaySound(AudioSourceHandle sourceId, SoundHandle soundId) {
     auto* source = GetAudioSource(sourceId);
-    if (source && m_sounds.find(soundId) != m_sounds.end()) {
+    if (source && m_sounds.Contains(soundId)) {
         source->soundId = soundId;
         source->playing = true;
         // Audio playback implementation would be here
     }
 }
 
-void DaisySound::StopSound(uint32_t sourceId) {
+void DaisySound::StopSound(AudioSourceHandle sourceId) {
     auto* source = GetAudioSource(sourceId);
     if (source) {
         source->playing = false;
@@ -100,7 +108,7 @@ void DaisySound::StopSound(uint32_t sourceId) {
     }
 }
 
-void DaisySound::PauseSound(uint32_t sourceId) {
+void DaisySound::PauseSound(AudioSourceHandle sourceId) {
     auto* source = GetAudioSource(sourceId);
     if (source && source->playing) {
         // Pause audio playback implementation would be here
@@ -108,28 +116,41 @@ void DaisySound::PauseSound(uint32_t sourceId) {
 }
 
 void DaisySound::UpdateSpatialAudio() {
-    for (auto& [id, source] : m_audioSources) {
-        if (!source->playing || !source->is3D) continue;
+    std::span<const AudioSource> sources = m_audioSources.Values();
+    
+    // Listener distances for every source in one batch; cheaper than filtering first
+    Vector3Array positions(GetFrameResource());
+    positions.Resize(sources.size());
+    for (size_t i = 0; i < sources.size(); ++i) {
+        positions.Set(i, sources[i].position);
+    }
+    
+    std::pmr::vector<float> distances(sources.size(), GetFrameResource());
+    Simd::Distances(positions.GetStream(), m_listener.position, distances.data(), sources.size());
+    
+    for (size_t i = 0; i < sources.size(); ++i) {
+        const AudioSource& source = sources[i];
+        if (!source.playing || !source.is3D) continue;
         
-        float attenuation = CalculateAttenuation(source->position, m_listener.position, source->range);
-        float finalVolume = source->volume * attenuation * m_masterVolume;
+        float attenuation = CalculateAttenuation(distances[i], source.range);
+        float finalVolume = source.volume * attenuation * m_masterVolume;
         
         // Apply 3D positioning to audio source
     }
 }
 
 void DaisySound::UpdateDopplerEffect() {
-    for (auto& [id, source] : m_audioSources) {
-        if (!source->playing || !source->is3D) continue;
+    for (const auto& source : m_audioSources) {
+        if (!source.playing || !source.is3D) continue;
         
-        Vector3 relativeVelocity = source->velocity - m_listener.velocity;
-        Vector3 direction = (source->position - m_listener.position).Normalized();
+        Vector3 relativeVelocity = source.velocity - m_listener.velocity;
+        Vector3 direction = (source.position - m_listener.position).Normalized();
         float velocityComponent = relativeVelocity.Dot(direction);
         
         const float speedOfSound = 343.0f; // m/s
         float dopplerFactor = speedOfSound / (speedOfSound - velocityComponent);
         
-        float adjustedPitch = source->pitch * dopplerFactor;
+        float adjustedPitch = source.pitch * dopplerFactor;
         // Apply pitch adjustment to audio source
     }
 }
@@ -138,12 +159,18 @@ void DaisySound::ProcessVoiceChat() {
     // Voice chat processing implementation would be here
 }
 
-float DaisySound::CalculateAttenuation(const Vector3& sourcePos, const Vector3& listenerPos, float range) {
-    float distance = (sourcePos - listenerPos).Length();
+float DaisySound::CalculateAttenuation(float distance, float range) {
     if (distance >= range) return 0.0f;
     
     // Linear attenuation
     return 1.0f - (distance / range);
 }
 
+void DaisySound::OnOriginRebased(const DVector3& previous, const DVector3& current) {
+    m_listener.position = FloatingOrigin::Rebase(m_listener.position, previous, current);
+    for (auto& source : m_audioSources) {
+        source.position = FloatingOrigin::Rebase(source.position, previous, current);
+    }
+}
+
 }
\ No newline at end of file
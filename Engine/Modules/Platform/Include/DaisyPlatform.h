@@ -9,7 +9,7 @@ namespace Daisy {
 
 class DaisyPlatform : public Module {
 public:
-    DaisyPlatform() : Module("DaisyPlatform") {}
+    DaisyPlatform() : Module("DaisyPlatform") { SetThreading(ModuleThreading::MainThread); }
     virtual ~DaisyPlatform() = default;
     
     bool Initialize() override;
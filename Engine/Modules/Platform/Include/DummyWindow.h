@@ -19,12 +19,12 @@ public:
         m_data.height = props.height;
         m_data.vsync = props.vsync;
         
-        DAISY_INFO("Created dummy window: {} ({}x{})", m_data.title, m_data.width, m_data.height);
+        DAISY_CHANNEL_INFO(Platform, "Created dummy window: {} ({}x{})", m_data.title, m_data.width, m_data.height);
         return true;
     }
     
     void Shutdown() override {
-        DAISY_INFO("Shut down dummy window");
+        DAISY_CHANNEL_INFO(Platform, "Shut down dummy window");
     }
     
     void Update() override {
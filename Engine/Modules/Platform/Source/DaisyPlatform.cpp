@@ -19,7 +19,7 @@ Window* Window::Create(const WindowProperties& props) {
 }
 
 bool DaisyPlatform::Initialize() {
-    DAISY_INFO("Initializing Platform module...");
+    DAISY_CHANNEL_INFO(Platform, "Initializing Platform module...");
     
     // Create main window
     WindowProperties props;
@@ -29,17 +29,17 @@ bool DaisyPlatform::Initialize() {
     
     m_mainWindow.reset(Window::Create(props));
     if (!m_mainWindow) {
-        DAISY_ERROR("Failed to create main window");
+        DAISY_CHANNEL_ERROR(Platform, "Failed to create main window");
         return false;
     }
     
     if (!m_mainWindow->Initialize(props)) {
-        DAISY_ERROR("Failed to initialize main window");
+        DAISY_CHANNEL_ERROR(Platform, "Failed to initialize main window");
         m_mainWindow.reset();
         return false;
     }
     
-    DAISY_INFO("Platform module initialized successfully");
+    DAISY_CHANNEL_INFO(Platform, "Platform module initialized successfully");
     return true;
 }
 
@@ -58,25 +58,25 @@ void DaisyPlatform::Update(float deltaTime) {
 }
 
 void DaisyPlatform::Shutdown() {
-    DAISY_INFO("Shutting down Platform module...");
+    DAISY_CHANNEL_INFO(Platform, "Shutting down Platform module...");
     
     m_windows.clear();
     m_mainWindow.reset();
     
-    DAISY_INFO("Platform module shut down successfully");
+    DAISY_CHANNEL_INFO(Platform, "Platform module shut down successfully");
 }
 
 Window* DaisyPlatform::CreateEngineWindow(const WindowProperties& props) {
     auto window = std::unique_ptr<Window>(Window::Create(props));
     if (!window || !window->Initialize(props)) {
-        DAISY_ERROR("Failed to create window: {}", props.title);
+        DAISY_CHANNEL_ERROR(Platform, "Failed to create window: {}", props.title);
         return nullptr;
     }
     
     Window* windowPtr = window.get();
     m_windows.push_back(std::move(window));
     
-    DAISY_INFO("Created window: {}", props.title);
+    DAISY_CHANNEL_INFO(Platform, "Created window: {}", props.title);
     return windowPtr;
 }
 
@@ -88,7 +88,7 @@ void DaisyPlatform::DestroyEngineWindow(Window* window) {
     
     if (it != m_windows.end()) {
         m_windows.erase(it);
-        DAISY_INFO("Destroyed window");
+        DAISY_CHANNEL_INFO(Platform, "Destroyed window");
     }
 }
 
@@ -32,7 +32,7 @@ bool WindowsWindow::Initialize(const WindowProperties& props) {
         wc.hIconSm = LoadIcon(nullptr, IDI_APPLICATION);
         
         if (!RegisterClassExA(&wc)) {
-            DAISY_ERROR("Failed to register window class");
+            DAISY_CHANNEL_ERROR(Platform, "Failed to register window class");
             return false;
         }
         s_classRegistered = true;
@@ -61,7 +61,7 @@ bool WindowsWindow::Initialize(const WindowProperties& props) {
     );
     
     if (!m_hwnd) {
-        DAISY_ERROR("Failed to create window");
+        DAISY_CHANNEL_ERROR(Platform, "Failed to create window");
         return false;
     }
     
@@ -69,7 +69,7 @@ bool WindowsWindow::Initialize(const WindowProperties& props) {
     ShowWindow(m_hwnd, SW_SHOW);
     UpdateWindow(m_hwnd);
     
-    DAISY_INFO("Created Windows window: {} ({}x{})", m_data.title, m_data.width, m_data.height);
+    DAISY_CHANNEL_INFO(Platform, "Created Windows window: {} ({}x{})", m_data.title, m_data.width, m_data.height);
     return true;
 }
 
@@ -48,7 +48,7 @@ ScriptSystem::ScriptSystem() : Module("ScriptSystem") {
 }
 
 bool ScriptSystem::Initialize() {
-    DAISY_INFO("Initializing Script System");
+    DAISY_CHANNEL_INFO(Script, "Initializing Script System");
     
     // Register built-in functions
     RegisterFunction("log", [](ScriptContext& ctx) {
@@ -64,7 +64,7 @@ bool ScriptSystem::Initialize() {
     }
     
     m_initialized = true;
-    DAISY_INFO("Script System initialized successfully");
+    DAISY_CHANNEL_INFO(Script, "Script System initialized successfully");
     return true;
 }
 
@@ -85,7 +85,7 @@ void ScriptSystem::Update(float deltaTime) {
 void ScriptSystem::Shutdown() {
     if (!m_initialized) return;
     
-    DAISY_INFO("Shutting down Script System");
+    DAISY_CHANNEL_INFO(Script, "Shutting down Script System");
     
     m_scripts.clear();
     m_functions.clear();
@@ -93,13 +93,13 @@ void ScriptSystem::Shutdown() {
     m_scriptsToExecute.clear();
     
     m_initialized = false;
-    DAISY_INFO("Script System shut down successfully");
+    DAISY_CHANNEL_INFO(Script, "Script System shut down successfully");
 }
 
 bool ScriptSystem::LoadScript(const std::string& name, const std::string& filepath) {
     std::ifstream file(filepath);
     if (!file.is_open()) {
-        DAISY_ERROR("Failed to open script file: {}", filepath);
+        DAISY_CHANNEL_ERROR(Script, "Failed to open script file: {}", filepath);
         return false;
     }
     
@@ -113,12 +113,12 @@ bool ScriptSystem::LoadScriptFromString(const std::string& name, const std::stri
     auto script = std::make_unique<DaisyScript>(name);
     
     if (!script->Load(source)) {
-        DAISY_ERROR("Failed to load script: {}", name);
+        DAISY_CHANNEL_ERROR(Script, "Failed to load script: {}", name);
         return false;
     }
     
     m_scripts[name] = std::move(script);
-    DAISY_INFO("Loaded script: {}", name);
+    DAISY_CHANNEL_INFO(Script, "Loaded script: {}", name);
     return true;
 }
 
@@ -126,14 +126,14 @@ void ScriptSystem::UnloadScript(const std::string& name) {
     auto it = m_scripts.find(name);
     if (it != m_scripts.end()) {
         m_scripts.erase(it);
-        DAISY_INFO("Unloaded script: {}", name);
+        DAISY_CHANNEL_INFO(Script, "Unloaded script: {}", name);
     }
 }
 
 bool ScriptSystem::ExecuteScript(const std::string& name, ScriptContext& context) {
     auto it = m_scripts.find(name);
     if (it == m_scripts.end()) {
-        DAISY_WARNING("Script not found: {}", name);
+        DAISY_CHANNEL_WARNING(Script, "Script not found: {}", name);
         return false;
     }
     
@@ -150,7 +150,7 @@ void ScriptSystem::ExecuteAllScripts(ScriptContext& context) {
 
 void ScriptSystem::RegisterFunction(const std::string& name, std::function<void(ScriptContext&)> func) {
     m_functions[name] = func;
-    DAISY_DEBUG("Registered script function: {}", name);
+    DAISY_CHANNEL_DEBUG(Script, "Registered script function: {}", name);
 }
 
 void ScriptSystem::SetGlobalVariable(const std::string& name, const std::string& value) {
@@ -175,13 +175,13 @@ void ScriptSystem::TriggerEvent(const std::string& eventName, ScriptContext& con
 
 void ScriptSystem::RegisterEventHandler(const std::string& eventName, const std::string& scriptName) {
     m_eventHandlers[eventName].push_back(scriptName);
-    DAISY_DEBUG("Registered event handler for '{}': {}", eventName, scriptName);
+    DAISY_CHANNEL_DEBUG(Script, "Registered event handler for '{}': {}", eventName, scriptName);
 }
 
 void ScriptSystem::LoadModScripts() {
     // Load scripts from mod directories
     // Implementation would scan mod directories and load scripts
-    DAISY_INFO("Loading mod scripts from: {}", m_scriptDirectory);
+    DAISY_CHANNEL_INFO(Script, "Loading mod scripts from: {}", m_scriptDirectory);
 }
 
 void ScriptSystem::ExecuteEventHandlers(const std::string& eventName, ScriptContext& context) {
@@ -5,17 +5,48 @@
 #include <unordered_map>
 #include <vector>
 #include <memory>
+#include <memory_resource>
 
 namespace Daisy {
 
+// Integer chunk coordinates; 64 bits per axis reach further than a double can resolve
+struct ChunkKey {
+    int64_t x = 0;
+    int64_t y = 0;
+    int64_t z = 0;
+    
+    bool operator==(const ChunkKey& other) const = default;
+};
+
+}
+
+template<>
+struct std::hash<Daisy::ChunkKey> {
+    size_t operator()(const Daisy::ChunkKey& key) const noexcept {
+        uint64_t hash = static_cast<uint64_t>(key.x) * 0x9E3779B97F4A7C15ull;
+        hash ^= static_cast<uint64_t>(key.y) * 0xC2B2AE3D27D4EB4Full + (hash << 6) + (hash >> 2);
+        hash ^= static_cast<uint64_t>(key.z) * 0x165667B19E3779F9ull + (hash << 6) + (hash >> 2);
+        return static_cast<size_t>(hash);
+    }
+};
+
+namespace Daisy {
+
+// Allocator-aware, so a chunk's object lists live in the streamer's memory resource
 struct WorldChunk {
-    Vector3 position;
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+    
+    WorldChunk() = default;
+    explicit WorldChunk(const allocator_type& allocator)
+        : renderObjects(allocator), physicsObjects(allocator), aiAgents(allocator) {}
+        
+    DVector3 position;      // Minimum corner in world space
     uint32_t size = 1000;
     bool loaded = false;
     bool generated = false;
-    std::vector<uint32_t> renderObjects;
-    std::vector<uint32_t> physicsObjects;
-    std::vector<uint32_t> aiAgents;
+    std::pmr::vector<uint32_t> renderObjects;
+    std::pmr::vector<uint32_t> physicsObjects;
+    std::pmr::vector<uint32_t> aiAgents;
     float lastAccessTime = 0.0f;
 };
 
@@ -26,6 +57,7 @@ struct StreamingSettings {
     int maxConcurrentLoads = 4;
     bool enablePredictiveStreaming = true;
     bool enableServerSideStreaming = true;
+    MemoryBudget memoryBudget;      // Chunks are evicted, farthest first, while over the soft limit
 };
 
 class WorldStreamer : public Module {
@@ -37,31 +69,38 @@ public:
     void Update(float deltaTime) override;
     void Shutdown() override;
     
-    void SetObserverPosition(const Vector3& position);
+    void SetObserverPosition(const DVector3& position);
     void SetStreamingSettings(const StreamingSettings& settings);
     
-    WorldChunk* GetChunk(const Vector3& worldPosition);
-    std::vector<WorldChunk*> GetLoadedChunks();
+    WorldChunk* GetChunk(const DVector3& worldPosition);
+    // Heap allocated by default; callers that only need the list this frame
+    // should pass GetFrameResource() or the engine's frame arena
+    std::pmr::vector<WorldChunk*> GetLoadedChunks(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
     
     void GenerateChunk(WorldChunk& chunk);
-    void LoadChunk(const Vector3& chunkPosition);
-    void UnloadChunk(const Vector3& chunkPosition);
+    // Any position inside the chunk selects it
+    void LoadChunk(const DVector3& chunkPosition);
+    void UnloadChunk(const DVector3& chunkPosition);
     
     void EnableInfiniteWorld(bool enable) { m_infiniteWorldEnabled = enable; }
     void SetWorldScale(double scale) { m_worldScale = scale; }
     
+    static constexpr double ChunkSize = 1000.0;
+    
 private:
-    Vector3 WorldToChunkPosition(const Vector3& worldPos);
-    uint64_t ChunkPositionToKey(const Vector3& chunkPos);
-    Vector3 KeyToChunkPosition(uint64_t key);
+    ChunkKey WorldToChunkKey(const DVector3& worldPos) const;
+    DVector3 ChunkKeyToPosition(const ChunkKey& key) const;
     
     void UpdateStreaming();
     void PredictiveLoading();
     void CleanupUnusedChunks();
     
-    std::unordered_map<uint64_t, std::unique_ptr<WorldChunk>> m_chunks;
-    Vector3 m_observerPosition{0, 0, 0};
-    Vector3 m_lastObserverPosition{0, 0, 0};
+    void UnloadChunkByKey(const ChunkKey& key);
+    void EvictForMemoryPressure();
+    
+    std::pmr::unordered_map<ChunkKey, ResourceUniquePtr<WorldChunk>> m_chunks;
+    DVector3 m_observerPosition{0, 0, 0};
+    DVector3 m_lastObserverPosition{0, 0, 0};
     
     StreamingSettings m_settings;
     
@@ -69,10 +108,14 @@ private:
     double m_worldScale = 1e12; // Observable universe scale
     
     float m_streamingUpdateTimer = 0.0f;
-    std::vector<Vector3> m_chunksToLoad;
-    std::vector<Vector3> m_chunksToUnload;
+    std::vector<DVector3> m_chunksToLoad;
+    std::vector<DVector3> m_chunksToUnload;
     
     int m_currentLoadingJobs = 0;
+    
+    // Set from the budget listener, which may run inside a container operation
+    std::atomic<bool> m_memoryPressure{false};
+    uint32_t m_budgetListener = 0;
 };
 
 }
\ No newline at end of file
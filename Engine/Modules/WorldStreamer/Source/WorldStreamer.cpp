@@ -1,24 +1,35 @@
 #include "WorldStreamer.h"
 #include "Core/Logger.h"
+#include <algorithm>
 
 namespace Daisy {
 
-WorldStreamer::WorldStreamer() : Module("WorldStreamer") {
+WorldStreamer::WorldStreamer() : Module("WorldStreamer"), m_chunks(&GetMemoryResource()) {
+    SetThreading(ModuleThreading::Worker);
 }
 
 bool WorldStreamer::Initialize() {
-    DAISY_INFO("Initializing World Streamer");
+    DAISY_CHANNEL_INFO(Streamer, "Initializing World Streamer");
     
     m_chunks.reserve(10000);
     
+    GetMemoryResource().SetBudget(m_settings.memoryBudget);
+    m_budgetListener = GetMemoryResource().AddListener([this](MemoryBudgetResource&, MemoryBudgetEvent) {
+        m_memoryPressure.store(true, std::memory_order_relaxed);
+    });
+    
     m_initialized = true;
-    DAISY_INFO("World Streamer initialized successfully");
+    DAISY_CHANNEL_INFO(Streamer, "World Streamer initialized successfully");
     return true;
 }
 
 void WorldStreamer::Update(float deltaTime) {
     if (!m_initialized) return;
     
+    if (m_memoryPressure.exchange(false, std::memory_order_relaxed) || GetMemoryResource().IsOverSoftLimit()) {
+        EvictForMemoryPressure();
+    }
+    
     m_streamingUpdateTimer += deltaTime;
     
     if (m_streamingUpdateTimer >= 0.1f) { // Update 10 times per second
@@ -36,35 +47,35 @@ void WorldStreamer::Update(float deltaTime) {
 void WorldStreamer::Shutdown() {
     if (!m_initialized) return;
     
-    DAISY_INFO("Shutting down World Streamer");
+    DAISY_CHANNEL_INFO(Streamer, "Shutting down World Streamer");
     
+    GetMemoryResource().RemoveListener(m_budgetListener);
     m_chunks.clear();
     m_chunksToLoad.clear();
     m_chunksToUnload.clear();
     
     m_initialized = false;
-    DAISY_INFO("World Streamer shut down successfully");
+    DAISY_CHANNEL_INFO(Streamer, "World Streamer shut down successfully");
 }
 
-void WorldStreamer::SetObserverPosition(const Vector3& position) {
+void WorldStreamer::SetObserverPosition(const DVector3& position) {
     m_lastObserverPosition = m_observerPosition;
     m_observerPosition = position;
 }
 
 void WorldStreamer::SetStreamingSettings(const StreamingSettings& settings) {
     m_settings = settings;
+    GetMemoryResource().SetBudget(settings.memoryBudget);
 }
 
-WorldChunk* WorldStreamer::GetChunk(const Vector3& worldPosition) {
-    Vector3 chunkPos = WorldToChunkPosition(worldPosition);
-    uint64_t key = ChunkPositionToKey(chunkPos);
-    
-    auto it = m_chunks.find(key);
+WorldChunk* WorldStreamer::GetChunk(const DVector3& worldPosition) {
+    auto it = m_chunks.find(WorldToChunkKey(worldPosition));
     return it != m_chunks.end() ? it->second.get() : nullptr;
 }
 
-std::vector<WorldChunk*> WorldStreamer::GetLoadedChunks() {
-    std::vector<WorldChunk*> loadedChunks;
+std::pmr::vector<WorldChunk*> WorldStreamer::GetLoadedChunks(std::pmr::memory_resource* resource) {
+    std::pmr::vector<WorldChunk*> loadedChunks(resource);
+    loadedChunks.reserve(m_chunks.size());
     
     for (auto& [key, chunk] : m_chunks) {
         if (chunk->loaded) {
@@ -82,23 +93,28 @@ void WorldStreamer::GenerateChunk(WorldChunk& chunk) {
     // This would involve calling render, physics, and AI modules
     
     chunk.generated = true;
-    DAISY_DEBUG("Generated chunk at ({}, {}, {})", chunk.position.x, chunk.position.y, chunk.position.z);
+    DAISY_CHANNEL_DEBUG(Streamer, "Generated chunk at ({}, {}, {})", chunk.position.x, chunk.position.y, chunk.position.z);
 }
 
-void WorldStreamer::LoadChunk(const Vector3& chunkPosition) {
-    uint64_t key = ChunkPositionToKey(chunkPosition);
+void WorldStreamer::LoadChunk(const DVector3& chunkPosition) {
+    ChunkKey key = WorldToChunkKey(chunkPosition);
     
     if (m_chunks.find(key) != m_chunks.end()) {
         return; // Already loaded or loading
     }
     
+    // Loading more would only trigger another eviction
+    if (GetMemoryResource().IsOverSoftLimit()) {
+        return;
+    }
+    
     if (m_currentLoadingJobs >= m_settings.maxConcurrentLoads) {
         m_chunksToLoad.push_back(chunkPosition);
         return;
     }
     
-    auto chunk = std::make_unique<WorldChunk>();
-    chunk->position = chunkPosition;
+    auto chunk = MakeUniqueIn<WorldChunk>(&GetMemoryResource());
+    chunk->position = ChunkKeyToPosition(key);
     chunk->loaded = false;
     
     GenerateChunk(*chunk);
@@ -108,57 +124,47 @@ void WorldStreamer::LoadChunk(const Vector3& chunkPosition) {
     m_chunks[key] = std::move(chunk);
     m_currentLoadingJobs++;
     
-    DAISY_DEBUG("Loaded chunk at ({}, {}, {})", chunkPosition.x, chunkPosition.y, chunkPosition.z);
+    DAISY_CHANNEL_DEBUG(Streamer, "Loaded chunk ({}, {}, {})", key.x, key.y, key.z);
+}
+
+void WorldStreamer::UnloadChunk(const DVector3& chunkPosition) {
+    UnloadChunkByKey(WorldToChunkKey(chunkPosition));
 }
 
-void WorldStreamer::UnloadChunk(const Vector3& chunkPosition) {
-    uint64_t key = ChunkPositionToKey(chunkPosition);
+void WorldStreamer::UnloadChunkByKey(const ChunkKey& key) {
     auto it = m_chunks.find(key);
     
     if (it != m_chunks.end()) {
-        DAISY_DEBUG("Unloaded chunk at ({}, {}, {})", chunkPosition.x, chunkPosition.y, chunkPosition.z);
+        const DVector3& chunkPosition = it->second->position;
+        DAISY_CHANNEL_DEBUG(Streamer, "Unloaded chunk at ({}, {}, {})", chunkPosition.x, chunkPosition.y, chunkPosition.z);
         m_chunks.erase(it);
         m_currentLoadingJobs = std::max(0, m_currentLoadingJobs - 1);
     }
 }
 
-Vector3 WorldStreamer::WorldToChunkPosition(const Vector3& worldPos) {
-    float chunkSize = 1000.0f; // Configurable chunk size
-    return Vector3(
-        std::floor(worldPos.x / chunkSize) * chunkSize,
-        std::floor(worldPos.y / chunkSize) * chunkSize,
-        std::floor(worldPos.z / chunkSize) * chunkSize
-    );
+ChunkKey WorldStreamer::WorldToChunkKey(const DVector3& worldPos) const {
+    return ChunkKey{
+        static_cast<int64_t>(std::floor(worldPos.x / ChunkSize)),
+        static_cast<int64_t>(std::floor(worldPos.y / ChunkSize)),
+        static_cast<int64_t>(std::floor(worldPos.z / ChunkSize))
+    };
 }
 
-uint64_t WorldStreamer::ChunkPositionToKey(const Vector3& chunkPos) {
-    // Simple hash function for chunk position
-    uint64_t x = static_cast<uint64_t>(chunkPos.x / 1000.0f) + 1000000;
-    uint64_t y = static_cast<uint64_t>(chunkPos.y / 1000.0f) + 1000000;
-    uint64_t z = static_cast<uint64_t>(chunkPos.z / 1000.0f) + 1000000;
-    
-    return (x << 32) | (y << 16) | z;
-}
-
-Vector3 WorldStreamer::KeyToChunkPosition(uint64_t key) {
-    uint64_t x = ((key >> 32) & 0xFFFFFFFF) - 1000000;
-    uint64_t y = ((key >> 16) & 0xFFFF) - 1000000;
-    uint64_t z = (key & 0xFFFF) - 1000000;
-    
-    return Vector3(x * 1000.0f, y * 1000.0f, z * 1000.0f);
+DVector3 WorldStreamer::ChunkKeyToPosition(const ChunkKey& key) const {
+    return DVector3(key.x * ChunkSize, key.y * ChunkSize, key.z * ChunkSize);
 }
 
 void WorldStreamer::UpdateStreaming() {
     // Load chunks within load radius
-    int chunkRadius = static_cast<int>(m_settings.loadRadius / 1000.0f);
+    int chunkRadius = static_cast<int>(m_settings.loadRadius / ChunkSize);
+    ChunkKey center = WorldToChunkKey(m_observerPosition);
     
     for (int x = -chunkRadius; x <= chunkRadius; ++x) {
         for (int y = -chunkRadius; y <= chunkRadius; ++y) {
             for (int z = -chunkRadius; z <= chunkRadius; ++z) {
-                Vector3 chunkOffset(x * 1000.0f, y * 1000.0f, z * 1000.0f);
-                Vector3 chunkPos = WorldToChunkPosition(m_observerPosition + chunkOffset);
+                DVector3 chunkPos = ChunkKeyToPosition(ChunkKey{center.x + x, center.y + y, center.z + z});
                 
-                float distance = (chunkPos - m_observerPosition).Length();
+                double distance = (chunkPos - m_observerPosition).Length();
                 
                 if (distance <= m_settings.loadRadius) {
                     LoadChunk(chunkPos);
@@ -168,37 +174,35 @@ void WorldStreamer::UpdateStreaming() {
     }
     
     // Unload chunks outside unload radius
-    std::vector<uint64_t> chunksToUnload;
+    std::pmr::vector<ChunkKey> chunksToUnload(GetFrameResource());
     
     for (auto& [key, chunk] : m_chunks) {
-        float distance = (chunk->position - m_observerPosition).Length();
+        double distance = (chunk->position - m_observerPosition).Length();
         
         if (distance > m_settings.unloadRadius) {
             chunksToUnload.push_back(key);
         }
     }
     
-    for (uint64_t key : chunksToUnload) {
-        Vector3 chunkPos = KeyToChunkPosition(key);
-        UnloadChunk(chunkPos);
+    for (const ChunkKey& key : chunksToUnload) {
+        UnloadChunkByKey(key);
     }
 }
 
 void WorldStreamer::PredictiveLoading() {
-    Vector3 velocity = m_observerPosition - m_lastObserverPosition;
+    DVector3 velocity = m_observerPosition - m_lastObserverPosition;
     
     if (velocity.LengthSquared() > 0) {
-        Vector3 predictedPosition = m_observerPosition + velocity.Normalized() * m_settings.predictionRadius;
+        DVector3 predictedPosition = m_observerPosition + velocity.Normalized() * m_settings.predictionRadius;
         
-        // Load chunks around predicted position
-        Vector3 predictedChunk = WorldToChunkPosition(predictedPosition);
-        LoadChunk(predictedChunk);
+        // Load the chunk around predicted position
+        LoadChunk(predictedPosition);
     }
 }
 
 void WorldStreamer::CleanupUnusedChunks() {
     // Remove chunks that haven't been accessed recently
-    std::vector<uint64_t> chunksToCleanup;
+    std::pmr::vector<ChunkKey> chunksToCleanup(GetFrameResource());
     
     for (auto& [key, chunk] : m_chunks) {
         if (chunk->lastAccessTime > 300.0f) { // 5 minutes
@@ -206,9 +210,38 @@ void WorldStreamer::CleanupUnusedChunks() {
         }
     }
     
-    for (uint64_t key : chunksToCleanup) {
+    for (const ChunkKey& key : chunksToCleanup) {
         m_chunks.erase(key);
     }
 }
 
+
+void WorldStreamer::EvictForMemoryPressure() {
+    std::pmr::vector<std::pair<double, ChunkKey>> candidates(GetFrameResource());
+    candidates.reserve(m_chunks.size());
+    
+    for (auto& [key, chunk] : m_chunks) {
+        candidates.emplace_back((chunk->position - m_observerPosition).LengthSquared(), key);
+    }
+    
+    // Farthest from the observer first
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+        return a.first > b.first;
+    });
+    
+    size_t evicted = 0;
+    size_t before = GetMemoryResource().GetCurrentBytes();
+    for (const auto& candidate : candidates) {
+        if (!GetMemoryResource().IsOverSoftLimit()) {
+            break;
+        }
+        UnloadChunkByKey(candidate.second);
+        evicted++;
+    }
+    
+    if (evicted > 0) {
+        DAISY_CHANNEL_WARNING(Streamer, "Memory pressure: evicted {} chunks, {} -> {} bytes",
+            evicted, before, GetMemoryResource().GetCurrentBytes());
+    }
+}
 }
\ No newline at end of file
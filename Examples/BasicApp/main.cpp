@@ -23,6 +23,12 @@ int main() {
     
     auto* engine = DAISY_ENGINE.GetEngine();
     
+    // Step physics and AI at a stable 60 Hz independent of the frame rate
+    TimestepSettings timestep;
+    timestep.fixedTimestep = true;
+    timestep.simulationRate = 60.0f;
+    engine->SetTimestepSettings(timestep);
+    
     // Register all engine modules - Platform module must be first
     auto* platform = engine->RegisterModule<DaisyPlatform>();
     auto* renderer = engine->RegisterModule<DaisyRender>();
@@ -40,10 +46,18 @@ int main() {
     
     DAISY_INFO("All modules registered successfully");
     
-    // Create some procedural content positions
-    Daisy::Vector3 earthPos(0, 0, 0);
-    Daisy::Vector3 moonPos(384400000, 0, 0); // Moon distance from Earth
-    Daisy::Vector3 stationPos(400000, 0, 0); // ISS-like orbit
+    // Create some procedural content positions; world positions are double precision
+    Daisy::DVector3 earthPos(0, 0, 0);
+    Daisy::DVector3 moonPos(384400000, 0, 0); // Moon distance from Earth
+    Daisy::DVector3 stationPos(400000, 0, 0); // ISS-like orbit
+    
+    // Simulate a camera moving through space
+    Daisy::DVector3 cameraPos(7000000, 0, 0); // Start in low Earth orbit
+    Daisy::Vector3 cameraVelocity(0, 7800, 0); // Orbital velocity
+    
+    // Float positions (AI, sound) are kept relative to an origin that follows the camera
+    Daisy::FloatingOrigin& origin = engine->GetFloatingOrigin();
+    origin.SetOrigin(cameraPos);
     
     // Configure renderer for space simulation
     if (renderer) {
@@ -57,7 +71,7 @@ int main() {
         renderer->GenerateProceduralShip(stationPos, 100);     // Space station
         
         // Add some cities on Earth
-        renderer->GenerateProceduralCity(Daisy::Vector3(0, 6371000, 0), 1000000); // City on Earth surface
+        renderer->GenerateProceduralCity(Daisy::DVector3(0, 6371000, 0), 1000000); // City on Earth surface
     }
     
     // Configure physics for space simulation
@@ -70,7 +84,7 @@ int main() {
         physics->AddGravityWell(moonPos, 7.342e22f, 1e7f, true);  // Moon
         
         // Create some physics objects
-        uint32_t ship = physics->CreateRigidBody(Daisy::Vector3(7000000, 0, 0), 10000); // Spacecraft
+        Daisy::RigidBodyHandle ship = physics->CreateRigidBody(Daisy::DVector3(7000000, 0, 0), 10000); // Spacecraft
         physics->ApplyForce(ship, Daisy::Vector3(0, 1000, 0)); // Thrust
     }
     
@@ -82,13 +96,13 @@ int main() {
         
         // Create some AI agents
         for (int i = 0; i < 100; ++i) {
-            Daisy::Vector3 pos(
+            Daisy::DVector3 pos(
                 (rand() % 20000) - 10000,
                 6371000 + 1000, // Above Earth surface
                 (rand() % 20000) - 10000
             );
             
-            uint32_t agentId = ai->CreateAIAgent("Citizen_" + std::to_string(i), pos);
+            Daisy::AIAgentHandle agentId = ai->CreateAIAgent("Citizen_" + std::to_string(i), origin.ToLocal(pos));
             
             // Set random behaviors
             AIBehaviorType behaviors[] = {
@@ -171,10 +185,6 @@ int main() {
     
     DAISY_INFO("Starting main engine loop...");
     
-    // Simulate a camera moving through space
-    Daisy::Vector3 cameraPos(7000000, 0, 0); // Start in low Earth orbit
-    Daisy::Vector3 cameraVelocity(0, 7800, 0); // Orbital velocity
-    
     // Main game loop - run until window is closed
     int frameCount = 0;
     while (engine->IsRunning()) { 
@@ -186,6 +196,9 @@ int main() {
         // Update camera position (simulate orbital motion)
         cameraPos = cameraPos + cameraVelocity * engine->GetDeltaTime();
         
+        // Rebase float-precision systems once the camera has moved far enough
+        origin.Update(cameraPos);
+        
         // Update observer position for world streaming
         if (worldStreamer) {
             worldStreamer->SetObserverPosition(cameraPos);
@@ -203,14 +216,14 @@ int main() {
         // Update sound listener
         if (sound) {
             Daisy::AudioListener listener = sound->GetListener();
-            listener.position = cameraPos;
+            listener.position = origin.ToLocal(cameraPos);
             listener.velocity = cameraVelocity;
             sound->SetListener(listener);
         }
         
         // Trigger some AI events periodically
         if (ai && frameCount % 100 == 0) {
-            ai->TriggerEvent("economic_update", cameraPos, 1.0f);
+            ai->TriggerEvent("economic_update", origin.ToLocal(cameraPos), 1.0f);
         }
         
         // Execute main engine update
@@ -224,8 +237,8 @@ int main() {
                 frameCount, cameraPos.x, cameraPos.y, cameraPos.z);
         }
         
-        // Simulate frame rate (remove in real application)
-        std::this_thread::sleep_for(std::chrono::milliseconds(16)); // ~60 FPS
+        // Sleep until the next simulation tick is due
+        std::this_thread::sleep_for(engine->GetTimeUntilNextTick());
     }
     
     DAISY_INFO("Shutting down Daisy Engine Example Application");
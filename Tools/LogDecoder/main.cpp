@@ -0,0 +1,71 @@
+#include "Core/BinaryLog.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+
+using namespace Daisy;
+
+// Converts a binary log written by Logger::OpenBinaryLog back into the text
+// format of the regular log file
+namespace {
+    void WriteTimestamp(std::ostream& out, std::chrono::system_clock::time_point time) {
+        auto seconds = std::chrono::time_point_cast<std::chrono::seconds>(time);
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(time - seconds).count();
+        std::time_t time_t = std::chrono::system_clock::to_time_t(seconds);
+        
+        char text[32];
+        std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", std::localtime(&time_t));
+        char millis[8];
+        std::snprintf(millis, sizeof(millis), ".%03d", static_cast<int>(ms));
+        out << text << millis;
+    }
+    
+    void PrintUsage() {
+        std::cerr << "Usage: DaisyLogDecoder <binary log> [output file]\n"
+                  << "       Writes \"[timestamp] [LEVEL] message\" lines to stdout or the output file\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 3 || std::strcmp(argv[1], "--help") == 0) {
+        PrintUsage();
+        return argc == 2 ? 0 : 1;
+    }
+    
+    BinaryLogReader reader;
+    if (!reader.Open(argv[1])) {
+        std::cerr << "DaisyLogDecoder: " << reader.GetError() << "\n";
+        return 1;
+    }
+    
+    std::ofstream file;
+    if (argc == 3) {
+        file.open(argv[2], std::ios::out | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "DaisyLogDecoder: cannot write " << argv[2] << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = argc == 3 ? static_cast<std::ostream&>(file) : std::cout;
+    
+    BinaryLogEntry entry;
+    size_t count = 0;
+    while (reader.Next(entry)) {
+        out << '[';
+        WriteTimestamp(out, entry.time);
+        out << "] [" << Logger::GetLogLevelString(entry.level) << "] ";
+        if (entry.channel != LogChannel::General) {
+            out << '[' << Logger::GetChannelName(entry.channel) << "] ";
+        }
+        out << entry.message << '\n';
+        count++;
+    }
+    
+    if (argc == 3) {
+        std::cerr << "DaisyLogDecoder: " << count << " entries written to " << argv[2] << "\n";
+    }
+    return 0;
+}
\ No newline at end of file